@@ -0,0 +1,118 @@
+#include "GestureTest.h"
+
+#include "cinder/Log.h"
+#include "cinder/Rand.h"
+
+using namespace std;
+using namespace ci;
+
+const float PADDING = 40;
+
+GestureTest::GestureTest()
+{
+	mTapTarget = make_shared<vu::RectView>();
+	mTapTarget->setLabel( "tap target" );
+	mTapTarget->setColor( Color( 0.2f, 0.4f, 0.8f ) );
+
+	mTransformTarget = make_shared<vu::RectView>( Rectf( 0, 0, 200, 200 ) );
+	mTransformTarget->setLabel( "transform target" );
+	mTransformTarget->setColor( Color( 0.8f, 0.4f, 0.2f ) );
+
+	mInfoLabel = make_shared<vu::LabelGrid>();
+	mInfoLabel->setTextColor( Color::white() );
+	mInfoLabel->getBackground()->setColor( ColorA::gray( 0, 0.5f ) );
+
+	addSubview( mTapTarget );
+	addSubview( mTransformTarget );
+	addSubview( mInfoLabel );
+
+	setupTapTarget();
+	setupTransformTarget();
+}
+
+void GestureTest::setupTapTarget()
+{
+	auto doubleTap = make_shared<vu::TapGestureRecognizer>();
+	doubleTap->setNumTapsRequired( 2 );
+	doubleTap->getSignalGesture().connect( [this]( vu::GestureRecognizer *recognizer ) {
+		mLastGesture = "double tap";
+		mTapTarget->setColor( Color( CM_HSV, randFloat(), 0.6f, 0.8f ) );
+	} );
+
+	// single tap waits for the double tap to fail, so it doesn't fire on the first tap of a double tap
+	auto singleTap = make_shared<vu::TapGestureRecognizer>();
+	singleTap->requireToFail( doubleTap );
+	singleTap->getSignalGesture().connect( [this]( vu::GestureRecognizer *recognizer ) {
+		mLastGesture = "single tap";
+		mTapTarget->setColor( Color( 0.2f, 0.4f, 0.8f ) );
+	} );
+
+	auto longPress = make_shared<vu::LongPressGestureRecognizer>();
+	longPress->getSignalGesture().connect( [this]( vu::GestureRecognizer *recognizer ) {
+		mLastGesture = string( "long press " ) + vu::gestureStateToString( recognizer->getState() );
+		mTapTarget->setColor( recognizer->getState() == vu::GestureState::ENDED ? Color( 0.2f, 0.4f, 0.8f ) : Color( 0.9f, 0.9f, 0.2f ) );
+	} );
+
+	mTapTarget->addGestureRecognizer( singleTap );
+	mTapTarget->addGestureRecognizer( doubleTap );
+	mTapTarget->addGestureRecognizer( longPress );
+}
+
+void GestureTest::setupTransformTarget()
+{
+	mPanRecognizer = make_shared<vu::PanGestureRecognizer>();
+	mPanRecognizer->getSignalGesture().connect( [this]( vu::GestureRecognizer *recognizer ) {
+		mLastGesture = string( "pan " ) + vu::gestureStateToString( recognizer->getState() );
+		if( recognizer->getState() == vu::GestureState::BEGAN )
+			mPanStartPos = mTransformTarget->getPos() - mPanRecognizer->getTranslation();
+
+		mTransformTarget->setPos( mPanStartPos + mPanRecognizer->getTranslation() );
+	} );
+
+	// pinch and rotate transform the View around its center, the recognizers' values are relative to when they began
+	mTransformTarget->setTransformOrigin( mTransformTarget->getCenterLocal() );
+
+	mPinchRecognizer = make_shared<vu::PinchGestureRecognizer>();
+	mPinchRecognizer->getSignalGesture().connect( [this]( vu::GestureRecognizer *recognizer ) {
+		mLastGesture = string( "pinch " ) + vu::gestureStateToString( recognizer->getState() );
+		if( recognizer->getState() == vu::GestureState::BEGAN )
+			mPinchStartScale = mTransformTarget->getScale().x / mPinchRecognizer->getScale();
+
+		mTransformTarget->setScale( glm::clamp( mPinchStartScale * mPinchRecognizer->getScale(), 0.25f, 4.0f ) );
+	} );
+
+	mRotationRecognizer = make_shared<vu::RotationGestureRecognizer>();
+	mRotationRecognizer->getSignalGesture().connect( [this]( vu::GestureRecognizer *recognizer ) {
+		mLastGesture = string( "rotate " ) + vu::gestureStateToString( recognizer->getState() );
+		if( recognizer->getState() == vu::GestureState::BEGAN )
+			mRotationStart = mTransformTarget->getRotation() - mRotationRecognizer->getRotation();
+
+		mTransformTarget->setRotation( mRotationStart + mRotationRecognizer->getRotation() );
+	} );
+
+	mTransformTarget->addGestureRecognizer( mPanRecognizer );
+	mTransformTarget->addGestureRecognizer( mPinchRecognizer );
+	mTransformTarget->addGestureRecognizer( mRotationRecognizer );
+}
+
+void GestureTest::layout()
+{
+	mTapTarget->setBounds( Rectf( PADDING, PADDING, PADDING + 200, PADDING + 200 ) );
+	if( mTransformTarget->getPos() == vec2( 0 ) )
+		mTransformTarget->setPos( vec2( PADDING * 2 + 200, PADDING ) );
+
+	mInfoLabel->setBounds( Rectf( getWidth() - 300, getHeight() - 140, getWidth() - PADDING, getHeight() - PADDING ) );
+}
+
+void GestureTest::update()
+{
+	auto graph = getGraph();
+
+	int row = 0;
+	mInfoLabel->setRow( row++, { "last gesture:", mLastGesture } );
+	mInfoLabel->setRow( row++, { "active recognizers:", to_string( graph->getNumActiveGestureRecognizers() ) } );
+	mInfoLabel->setRow( row++, { "pan velocity:", to_string( (int)glm::length( mPanRecognizer->getVelocity() ) ) } );
+	mInfoLabel->setRow( row++, { "pinch scale:", to_string( mPinchRecognizer->getScale() ) } );
+	mInfoLabel->setRow( row++, { "rotation:", to_string( mRotationRecognizer->getRotation() ) } );
+	mInfoLabel->setRow( row++, { "touch samples:", to_string( graph->getTouchHistory().getNumSamples() ) } );
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vu/Suite.h"
+#include "vu/GestureRecognizer.h"
+#include "vu/Label.h"
+
+//! Exercises the GestureRecognizers: taps and long-press on one View, pan, pinch and rotate on another.
+class GestureTest : public vu::SuiteView {
+public:
+	GestureTest();
+
+protected:
+	void layout() override;
+	void update() override;
+
+private:
+	void setupTapTarget();
+	void setupTransformTarget();
+
+	vu::RectViewRef		mTapTarget, mTransformTarget;
+	vu::LabelGridRef	mInfoLabel;
+	std::string			mLastGesture;
+	ci::vec2			mPanStartPos;
+	float				mPinchStartScale = 1;
+	float				mRotationStart = 0;
+
+	vu::PanGestureRecognizerRef			mPanRecognizer;
+	vu::PinchGestureRecognizerRef		mPinchRecognizer;
+	vu::RotationGestureRecognizerRef	mRotationRecognizer;
+};
@@ -17,6 +17,7 @@ const float PADDING = 40.0f;
 
 const size_t NUM_DRAGGABLES = 1000;
 const size_t NUM_TOUCHES = 32;
+const size_t NUM_DRAGGABLE_GROUPS = 4;
 
 //const size_t NUM_DRAGGABLES = 5000;
 //const size_t NUM_TOUCHES = 64;
@@ -127,11 +128,20 @@ void MultiTouchTest::setupDraggables()
 	mDraggablesContainer->setLabel( "draggables container" );
 	mDraggablesContainer->setFillParentEnabled();
 
+	// draggables are split into groups, so that each group can be its own InteractionRegion
+	for( size_t i = 0; i < NUM_DRAGGABLE_GROUPS; i++ ) {
+		auto group = make_shared<vu::View>();
+		group->setLabel( "draggables group " + to_string( i ) );
+		group->setFillParentEnabled();
+		mDraggablesContainer->addSubview( group );
+		mDraggableGroups.push_back( group );
+	}
+
 	for( size_t i = 0; i < NUM_DRAGGABLES; i++ ) {
 		auto draggable = make_shared<DraggableView>();
 		draggable->setLabel( "DraggableView-" + to_string( i ) );
 		draggable->setSize( vec2( 60 ) );
-		mDraggablesContainer->addSubview( draggable );
+		mDraggableGroups[i % NUM_DRAGGABLE_GROUPS]->addSubview( draggable );
 	}
 
 	addSubview( mDraggablesContainer );
@@ -158,9 +168,29 @@ void MultiTouchTest::layoutDraggables()
 	// - should it before resized before View::layout() is called? It is a subview.
 //	auto containerSize = mDraggablesContainer->getSize();
 	auto containerSize = getSize();
-	for( auto &draggable : mDraggablesContainer->getSubviews() ) {
-		draggable->setPos( vec2( randFloat( PADDING, containerSize.x - PADDING ), randFloat( PADDING, containerSize.y - PADDING ) ) );
+	for( auto &group : mDraggableGroups ) {
+		for( auto &draggable : group->getSubviews() ) {
+			draggable->setPos( vec2( randFloat( PADDING, containerSize.x - PADDING ), randFloat( PADDING, containerSize.y - PADDING ) ) );
+		}
+	}
+}
+
+void MultiTouchTest::toggleDraggableRegions()
+{
+	auto graph = getGraph();
+	if( mDraggableRegions.empty() ) {
+		for( const auto &group : mDraggableGroups ) {
+			mDraggableRegions.push_back( graph->addInteractionRegion( group ) );
+		}
+	}
+	else {
+		for( const auto &region : mDraggableRegions ) {
+			graph->removeInteractionRegion( region );
+		}
+		mDraggableRegions.clear();
 	}
+
+	CI_LOG_I( "draggable interaction regions: " << mDraggableRegions.size() );
 }
 
 void MultiTouchTest::layout()
@@ -186,6 +216,46 @@ bool MultiTouchTest::keyDown( app::KeyEvent &event )
 			CI_LOG_I( "num touches in window: " << allTouches.size() );
 		}
 		break;
+		case 'q': {
+			auto graph = getGraph();
+			graph->setTouchCoalescingEnabled( ! graph->isTouchCoalescingEnabled() );
+			CI_LOG_I( "touch coalescing enabled: " << graph->isTouchCoalescingEnabled() );
+		}
+		break;
+		case 'g':
+			toggleDraggableRegions();
+		break;
+		case 'm': {
+			auto graph = getGraph();
+			graph->setParallelTouchDispatchEnabled( ! graph->isParallelTouchDispatchEnabled() );
+			CI_LOG_I( "parallel touch dispatch enabled: " << graph->isParallelTouchDispatchEnabled() );
+		}
+		break;
+		case 'l': {
+			for( size_t i = 0; i < mDraggableRegions.size(); i++ ) {
+				const auto &region = mDraggableRegions[i];
+				CI_LOG_I( "region " << i << ", touches: " << region->getTouchIds().size() << ", last moved: " << region->getLastMovedMillis() << "ms" );
+			}
+		}
+		break;
+		case 'r':
+			if( mInputRecorder.isRecording() ) {
+				mInputRecorder.stop();
+				CI_LOG_I( "stopped recording, num events: " << mInputRecorder.getRecording()->getEvents().size() << ", duration: " << mInputRecorder.getRecording()->getDuration() );
+			}
+			else {
+				// keyboard isn't recorded so that replaying doesn't toggle recording
+				mInputRecorder.start( getGraph()->getWindow(), true, true, false );
+				CI_LOG_I( "recording input.." );
+			}
+		break;
+		case 'p':
+			// replay outside of the Graph's event handling
+			app::App::get()->dispatchAsync( [this] { replayRecording(); } );
+		break;
+		case 'w':
+			testRecordingRoundTrip();
+		break;
 		case '1':
 			mControlsContainer->setHidden( false );
 			mDraggablesContainer->setHidden( true );
@@ -215,6 +285,71 @@ bool MultiTouchTest::keyDown( app::KeyEvent &event )
 	return handled;
 }
 
+void MultiTouchTest::replayRecording()
+{
+	if( mInputRecorder.isRecording() || mInputRecorder.getRecording()->getEvents().empty() ) {
+		CI_LOG_W( "no recording to replay, press 'r' to start and stop recording" );
+		return;
+	}
+
+	vu::InputReplayer replayer( getGraph(), mInputRecorder.getRecording() );
+	replayer.run();
+
+	auto mean = replayer.calcMeanFrameStats();
+	auto max = replayer.calcMaxFrameStats();
+	CI_LOG_I( "replayed " << replayer.getFrameStats().size() << " frames (" << mInputRecorder.getRecording()->getDuration() << " seconds)"
+		<< ", mean events: " << mean.mEventMillis << "ms, update: " << mean.mUpdateMillis << "ms"
+		<< ", max events: " << max.mEventMillis << "ms, update: " << max.mUpdateMillis << "ms" );
+}
+
+// Writes a recording to a temporary file and checks that reading it back gives the same events, then that a truncated copy is rejected.
+void MultiTouchTest::testRecordingRoundTrip()
+{
+	vu::InputRecording recording;
+	vector<app::TouchEvent::Touch> touches;
+	for( uint32_t id = 1; id <= 3; id++ ) {
+		touches.emplace_back( vec2( id * 10, id * 20 ), vec2( id * 10 - 1, id * 20 - 1 ), id, 0, nullptr );
+	}
+	recording.addTouches( vu::InputRecording::EventType::TOUCHES_BEGAN, 0.5, touches );
+	recording.addTouches( vu::InputRecording::EventType::TOUCHES_MOVED, 0.75, touches );
+	recording.addKey( vu::InputRecording::EventType::KEY_DOWN, 1.0, app::KeyEvent( getGraph()->getWindow(), app::KeyEvent::KEY_a, 'a', 'a', app::KeyEvent::SHIFT_DOWN, 0 ) );
+	recording.addTouches( vu::InputRecording::EventType::TOUCHES_ENDED, 1.25, touches );
+
+	const fs::path filePath = fs::temp_directory_path() / "vu_input_recording_test.bin";
+	recording.write( filePath );
+	auto result = vu::InputRecording::read( filePath );
+
+	bool equal = result->getEvents().size() == recording.getEvents().size() && result->getTouches().size() == recording.getTouches().size();
+	for( size_t i = 0; equal && i < recording.getEvents().size(); i++ ) {
+		const auto &a = recording.getEvents()[i];
+		const auto &b = result->getEvents()[i];
+		equal = a.mType == b.mType && a.mTime == b.mTime && a.mFirstTouch == b.mFirstTouch && a.mNumTouches == b.mNumTouches
+				&& a.mKeyCode == b.mKeyCode && a.mKeyCharUtf32 == b.mKeyCharUtf32 && a.mKeyChar == b.mKeyChar && a.mKeyModifiers == b.mKeyModifiers;
+	}
+	for( size_t i = 0; equal && i < recording.getTouches().size(); i++ ) {
+		const auto &a = recording.getTouches()[i];
+		const auto &b = result->getTouches()[i];
+		equal = a.mId == b.mId && a.mPos == b.mPos && a.mPrevPos == b.mPrevPos;
+	}
+
+	bool truncatedRejected = false;
+	fs::resize_file( filePath, fs::file_size( filePath ) / 2 );
+	try {
+		vu::InputRecording::read( filePath );
+	}
+	catch( vu::InputRecordingExc &exc ) {
+		truncatedRejected = true;
+		CI_LOG_I( "truncated recording rejected: " << exc.what() );
+	}
+
+	fs::remove( filePath );
+
+	if( equal && truncatedRejected )
+		CI_LOG_I( "recording round trip passed, events: " << result->getEvents().size() << ", touches: " << result->getTouches().size() );
+	else
+		CI_LOG_E( "recording round trip failed, read back equal: " << equal << ", truncated file rejected: " << truncatedRejected );
+}
+
 void MultiTouchTest::injectTouches()
 {
 	vec2 pos1 = mVSlider1->getCenter();
@@ -3,6 +3,7 @@
 #include "cinder/Tween.h"
 
 #include "vu/Suite.h"
+#include "vu/InputRecorder.h"
 
 #include "cinder/gl/gl.h"
 
@@ -24,13 +25,20 @@ class MultiTouchTest : public vu::SuiteView {
 	void injectTouches();
 	void injectContinuousTouches();
 	void endContinuousTouches();
+	void replayRecording();
+	void testRecordingRoundTrip();
+	void toggleDraggableRegions();
 
 	vu::VSliderRef			mVSlider1, mVSlider2;
 	vu::ButtonRef			mButton, mToggle;
 	vu::ViewRef             mControlsContainer, mDraggablesContainer;
+	std::vector<vu::ViewRef>				mDraggableGroups;	// each can be made into an InteractionRegion
+	std::vector<vu::InteractionRegionRef>	mDraggableRegions;
 
 	bool mEnableContinuousInjection = false;
 
+	vu::InputRecorder		mInputRecorder;
+
 	struct TestTouch {
 		enum class Phase { UNUSED, BEGAN, MOVED, ENDED };
 
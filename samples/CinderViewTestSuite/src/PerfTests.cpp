@@ -0,0 +1,407 @@
+#include "PerfTests.h"
+
+#include "cinder/gl/Texture.h"
+#include "cinder/Log.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+#include "vu/Graph.h"
+#include "vu/WorkerPool.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace ci;
+
+// Counts heap allocations made on the calling thread while an AllocationCounter is in scope, used to verify that layouts don't allocate.
+// operator new can only be replaced for the whole app, but it behaves like the default one unless the allocating thread is counting.
+namespace {
+
+thread_local size_t *sAllocationCount = nullptr;
+
+class AllocationCounter {
+  public:
+	AllocationCounter()
+		: mPrevCount( sAllocationCount )
+	{
+		sAllocationCount = &mCount;
+	}
+
+	~AllocationCounter()
+	{
+		sAllocationCount = mPrevCount;
+	}
+
+	size_t getCount() const	{ return mCount; }
+
+  private:
+	size_t	mCount = 0;
+	size_t*	mPrevCount;
+};
+
+} // anonymous namespace
+
+void* operator new( size_t size )
+{
+	if( sAllocationCount )
+		( *sAllocationCount )++;
+
+	if( void *ptr = malloc( size ) )
+		return ptr;
+
+	throw bad_alloc();
+}
+
+void operator delete( void *ptr ) noexcept
+{
+	free( ptr );
+}
+
+const float PADDING = 20;
+const size_t NUM_FLEX_VIEWS = 10000;
+const size_t NUM_BENCHMARK_ITERATIONS = 20;
+const size_t NUM_LAYOUT_VIEWS = 1000;
+const size_t NUM_TOOLBAR_ICONS = 300;
+const size_t NUM_IDLE_BUTTONS = 2000;
+const size_t NUM_UPDATE_TILES = 32;
+const size_t NUM_TILE_PARTICLES = 2000;
+const int ICON_SIZE = 24;
+
+namespace {
+
+// Stands in for a View with heavy per-frame work in update() that only affects itself, ex. a simulation.
+class SimulationTileView : public vu::View {
+  public:
+	SimulationTileView( const Rectf &bounds, uint32_t seed )
+		: View( bounds )
+	{
+		Rand rand( seed );
+		mPositions.resize( NUM_TILE_PARTICLES );
+		mVelocities.resize( NUM_TILE_PARTICLES );
+		for( size_t i = 0; i < NUM_TILE_PARTICLES; i++ ) {
+			mPositions[i] = vec2( rand.nextFloat( getWidth() ), rand.nextFloat( getHeight() ) );
+			mVelocities[i] = rand.nextVec2() * rand.nextFloat( 0.5f, 2 );
+		}
+	}
+
+  protected:
+	void update() override
+	{
+		const vec2 size = getSize();
+		for( size_t i = 0; i < NUM_TILE_PARTICLES; i++ ) {
+			// pull towards the center and bounce off of the edges
+			vec2 &pos = mPositions[i];
+			vec2 &vel = mVelocities[i];
+			vel += ( size * 0.5f - pos ) * 0.001f;
+			vel *= 0.999f;
+			pos += vel;
+
+			for( int axis = 0; axis < 2; axis++ ) {
+				if( pos[axis] < 0 || pos[axis] > size[axis] ) {
+					pos[axis] = glm::clamp( pos[axis], 0.0f, size[axis] );
+					vel[axis] = - vel[axis];
+				}
+			}
+		}
+	}
+
+  private:
+	vector<vec2>	mPositions;
+	vector<vec2>	mVelocities;
+};
+
+} // anonymous namespace
+
+PerfTests::PerfTests()
+{
+	mFlexLayout = make_shared<vu::FlexLayout>( vu::FlexLayout::Direction::ROW );
+	mFlexLayout->setWrapEnabled();
+	mFlexLayout->setPadding( 2 );
+	mFlexLayout->setMargin( 4 );
+
+	mFlexScrollView = make_shared<vu::ScrollView>();
+	mFlexScrollView->setLabel( "flex scrollview" );
+	mFlexScrollView->getBackground()->setColor( Color( 0.15f, 0.15f, 0.2f ) );
+	mFlexScrollView->getContentView()->setLayout( mFlexLayout );
+
+	Rand rand( 1 );
+	vector<vu::ViewRef> views;
+	views.reserve( NUM_FLEX_VIEWS );
+	for( size_t i = 0; i < NUM_FLEX_VIEWS; i++ ) {
+		auto view = make_shared<vu::RectView>( Rectf( 0, 0, rand.nextFloat( 10, 40 ), 16 ) );
+		view->setColor( Color( CM_HSV, rand.nextFloat( 0.5f, 0.7f ), 0.8f, 0.8f ) );
+
+		vu::FlexItem flex;
+		flex.mGrow = rand.nextFloat() < 0.2f ? 1.0f : 0.0f;
+		view->setFlexItem( flex );
+		views.push_back( view );
+	}
+
+	mFlexScrollView->addContentViews( views );
+
+	// Views for the allocation benchmark, these aren't added to the hierarchy since only their Layouts are exercised.
+	mLinearLayoutView = make_shared<vu::View>( Rectf( 0, 0, 400, 400 ) );
+	mLinearLayoutView->setLayout( make_shared<vu::VerticalLayout>( vu::LinearLayout::Mode::FILL, vu::Alignment::FILL ) );
+	mGridLayoutView = make_shared<vu::View>( Rectf( 0, 0, 400, 400 ) );
+	mGridLayoutView->setLayout( make_shared<vu::GridLayout>() );
+	for( size_t i = 0; i < NUM_LAYOUT_VIEWS; i++ ) {
+		mLinearLayoutView->addSubview( make_shared<vu::View>( Rectf( 0, 0, 20, 20 ) ) );
+		mGridLayoutView->addSubview( make_shared<vu::View>( Rectf( 0, 0, 20, 20 ) ) );
+	}
+
+	// Toolbar of icon Buttons, drawn either from an ImageAtlas or from separate textures.
+	mIconAtlas = make_shared<vu::ImageAtlas>( ivec2( 512 ) );
+	mToolbarView = make_shared<vu::View>();
+	mToolbarView->setLabel( "toolbar" );
+	mToolbarView->setLayout( make_shared<vu::GridLayout>() );
+	for( size_t i = 0; i < NUM_TOOLBAR_ICONS; i++ ) {
+		Surface8u icon( ICON_SIZE, ICON_SIZE, true );
+		ColorA8u color = ColorA( CM_HSV, rand.nextFloat(), 0.7f, 0.9f, 1 );
+		ColorA8u border = ColorA::gray( 0.1f );
+		for( int y = 0; y < ICON_SIZE; y++ ) {
+			for( int x = 0; x < ICON_SIZE; x++ ) {
+				bool isBorder = x < 2 || y < 2 || x >= ICON_SIZE - 2 || y >= ICON_SIZE - 2;
+				icon.setPixel( ivec2( x, y ), isBorder ? border : color );
+			}
+		}
+
+		mIconsAtlas.push_back( mIconAtlas->add( icon ) );
+		mIconsSeparate.push_back( make_shared<vu::Image>( gl::Texture2d::create( icon ) ) );
+
+		auto button = make_shared<vu::Button>( Rectf( 0, 0, ICON_SIZE, ICON_SIZE ) );
+		mToolbarButtons.push_back( button );
+		mToolbarView->addSubview( button );
+	}
+
+	setToolbarAtlasEnabled( true );
+
+	mInfoLabel = make_shared<vu::LabelGrid>();
+	mInfoLabel->setTextColor( Color::white() );
+	mInfoLabel->getBackground()->setColor( ColorA::gray( 0, 0.3f ) );
+
+	addSubview( mFlexScrollView );
+	addSubview( mInfoLabel );
+	addSubview( mToolbarView );
+}
+
+void PerfTests::setToolbarAtlasEnabled( bool enable )
+{
+	mToolbarAtlasEnabled = enable;
+
+	const auto &icons = mToolbarAtlasEnabled ? mIconsAtlas : mIconsSeparate;
+	for( size_t i = 0; i < mToolbarButtons.size(); i++ ) {
+		mToolbarButtons[i]->setImage( icons[i] );
+	}
+}
+
+void PerfTests::layout()
+{
+	mFlexScrollView->setBounds( Rectf( PADDING, PADDING, getWidth() * 0.7f, getHeight() - PADDING ) );
+	mInfoLabel->setBounds( Rectf( mFlexScrollView->getBounds().x2 + PADDING, PADDING, getWidth() - PADDING, PADDING + 380 ) );
+	mToolbarView->setBounds( Rectf( mInfoLabel->getBounds().x1, mInfoLabel->getBounds().y2 + PADDING, mInfoLabel->getBounds().x2, getHeight() - PADDING ) );
+}
+
+void PerfTests::update()
+{
+	int row = 0;
+	mInfoLabel->setRow( row++, { "flex views:", to_string( NUM_FLEX_VIEWS ) } );
+	mInfoLabel->setRow( row++, { "flex layout (ms):", fmt::format( "{:.3f}", mFlexLayoutMillis ) } );
+	mInfoLabel->setRow( row++, { "uncached (ms):", fmt::format( "{:.3f}", mFlexLayoutUncachedMillis ) } );
+	mInfoLabel->setRow( row++, { "LinearLayout allocs:", to_string( mLinearLayoutAllocations ) } );
+	mInfoLabel->setRow( row++, { "GridLayout allocs:", to_string( mGridLayoutAllocations ) } );
+	mInfoLabel->setRow( row++, { "wrap:", mFlexLayout->isWrapEnabled() ? "true" : "false" } );
+	mInfoLabel->setRow( row++, { "justify:", to_string( (int)mFlexLayout->getJustify() ) } );
+	mInfoLabel->setRow( row++, { "icon atlas:", mToolbarAtlasEnabled ? "true" : "false" } );
+	mInfoLabel->setRow( row++, { "toolbar rasterized:", mToolbarView->getShouldRasterize() ? "true" : "false" } );
+	mInfoLabel->setRow( row++, { "image batches:", to_string( getGraph()->getRenderer()->getNumImageBatchesDrawn() ) } );
+	mInfoLabel->setRow( row++, { "batched images:", to_string( getGraph()->getRenderer()->getNumBatchedImagesDrawn() ) } );
+	mInfoLabel->setRow( row++, { "idle buttons (ms):", fmt::format( "{:.3f}", mIdleButtonsMillis ) } );
+	mInfoLabel->setRow( row++, { "idle buttons allocs:", to_string( mIdleButtonsAllocations ) } );
+	mInfoLabel->setRow( row++, { "serial update (ms):", fmt::format( "{:.3f}", mSerialUpdateMillis ) } );
+	// one timing per number of threads, starting at one
+	string parallelMillis;
+	for( double millis : mParallelUpdateMillis ) {
+		parallelMillis += ( parallelMillis.empty() ? "" : ", " ) + fmt::format( "{:.2f}", millis );
+	}
+	mInfoLabel->setRow( row++, { "parallel update (ms):", parallelMillis.empty() ? "-" : parallelMillis } );
+
+	auto fastest = min_element( mParallelUpdateMillis.begin(), mParallelUpdateMillis.end() );
+	if( fastest != mParallelUpdateMillis.end() && *fastest > 0 )
+		mInfoLabel->setRow( row++, { "update speedup:", fmt::format( "{:.2f}x, {} threads", mSerialUpdateMillis / *fastest, fastest - mParallelUpdateMillis.begin() + 1 ) } );
+	else
+		mInfoLabel->setRow( row++, { "update speedup:", "-" } );
+	mInfoLabel->setRow( row++, { "views drawn:", to_string( getGraph()->getDrawStats().mNumViewsDrawn ) } );
+	mInfoLabel->setRow( row++, { "views culled:", to_string( getGraph()->getDrawStats().mNumViewsCulled ) } );
+}
+
+// Times FlexLayout::layout() on the ScrollView's content, both with the per-View intrinsic size cache and with it invalidated.
+void PerfTests::runFlexLayoutBenchmark()
+{
+	auto contentView = mFlexScrollView->getContentView();
+
+	Timer timer( true );
+	for( size_t i = 0; i < NUM_BENCHMARK_ITERATIONS; i++ ) {
+		mFlexLayout->layout( contentView );
+	}
+	mFlexLayoutMillis = timer.getSeconds() * 1000.0 / NUM_BENCHMARK_ITERATIONS;
+
+	timer.start();
+	for( size_t i = 0; i < NUM_BENCHMARK_ITERATIONS; i++ ) {
+		for( const auto &view : contentView->getSubviews() ) {
+			view->invalidateIntrinsicSize();
+		}
+		mFlexLayout->layout( contentView );
+	}
+	mFlexLayoutUncachedMillis = timer.getSeconds() * 1000.0 / NUM_BENCHMARK_ITERATIONS;
+
+	CI_LOG_I( "FlexLayout with " << NUM_FLEX_VIEWS << " views: " << mFlexLayoutMillis << "ms, uncached: " << mFlexLayoutUncachedMillis << "ms" );
+}
+
+// Counts heap allocations made by LinearLayout and GridLayout, after an initial layout has sized their scratch buffers.
+void PerfTests::runLayoutAllocationBenchmark()
+{
+	auto countAllocations = []( const vu::ViewRef &view ) {
+		view->getLayout()->layout( view.get() );
+
+		AllocationCounter counter;
+		for( size_t i = 0; i < NUM_BENCHMARK_ITERATIONS; i++ ) {
+			view->getLayout()->layout( view.get() );
+		}
+
+		return counter.getCount() / NUM_BENCHMARK_ITERATIONS;
+	};
+
+	mLinearLayoutAllocations = countAllocations( mLinearLayoutView );
+	mGridLayoutAllocations = countAllocations( mGridLayoutView );
+
+	CI_LOG_I( "allocations per layout() with " << NUM_LAYOUT_VIEWS << " subviews, LinearLayout: " << mLinearLayoutAllocations << ", GridLayout: " << mGridLayoutAllocations );
+}
+
+// Measures the per-frame update cost and allocations of Buttons that aren't being interacted with, relative to a frame without them.
+// Only allocations on the main thread are counted, which is where the Buttons are updated.
+void PerfTests::runIdleButtonBenchmark()
+{
+	auto graph = getGraph();
+	auto timeUpdates = [graph]( double *millis, size_t *allocations ) {
+		AllocationCounter counter;
+		Timer timer( true );
+		for( size_t i = 0; i < NUM_BENCHMARK_ITERATIONS; i++ ) {
+			graph->propagateUpdate();
+		}
+		*millis = timer.getSeconds() * 1000.0 / NUM_BENCHMARK_ITERATIONS;
+		*allocations = counter.getCount() / NUM_BENCHMARK_ITERATIONS;
+	};
+
+	double baselineMillis, buttonsMillis;
+	size_t baselineAllocations, buttonsAllocations;
+	timeUpdates( &baselineMillis, &baselineAllocations );
+
+	// hidden so they are updated but never drawn
+	auto container = make_shared<vu::View>( Rectf( 0, 0, 400, 400 ) );
+	container->setHidden();
+	for( size_t i = 0; i < NUM_IDLE_BUTTONS; i++ ) {
+		auto button = make_shared<vu::Button>( Rectf( 0, 0, 60, 20 ) );
+		button->setTitle( "button" );
+		container->addSubview( button );
+	}
+
+	addSubview( container );
+	graph->propagateUpdate(); // initial layout and text measurement
+	timeUpdates( &buttonsMillis, &buttonsAllocations );
+	container->removeFromParent();
+
+	mIdleButtonsMillis = std::max( 0.0, buttonsMillis - baselineMillis );
+	mIdleButtonsAllocations = buttonsAllocations > baselineAllocations ? buttonsAllocations - baselineAllocations : 0;
+
+	CI_LOG_I( NUM_IDLE_BUTTONS << " idle buttons, update: " << mIdleButtonsMillis << "ms, allocations per frame: " << mIdleButtonsAllocations );
+}
+
+// Measures how updating independent subtrees scales with the WorkerPool, relative to updating them serially.
+void PerfTests::runParallelUpdateBenchmark()
+{
+	auto graph = getGraph();
+	auto timeUpdates = [graph] {
+		Timer timer( true );
+		for( size_t i = 0; i < NUM_BENCHMARK_ITERATIONS; i++ ) {
+			graph->propagateUpdate();
+		}
+		return timer.getSeconds() * 1000.0 / NUM_BENCHMARK_ITERATIONS;
+	};
+
+	const bool parallelUpdateWasEnabled = graph->isParallelUpdateEnabled();
+	graph->setParallelUpdateEnabled( false );
+	double baselineMillis = timeUpdates();
+
+	// hidden so they are updated but never drawn
+	auto container = make_shared<vu::View>( Rectf( 0, 0, 400, 400 ) );
+	container->setHidden();
+	for( size_t i = 0; i < NUM_UPDATE_TILES; i++ ) {
+		auto tile = make_shared<SimulationTileView>( Rectf( 0, 0, 100, 100 ), (uint32_t)i );
+		tile->setIndependentUpdateEnabled();
+		container->addSubview( tile );
+	}
+
+	addSubview( container );
+	graph->propagateUpdate(); // initial layout
+
+	mSerialUpdateMillis = std::max( 0.0, timeUpdates() - baselineMillis );
+
+	CI_LOG_I( NUM_UPDATE_TILES << " independent tiles, serial update: " << mSerialUpdateMillis << "ms" );
+
+	// time the parallel update with each number of threads up to all of the WorkerPool's, to see how it scales
+	const size_t maxThreadsBefore = graph->getMaxParallelUpdateThreads();
+	const size_t numThreads = graph->getWorkerPool()->getNumThreads() + 1; // the main thread also updates subtrees
+	graph->setParallelUpdateEnabled( true );
+	mParallelUpdateMillis.clear();
+	for( size_t threads = 1; threads <= numThreads; threads++ ) {
+		graph->setMaxParallelUpdateThreads( threads );
+		double millis = std::max( 0.0, timeUpdates() - baselineMillis );
+		mParallelUpdateMillis.push_back( millis );
+
+		CI_LOG_I( "\tparallel update with " << threads << " threads: " << millis << "ms, speedup: " << ( millis > 0 ? mSerialUpdateMillis / millis : 0 ) << "x" );
+	}
+
+	graph->setMaxParallelUpdateThreads( maxThreadsBefore );
+	graph->setParallelUpdateEnabled( parallelUpdateWasEnabled );
+	container->removeFromParent();
+}
+
+bool PerfTests::keyDown( ci::app::KeyEvent &event )
+{
+	bool handled = true;
+	if( event.getCode() == app::KeyEvent::KEY_b ) {
+		runFlexLayoutBenchmark();
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_a ) {
+		runLayoutAllocationBenchmark();
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_u ) {
+		runIdleButtonBenchmark();
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_p ) {
+		runParallelUpdateBenchmark();
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_i ) {
+		setToolbarAtlasEnabled( ! mToolbarAtlasEnabled );
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_r ) {
+		mToolbarView->setShouldRasterize( ! mToolbarView->getShouldRasterize() );
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_w ) {
+		mFlexLayout->setWrapEnabled( ! mFlexLayout->isWrapEnabled() );
+		mFlexScrollView->setNeedsLayout(); // recalculate content size
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_j ) {
+		auto justify = vu::FlexLayout::Justify( ( (int)mFlexLayout->getJustify() + 1 ) % ( (int)vu::FlexLayout::Justify::SPACE_EVENLY + 1 ) );
+		mFlexLayout->setJustify( justify );
+	}
+	else {
+		handled = false;
+	}
+
+	return handled;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "vu/Suite.h"
+#include "vu/Control.h"
+#include "vu/ImageAtlas.h"
+#include "vu/Label.h"
+#include "vu/Layout.h"
+#include "vu/ScrollView.h"
+
+//! Benchmarks for operations that need to scale to large numbers of Views.
+class PerfTests : public vu::SuiteView {
+public:
+	PerfTests();
+
+protected:
+	void layout() override;
+	void update() override;
+	bool keyDown( ci::app::KeyEvent &event ) override;
+
+private:
+	void runFlexLayoutBenchmark();
+	void runLayoutAllocationBenchmark();
+	void runIdleButtonBenchmark();
+	void runParallelUpdateBenchmark();
+	void setToolbarAtlasEnabled( bool enable );
+
+	vu::ScrollViewRef	mFlexScrollView;
+	vu::FlexLayoutRef	mFlexLayout;
+	vu::LabelGridRef	mInfoLabel;
+
+	double				mFlexLayoutMillis = 0;
+	double				mFlexLayoutUncachedMillis = 0;
+
+	vu::ViewRef			mLinearLayoutView, mGridLayoutView;
+	size_t				mLinearLayoutAllocations = 0;
+	size_t				mGridLayoutAllocations = 0;
+
+	vu::ViewRef					mToolbarView;
+	std::vector<vu::ButtonRef>	mToolbarButtons;
+	vu::ImageAtlasRef			mIconAtlas;
+	std::vector<vu::ImageRef>	mIconsAtlas, mIconsSeparate;
+	bool						mToolbarAtlasEnabled = true;
+
+	double				mIdleButtonsMillis = 0;
+	size_t				mIdleButtonsAllocations = 0;
+
+	double				mSerialUpdateMillis = 0;
+	std::vector<double>	mParallelUpdateMillis; // indexed by the number of threads minus one
+};
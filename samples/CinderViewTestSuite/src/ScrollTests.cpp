@@ -81,6 +81,8 @@ ScrollTests::ScrollTests()
 //	mScrollView->setClipEnabled( false );
 	mScrollViewFree->setLabel( "ScrollView (free)" );
 	mScrollViewFree->getContentView()->getBackground()->setColor( SCROLL_BACKGROUND_COLOR );
+	mScrollViewFree->setZoomEnabled();
+	mScrollViewFree->setZoomRange( 0.5f, 4 );
 
 	{
 		auto scrollBorder = make_shared<vu::StrokedRectView>();
@@ -269,6 +271,12 @@ bool ScrollTests::keyDown( app::KeyEvent &event )
 			mScrollViewFree->setVerticalScrollingEnabled( ! mScrollViewFree->isVerticalScrollingEnabled() );
 			break;
 		}
+		case app::KeyEvent::KEY_z: {
+			// zoom in around the center, or reset if shift is down
+			float zoom = event.isShiftDown() ? 1 : mScrollViewFree->getZoom() * 1.5f;
+			mScrollViewFree->setZoom( zoom );
+			break;
+		}
 		case app::KeyEvent::KEY_DOWN: {
 			if( event.isShiftDown() ) {
 				mVerticalPager->nextPage( animate );
@@ -321,6 +329,7 @@ void ScrollTests::update()
 	mInfoLabel->setRow( row++, { "scroll velocity:",  fmt::format( "{:.2f}", mScrollViewFree->getScrollVelocity() ) } );
 	mInfoLabel->setRow( row++, { "content offset:",  fmt::format( "{:.2f}", mScrollViewFree->getContentOffset() ) } );
 	mInfoLabel->setRow( row++, { "target offset:",  fmt::format( "{:.2f}", mScrollViewFree->getTargetOffset() ) } );
+	mInfoLabel->setRow( row++, { "zoom:",  fmt::format( "{:.2f}{}", mScrollViewFree->getZoom(), mScrollViewFree->isZooming() ? " (zooming)" : "" ) } );
 
 	//  resize info label
 	{
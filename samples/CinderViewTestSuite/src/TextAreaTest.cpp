@@ -0,0 +1,91 @@
+#include "TextAreaTest.h"
+
+#include "cinder/Log.h"
+#include "cinder/Rand.h"
+
+using namespace std;
+using namespace ci;
+
+const float PADDING = 20;
+const size_t NUM_PARAGRAPHS = 5000;
+
+TextAreaTest::TextAreaTest()
+{
+	mTextArea = make_shared<vu::TextArea>();
+	mTextArea->setLabel( "text area" );
+	mTextArea->setFitHeightEnabled();
+
+	mScrollView = make_shared<vu::ScrollView>();
+	mScrollView->setLabel( "text area scrollview" );
+	mScrollView->getBackground()->setColor( Color( 0.1f, 0.1f, 0.1f ) );
+	mScrollView->setHorizontalScrollingEnabled( false );
+	mScrollView->addContentView( mTextArea );
+
+	mInfoLabel = make_shared<vu::LabelGrid>();
+	mInfoLabel->setTextColor( Color::white() );
+	mInfoLabel->getBackground()->setColor( ColorA::gray( 0, 0.5f ) );
+
+	addSubview( mScrollView );
+	addSubview( mInfoLabel );
+
+	loadDocument( NUM_PARAGRAPHS );
+}
+
+void TextAreaTest::loadDocument( size_t numParagraphs )
+{
+	const vector<string> words = { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do", "eiusmod", "tempor", "incididunt" };
+
+	Rand rand( 1 );
+	string text;
+	for( size_t i = 0; i < numParagraphs; i++ ) {
+		text += to_string( i ) + ":";
+		int numWords = rand.nextInt( 3, 40 );
+		for( int w = 0; w < numWords; w++ )
+			text += " " + words[rand.nextUint( (uint32_t)words.size() )];
+
+		if( i + 1 < numParagraphs )
+			text += "\n";
+	}
+
+	mTextArea->setText( text );
+}
+
+void TextAreaTest::layout()
+{
+	mScrollView->setBounds( Rectf( PADDING, PADDING, getWidth() - PADDING, getHeight() - PADDING ) );
+	mTextArea->setSize( vec2( mScrollView->getWidth(), mTextArea->getHeight() ) );
+	mInfoLabel->setBounds( Rectf( getWidth() - 300, getHeight() - 140, getWidth() - PADDING * 2, getHeight() - PADDING * 2 ) );
+}
+
+void TextAreaTest::update()
+{
+	// the TextArea grows as text is added, so the ScrollView's content size needs updating
+	if( mTextAreaHeight != mTextArea->getHeight() ) {
+		mTextAreaHeight = mTextArea->getHeight();
+		mScrollView->setNeedsLayout();
+	}
+
+	int row = 0;
+	mInfoLabel->setRow( row++, { "paragraphs:", to_string( mTextArea->getNumParagraphs() ) } );
+	mInfoLabel->setRow( row++, { "lines:", to_string( mTextArea->getNumLines() ) } );
+	mInfoLabel->setRow( row++, { "lines drawn:", to_string( mTextArea->getNumLinesDrawn() ) } );
+	mInfoLabel->setRow( row++, { "paragraphs wrapped:", to_string( mTextArea->getNumParagraphsWrapped() ) } );
+	mInfoLabel->setRow( row++, { "cursor pos:", to_string( mTextArea->getCursorPos() ) } );
+}
+
+bool TextAreaTest::keyDown( ci::app::KeyEvent &event )
+{
+	// keys only reach here when the TextArea isn't first responder
+	bool handled = true;
+	if( event.getChar() == 'e' ) {
+		mTextArea->becomeFirstResponder();
+	}
+	else if( event.getChar() == 'r' ) {
+		loadDocument( NUM_PARAGRAPHS );
+	}
+	else {
+		handled = false;
+	}
+
+	return handled;
+}
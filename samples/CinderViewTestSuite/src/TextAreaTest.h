@@ -0,0 +1,25 @@
+#pragma once
+
+#include "vu/Suite.h"
+#include "vu/Label.h"
+#include "vu/ScrollView.h"
+#include "vu/TextArea.h"
+
+//! Edits a document with thousands of paragraphs in a TextArea inside of a ScrollView.
+class TextAreaTest : public vu::SuiteView {
+public:
+	TextAreaTest();
+
+protected:
+	void layout() override;
+	void update() override;
+	bool keyDown( ci::app::KeyEvent &event ) override;
+
+private:
+	void loadDocument( size_t numParagraphs );
+
+	vu::ScrollViewRef	mScrollView;
+	vu::TextAreaRef		mTextArea;
+	vu::LabelGridRef	mInfoLabel;
+	float				mTextAreaHeight = 0;
+};
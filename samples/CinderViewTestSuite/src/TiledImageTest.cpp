@@ -0,0 +1,104 @@
+#include "TiledImageTest.h"
+
+#include "cinder/Log.h"
+
+#include "fmt/format.h"
+
+using namespace std;
+using namespace ci;
+
+const float PADDING = 20;
+const ivec2 IMAGE_SIZE = ivec2( 65536, 32768 );
+const ivec2 TILE_SIZE = ivec2( 256 );
+
+namespace {
+
+//! Generates tiles on the fly, tinted by level with a grid so that tile boundaries and level changes are visible.
+class ProceduralTiledSource : public vu::TiledImageSource {
+public:
+	ProceduralTiledSource()
+		: TiledImageSource( IMAGE_SIZE, TILE_SIZE )
+	{}
+
+	Surface8u loadTile( int level, const ivec2 &tile ) override
+	{
+		const ivec2 levelSize = getLevelSize( level );
+		const ivec2 origin = tile * getTileSize();
+		const ivec2 size = glm::min( getTileSize(), levelSize - origin );
+
+		Surface8u result( size.x, size.y, false );
+		const Color8u tint = Color( CM_HSV, fmod( level * 0.13f, 1.0f ), 0.5f, 1 );
+		for( int y = 0; y < size.y; y++ ) {
+			for( int x = 0; x < size.x; x++ ) {
+				const vec2 uv = vec2( origin + ivec2( x, y ) ) / vec2( levelSize );
+				const bool edge = x == 0 || y == 0;
+				const uint8_t v = edge ? 40 : uint8_t( 128 + 127 * sin( uv.x * 200 ) * cos( uv.y * 100 ) );
+				result.setPixel( ivec2( x, y ), Color8u( v * tint.r / 255, v * tint.g / 255, v * tint.b / 255 ) );
+			}
+		}
+
+		return result;
+	}
+};
+
+} // anonymous namespace
+
+TiledImageTest::TiledImageTest()
+{
+	mTiledImageView = make_shared<vu::TiledImageView>();
+	mTiledImageView->setLabel( "tiled image" );
+	mTiledImageView->setSource( make_shared<ProceduralTiledSource>() );
+
+	mScrollView = make_shared<vu::ScrollView>();
+	mScrollView->setLabel( "tiled image scrollview" );
+	mScrollView->getBackground()->setColor( Color( 0.1f, 0.1f, 0.1f ) );
+	mScrollView->addContentView( mTiledImageView );
+
+	mInfoLabel = make_shared<vu::LabelGrid>();
+	mInfoLabel->setTextColor( Color::white() );
+	mInfoLabel->getBackground()->setColor( ColorA::gray( 0, 0.5f ) );
+
+	addSubview( mScrollView );
+	addSubview( mInfoLabel );
+
+	setZoom( 1.0f / 64.0f );
+}
+
+void TiledImageTest::layout()
+{
+	mScrollView->setBounds( Rectf( PADDING, PADDING, getWidth() - PADDING, getHeight() - PADDING ) );
+	mInfoLabel->setBounds( Rectf( getWidth() - 260, getHeight() - 140, getWidth() - PADDING * 2, getHeight() - PADDING * 2 ) );
+}
+
+void TiledImageTest::setZoom( float zoom )
+{
+	mZoom = glm::clamp( zoom, 1.0f / 256.0f, 1.0f );
+	mTiledImageView->setSize( vec2( IMAGE_SIZE ) * mZoom );
+	mScrollView->setNeedsLayout(); // recalculate content size
+}
+
+void TiledImageTest::update()
+{
+	int row = 0;
+	mInfoLabel->setRow( row++, { "zoom:", fmt::format( "{:.4f}", mZoom ) } );
+	mInfoLabel->setRow( row++, { "level:", to_string( mTiledImageView->getCurrentLevel() ) } );
+	mInfoLabel->setRow( row++, { "tiles drawn:", to_string( mTiledImageView->getNumTilesDrawn() ) } );
+	mInfoLabel->setRow( row++, { "tiles resident:", to_string( mTiledImageView->getNumTilesResident() ) } );
+	mInfoLabel->setRow( row++, { "tiles loading:", to_string( mTiledImageView->getNumTilesLoading() ) } );
+}
+
+bool TiledImageTest::keyDown( ci::app::KeyEvent &event )
+{
+	bool handled = true;
+	if( event.getChar() == '=' || event.getChar() == '+' ) {
+		setZoom( mZoom * 2 );
+	}
+	else if( event.getChar() == '-' ) {
+		setZoom( mZoom / 2 );
+	}
+	else {
+		handled = false;
+	}
+
+	return handled;
+}
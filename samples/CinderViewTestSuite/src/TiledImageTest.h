@@ -0,0 +1,25 @@
+#pragma once
+
+#include "vu/Suite.h"
+#include "vu/Label.h"
+#include "vu/ScrollView.h"
+#include "vu/TiledImageView.h"
+
+//! Pans and zooms a procedurally generated gigapixel image with TiledImageView.
+class TiledImageTest : public vu::SuiteView {
+public:
+	TiledImageTest();
+
+protected:
+	void layout() override;
+	void update() override;
+	bool keyDown( ci::app::KeyEvent &event ) override;
+
+private:
+	void setZoom( float zoom );
+
+	vu::ScrollViewRef		mScrollView;
+	vu::TiledImageViewRef	mTiledImageView;
+	vu::LabelGridRef		mInfoLabel;
+	float					mZoom = 1;
+};
@@ -10,9 +10,13 @@
 #include "ControlsTest.h"
 #include "CompositingTest.h"
 #include "FilterTest.h"
+#include "GestureTest.h"
 #include "LayoutTests.h"
 #include "MultiTouchTest.h"
+#include "PerfTests.h"
 #include "ScrollTests.h"
+#include "TextAreaTest.h"
+#include "TiledImageTest.h"
 
 #include "glm/gtc/epsilon.hpp"
 
@@ -75,6 +79,10 @@ void ViewTestsApp::setup()
 	mTestSuite->registerSuiteView<MultiTouchTest>( "multitouch" );
 	mTestSuite->registerSuiteView<ScrollTests>( "scroll" );
 	mTestSuite->registerSuiteView<FilterTest>( "filters" );
+	mTestSuite->registerSuiteView<PerfTests>( "perf" );
+	mTestSuite->registerSuiteView<TiledImageTest>( "tiled image" );
+	mTestSuite->registerSuiteView<TextAreaTest>( "text area" );
+	mTestSuite->registerSuiteView<GestureTest>( "gestures" );
 
 	// TODO: this doesn't cover the case of calling Suite::select() directly - should probably add new signal that ties to both Selector and that
 	mTestSuite->getSelector()->getSignalValueChanged().connect( [this] {
@@ -140,6 +148,9 @@ void ViewTestsApp::updateUI()
 	size_t numFrameBuffers = mTestSuite->getGraph()->getRenderer()->getNumFrameBuffersCached();
 	mInfoLabel->setRow( 1, { "FrameBuffers: ", to_string( numFrameBuffers ) } );
 
+	const auto &layoutStats = mTestSuite->getGraph()->getLayoutStats();
+	mInfoLabel->setRow( 2, { "layouts: ", fmt::format( "{} ({} deferred)", layoutStats.mNumLayouts, layoutStats.mNumDeferred ) } );
+
 	if( ! glm::epsilonEqual( INFO_ROW_SIZE.y * mInfoLabel->getNumRows(), mInfoLabel->getHeight(), 0.01f ) )
 		resizeInfoLabel();
 }
@@ -25,14 +25,64 @@
 #include "vu/Layout.h"
 #include "vu/Graph.h"
 #include "vu/Debug.h"
+#include "cinder/Unicode.h"
 #include "fmt/format.h"
 #include <array>
+#include <typeinfo>
 
 using namespace ci;
 using namespace std;
 
 namespace vu {
 
+namespace {
+
+const size_t VALUE_BUFFER_SIZE = 64;
+
+//! Formats \a value into \a buffer with \a numDigits decimal places, or the shortest representation if \a numDigits is negative. Returns the number of chars written.
+//! Common digit counts use compile-time format specs, nothing is allocated.
+size_t formatValue( char *buffer, float value, int numDigits )
+{
+	fmt::format_to_n_result<char *> result;
+	switch( numDigits ) {
+		case 0:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.0f}" ), value ); break;
+		case 1:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.1f}" ), value ); break;
+		case 2:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.2f}" ), value ); break;
+		case 3:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.3f}" ), value ); break;
+		case 4:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.4f}" ), value ); break;
+		case 5:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.5f}" ), value ); break;
+		case 6:		result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.6f}" ), value ); break;
+		default:
+			if( numDigits < 0 )
+				result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{}" ), value );
+			else
+				result = fmt::format_to_n( buffer, VALUE_BUFFER_SIZE, FMT_STRING( "{:.{}f}" ), value, numDigits );
+			break;
+	}
+
+	return std::min( result.size, VALUE_BUFFER_SIZE );
+}
+
+//! Rebuilds \a titleLabel as "title: value", reusing its capacity. Returns false if the text was already the same.
+bool buildTitleLabel( std::string *titleLabel, const std::string &title, const char *value, size_t valueLength )
+{
+	const size_t titleLength = title.empty() ? 0 : title.size() + 2;
+	if( titleLabel->size() == titleLength + valueLength
+			&& titleLabel->compare( 0, title.size(), title ) == 0
+			&& titleLabel->compare( titleLength, valueLength, value, valueLength ) == 0 ) {
+		return false;
+	}
+
+	titleLabel->assign( title );
+	if( ! title.empty() )
+		titleLabel->append( ": " );
+
+	titleLabel->append( value, valueLength );
+	return true;
+}
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------------------------------
 // Control
 // ----------------------------------------------------------------------------------------------------
@@ -55,7 +105,7 @@ Button::Button( const Rectf &bounds )
 	mTitleLabel = make_shared<Label>();
 	mTitleLabel->setFillParentEnabled();
 	mTitleLabel->setAlignment( vu::TextAlignment::CENTER );
-	updateTitle();
+	mTitleLabel->setBackgroundEnabled( true );
 
 	mImageView = make_shared<ImageView>();
 	mImageView->setFillParentEnabled();
@@ -63,7 +113,7 @@ Button::Button( const Rectf &bounds )
 	addSubview( mTitleLabel );
 	addSubview( mImageView );
 
-	mTitleLabel->setBackgroundEnabled( true );
+	updateVisualState();
 }
 
 const ColorA& Button::getColorForState( Button::State state ) const
@@ -131,31 +181,39 @@ void Button::updateTitle()
 	}
 }
 
-// TODO: do this only on state change, instead of every frame
-void Button::update()
+void Button::updateVisualState()
 {
+	updateTitle();
+
 	auto image = getImage();
 	if( image ) {
 		// draw image, hide label
 		mImageView->setHidden( false );
 		mTitleLabel->setHidden( true );
 
-		mImageView->setImage( image );
+		if( mImageView->getImage() != image )
+			mImageView->setImage( image );
 	}
 	else {
 		mImageView->setHidden( true );
 		mTitleLabel->setHidden( false );
 
-		if( getLabel() == "name button" ) {
-			int blarg = 2;
-		}
-
 		if( mTitleLabel->isBackgroundEnabled() ) {
 			mTitleLabel->getBackground()->setColor( getColor() );
 		}
 	}
 }
 
+void Button::setState( State state )
+{
+	if( mState == state )
+		return;
+
+	mState = state;
+	updateVisualState();
+	mSignalStateChanged.emit( mState );
+}
+
 void Button::setEnabled( bool enabled )
 {
 	State state = enabled ? State::ENABLED : State::NORMAL;
@@ -163,9 +221,11 @@ void Button::setEnabled( bool enabled )
 		return;
 
 	mEnabled = enabled;
-	mState = state;
+	if( mState != state )
+		setState( state );
+	else
+		updateVisualState(); // the title and image for the current State depend on whether the Button is enabled
 
-	updateTitle();
 	getSignalValueChanged().emit();
 }
 
@@ -179,7 +239,7 @@ void Button::setTitle( const string &title, State state )
 		CI_LOG_W( "unable to set title for state: " << state );
 	}
 
-	updateTitle();
+	updateVisualState();
 }
 
 void Button::setTitleColor( const ci::ColorA &color, State state )
@@ -197,27 +257,31 @@ void Button::setTitleColor( const ci::ColorA &color, State state )
 		mHasColorTitleNormal = true;
 	}
 
-	updateTitle();
+	updateVisualState();
 }
 
 void Button::setColor( const ci::ColorA &color, State state )
 {
 	switch( state ) {
-		case State::NORMAL:		mColorNormal = color; return;
-		case State::ENABLED:	mColorEnabled = color; return;
-		case State::PRESSED:	mColorPressed = color; return;
+		case State::NORMAL:		mColorNormal = color; break;
+		case State::ENABLED:	mColorEnabled = color; break;
+		case State::PRESSED:	mColorPressed = color; break;
 		default: CI_ASSERT_NOT_REACHABLE();
 	}
+
+	updateVisualState();
 }
 
 void Button::setImage( const vu::ImageRef &image, State state )
 {
 	switch( state ) {
-		case State::NORMAL:		mImageNormal = image; return;
-		case State::ENABLED:	mImageEnabled = image; return;
-		case State::PRESSED:	mImagePressed = image; return;
+		case State::NORMAL:		mImageNormal = image; break;
+		case State::ENABLED:	mImageEnabled = image; break;
+		case State::PRESSED:	mImagePressed = image; break;
 		default: CI_ASSERT_NOT_REACHABLE();
 	}
+
+	updateVisualState();
 }
 
 ImageRef Button::getImage() const
@@ -246,11 +310,16 @@ ImageRef Button::getImage() const
 	return mImageNormal;
 }
 
+bool Button::canBatchDraw() const
+{
+	// subclasses may draw with gl directly, so they need to opt in themselves
+	return typeid( *this ) == typeid( Button );
+}
+
 bool Button::touchesBegan( app::TouchEvent &event )
 {
-	mState = State::PRESSED;
 	setTouchCanceled( false );
-	updateTitle();
+	setState( State::PRESSED );
 
 	mSignalPressed.emit();
 	event.getTouches().front().setHandled();
@@ -267,8 +336,7 @@ bool Button::touchesMoved( app::TouchEvent &event )
 		UI_LOG_TOUCHES( "canceling touch for: " << getLabel() );
 		setTouchCanceled( true );
 		if( ! isToggle() ) {
-			mState = State::NORMAL;
-			updateTitle();
+			setState( State::NORMAL );
 		}
 		mSignalReleased.emit();
 	}
@@ -286,7 +354,7 @@ bool Button::touchesEnded( app::TouchEvent &event )
 		UI_LOG_TOUCHES( "canceling touch for: " << getLabel() );
 		setTouchCanceled( true );
 		if( ! isToggle() ) {
-			mState = State::NORMAL;
+			setState( State::NORMAL );
 		}
 	}
 	else {
@@ -327,6 +395,15 @@ CheckBox::CheckBox( const Rectf &bounds )
 	setAsToggle();
 	mTextTitle = TextManager::loadText();
 	mColorTitleNormal = Color::white();
+	updateVisualState();
+}
+
+void CheckBox::updateVisualState()
+{
+	Button::updateVisualState();
+
+	// the title is drawn by CheckBox::draw()
+	mTitleLabel->setHidden( true );
 }
 
 void CheckBox::draw( Renderer *ren )
@@ -351,7 +428,6 @@ void CheckBox::draw( Renderer *ren )
 	// draw title
 	// TODO: use Button's Label instead (we draw the text offset for CheckBox)
 	const float offsetY = 4;
-	mTitleLabel->setHidden( true );
 	ren->setColor( getTitleColor() );
 	mTextTitle->drawString( getTitle(), vec2( r + padding * 2, getCenterLocal().y + mTextTitle->getDescent() + offsetY ) );
 }
@@ -367,6 +443,14 @@ TextField::TextField( const ci::Rectf &bounds )
 	setClipEnabled( true );
 
 	mText = TextManager::loadText();
+	mInputBuffer.setFont( mText );
+}
+
+void TextField::setText( const std::string &text )
+{
+	mInputBuffer.setText( text );
+	mCursorPos = std::min( mCursorPos, (int)mInputBuffer.size() );
+	setNeedsDisplay();
 }
 
 void TextField::setBorderColor( const ci::ColorA &color, State state )
@@ -401,10 +485,10 @@ void TextField::draw( Renderer *ren )
 	const float padding = 6;
 
 	// draw text
-	if( ! mInputString.empty() ) {
+	if( ! mInputBuffer.empty() ) {
 		auto color = isFirstResponder() ? mTextColorSelected : mTextColorNormal;
 		ren->setColor( color );
-		mText->drawString( mInputString, vec2( padding, getCenterLocal().y + mText->getDescent() ) );
+		mText->drawString( mInputBuffer.getText(), vec2( padding, getCenterLocal().y + mText->getDescent() ) );
 	}
 	else if( ! isFirstResponder() && ! mPlaceholderString.empty() ) {
 		auto color = Color::gray( 0.5f ); // TODO: make color a property
@@ -415,13 +499,9 @@ void TextField::draw( Renderer *ren )
 	// draw cursor bar
 	if( isFirstResponder() ) {
 		const float cursorThickness = 1;
-		const float nextCharOffset = 6;
-		vec2 cursorLoc = { 0, 0 };
-		// measure where the cursor should be drawn (where the next character will be inserted)
-		string stringUntilCursor = mInputString.substr( 0, mCursorPos );
-		cursorLoc = mText->measureString( stringUntilCursor );
-		cursorLoc.x += nextCharOffset;
-		Rectf cursorRect = { cursorLoc.x - cursorThickness / 2, 0, cursorLoc.x + cursorThickness / 2, getHeight() };
+		// where the next character will be inserted, looked up from the buffer's cached glyph advances
+		float cursorX = padding + mInputBuffer.getOffsetForPos( (size_t)std::max( mCursorPos, 0 ) );
+		Rectf cursorRect = { cursorX - cursorThickness / 2, 0, cursorX + cursorThickness / 2, getHeight() };
 
 		ColorA cursorColor = mBorderColorSelected;
 		cursorColor.a *= (float)( 1.0 - glm::pow( cos( getGraph()->getCurrentTime() * 2 ), 4 ) );
@@ -450,12 +530,12 @@ bool TextField::willBecomeFirstResponder()
 
 	// If the current cursor position is invalid, place it at the end of the current input string
 	// TODO: place it according to touch pos
-	if( mCursorPos < 0 || mCursorPos > (int)mInputString.size() ) {
-		mCursorPos = (int)mInputString.size();
+	if( mCursorPos < 0 || mCursorPos > (int)mInputBuffer.size() ) {
+		mCursorPos = (int)mInputBuffer.size();
 	}
 
 	// store the input string, in case input is canceled and we need to revert.
-	mInputStringBeforeInput = mInputString;
+	mInputStringBeforeInput = mInputBuffer.getText();
 	return true;
 }
 
@@ -482,43 +562,50 @@ bool TextField::keyDown( ci::app::KeyEvent &event )
 	else if( event.getCode() == app::KeyEvent::KEY_ESCAPE ) {
 		// cancel input text, reverting it to previous when we became first responder
 		UI_LOG_TEXT( "(escape) text canceled." );
-		mInputString = mInputStringBeforeInput;
-		mCursorPos = std::min( mCursorPos, (int)mInputString.size() );
+		mInputBuffer.setText( mInputStringBeforeInput );
+		mCursorPos = std::min( mCursorPos, (int)mInputBuffer.size() );
 		mSignalTextInputCanceled.emit();
 		resignFirstResponder();
 	}
 	else if( event.getCode() == app::KeyEvent::KEY_BACKSPACE ) {
 		// delete character before cursor, if possible
-		if( mCursorPos > 0 && mCursorPos - 1 < mInputString.size() ) {
-			mInputString.erase( mCursorPos - 1, 1 );
-			mCursorPos -= 1;
+		if( mCursorPos > 0 && mCursorPos <= (int)mInputBuffer.size() ) {
+			size_t prevPos = mInputBuffer.prevCharPos( mCursorPos );
+			mInputBuffer.erase( prevPos, mCursorPos - prevPos );
+			mCursorPos = (int)prevPos;
 			getSignalValueChanged().emit();
 		}
-		UI_LOG_TEXT( "(backspace) string size: " << mInputString.size() << ", cursor pos: " << mCursorPos );
+		UI_LOG_TEXT( "(backspace) string size: " << mInputBuffer.size() << ", cursor pos: " << mCursorPos );
 	}
 	else if( event.getCode() == app::KeyEvent::KEY_DELETE ) {
 		// delete character after cursor, if possible
-		if( mCursorPos < mInputString.size() ) {
-			mInputString.erase( mCursorPos, 1 );
+		if( mCursorPos < (int)mInputBuffer.size() ) {
+			mInputBuffer.erase( mCursorPos, mInputBuffer.nextCharPos( mCursorPos ) - mCursorPos );
 			getSignalValueChanged().emit();
 		}
-		UI_LOG_TEXT( "(delete) string size: " << mInputString.size() << ", cursor pos: " << mCursorPos );
+		UI_LOG_TEXT( "(delete) string size: " << mInputBuffer.size() << ", cursor pos: " << mCursorPos );
 	}
 	else if( event.getCode() == app::KeyEvent::KEY_RIGHT ) {
 		// move cursor to the right, if possible
-		if( mCursorPos < mInputString.size() ) {
-			mCursorPos += 1;
-		}
+		mCursorPos = (int)mInputBuffer.nextCharPos( mCursorPos );
 
-		UI_LOG_TEXT( "(right) string size: " << mInputString.size() << ", cursor pos: " << mCursorPos );
+		UI_LOG_TEXT( "(right) string size: " << mInputBuffer.size() << ", cursor pos: " << mCursorPos );
 	}
 	else if( event.getCode() == app::KeyEvent::KEY_LEFT ) {
-		// move cursor to the right, if possible
-		if( mCursorPos > 0 ) {
-			mCursorPos -= 1;
-		}
+		// move cursor to the left, if possible
+		mCursorPos = (int)mInputBuffer.prevCharPos( mCursorPos );
 
-		UI_LOG_TEXT( "(left) string size: " << mInputString.size() << ", cursor pos: " << mCursorPos );
+		UI_LOG_TEXT( "(left) string size: " << mInputBuffer.size() << ", cursor pos: " << mCursorPos );
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_HOME ) {
+		mCursorPos = 0;
+	}
+	else if( event.getCode() == app::KeyEvent::KEY_END ) {
+		mCursorPos = (int)mInputBuffer.size();
+	}
+	else if( event.getCharUtf32() > 0x7F && mInputMode == InputMode::TEXT ) {
+		// non-ASCII chars are inserted as their UTF-8 sequence
+		insertAtCursor( toUtf8( u32string( 1, (char32_t)event.getCharUtf32() ) ) );
 	}
 	else if( event.getChar() ) {
 		if( ! checkCharIsValid( event.getChar() ) ) {
@@ -526,10 +613,7 @@ bool TextField::keyDown( ci::app::KeyEvent &event )
 			handled = false;
 		}
 		else {
-			mInputString.insert( mCursorPos, 1, event.getChar() );
-			mCursorPos += 1;
-			UI_LOG_TEXT( "(enter char) string size: " << mInputString.size() << ", cursor pos: " << mCursorPos );
-			getSignalValueChanged().emit();
+			insertAtCursor( string( 1, event.getChar() ) );
 		}
 	}
 	else
@@ -538,12 +622,20 @@ bool TextField::keyDown( ci::app::KeyEvent &event )
 	return handled;
 }
 
+void TextField::insertAtCursor( const std::string &str )
+{
+	mInputBuffer.insert( mCursorPos, str );
+	mCursorPos += (int)str.size();
+	UI_LOG_TEXT( "(enter char) string size: " << mInputBuffer.size() << ", cursor pos: " << mCursorPos );
+	getSignalValueChanged().emit();
+}
+
 bool TextField::checkCharIsValid( char c ) const
 {
 	if( mInputMode == InputMode::NUMERIC ) {
 		if( c == '.' ) {
 			// not valid if there is already a decimal in the input string
-			if( mInputString.find( '.' ) != string::npos )
+			if( getText().find( '.' ) != string::npos )
 				return false;
 		}
 		else if( c == '-' ) {
@@ -566,6 +658,7 @@ SliderBase::SliderBase( const Rectf &bounds )
 	: Control( bounds )
 {
 	mTextLabel = TextManager::loadText();
+	updateTitleLabel();
 
 	// set a default background color
 	getBackground()->setColor( Color::black() );
@@ -614,14 +707,25 @@ void SliderBase::draw( Renderer *ren )
 	mTextLabel->drawString( getTitleLabel(), vec2( padding, getCenterLocal().y + mTextLabel->getDescent() ) );
 }
 
-std::string	SliderBase::getTitleLabel() const
+void SliderBase::setTitle( const std::string &title )
+{
+	mTitle = title;
+	mTitleLabelValid = false;
+	updateTitleLabel();
+}
+
+void SliderBase::updateTitleLabel()
 {
-	std::string result = mTitle;
-	if( ! result.empty() )
-		result += ": ";
+	if( mTitleLabelValid && mTitleLabelValue == mValue )
+		return;
+
+	mTitleLabelValid = true;
+	mTitleLabelValue = mValue;
 
-	result += fmt::format( "{}", getValue() );
-	return result;
+	char buffer[VALUE_BUFFER_SIZE];
+	size_t length = formatValue( buffer, mValue, -1 );
+	if( buildTitleLabel( &mTitleLabel, mTitle, buffer, length ) )
+		setNeedsDisplay();
 }
 
 bool SliderBase::touchesBegan( app::TouchEvent &event )
@@ -685,6 +789,9 @@ void SliderBase::updateSliderPos()
 		mSliderPos = 0;
 	else
 		mSliderPos = constrain<float>( ( mValue - mMin ) / range, 0, 1 );
+
+	updateTitleLabel();
+	setNeedsDisplay();
 }
 
 void SliderBase::updateValue( const ci::vec2 &pos )
@@ -696,8 +803,12 @@ void SliderBase::updateValue( const ci::vec2 &pos )
 	if( mSnapToInt )
 		mValue = roundf( mValue );
 
-	if( mValue != prevValue )
+	setNeedsDisplay();
+
+	if( mValue != prevValue ) {
+		updateTitleLabel();
 		getSignalValueChanged().emit();
+	}
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -877,7 +988,15 @@ NumberBox::NumberBox( const Rectf &bounds )
 	addSubview( mTextField );
 	View::setNextResponder( mTextField );
 
-	mTapTracker.getSignalGestureDetected().connect( signals::slot( this, &NumberBox::onDoubleTap ) );
+	mDoubleTapRecognizer = make_shared<TapGestureRecognizer>();
+	mDoubleTapRecognizer->setNumTapsRequired( 2 );
+	mDoubleTapRecognizer->setMaxTapDuration( 0.2 );
+	mDoubleTapRecognizer->setMaxTimeBetweenTaps( 0.2 );
+	mDoubleTapRecognizer->getSignalGesture().connect( [this]( GestureRecognizer *recognizer ) {
+		if( recognizer->getState() == GestureState::ENDED )
+			onDoubleTap();
+	} );
+	addGestureRecognizer( mDoubleTapRecognizer );
 	mTextField->getSignalValueChanged().connect( signals::slot( this, &NumberBox::onTextInputUpdated ) );
 	mTextField->getSignalmSignalTextInputBegin().connect( signals::slot( this, &NumberBox::onTextInputBegin ) );
 	mTextField->getSignalTextInputCompleted().connect( signals::slot( this, &NumberBox::onTextInputCompleted ) );
@@ -907,6 +1026,8 @@ void NumberBox::setValue( float value, bool emitChanged )
 	if( mSnapToInt )
 		mValue = roundf( mValue );
 
+	updateTitleLabel();
+
 	if( emitChanged )
 		getSignalValueChanged().emit();
 }
@@ -919,6 +1040,8 @@ void NumberBox::setTitle( const std::string &title )
 
 	mTextField->setLabel( "TextField (" + getLabel() + ")" );
 
+	mTitleLabelValid = false;
+	updateTitleLabel();
 	setNeedsLayout();
 }
 
@@ -946,28 +1069,38 @@ void NumberBox::draw( Renderer *ren )
 	ren->drawStrokedRect( getBoundsLocal(), 2 );
 }
 
-std::string	NumberBox::getTitleLabel() const
+void NumberBox::updateTitleLabel()
 {
-	std::string result = mTitle;
-	if( ! result.empty() )
-		result += ": ";
-
 	// If we're in text entry mode, the TextField will display the value. Otherwise, append it here.
-	if( mTextField->isHidden() ) {
-		result += getValueAsString();
-	}
-	return result;
+	// note: mTextField is null when called from the constructor
+	const bool showsValue = ! mTextField || mTextField->isHidden();
+
+	// the label is keyed on everything that goes into it, so redundant updates (ex. every drag event) don't format anything
+	if( mTitleLabelValid && mTitleLabelValue == mValue && mTitleLabelShowsValue == showsValue )
+		return;
+
+	mTitleLabelValid = true;
+	mTitleLabelValue = mValue;
+	mTitleLabelShowsValue = showsValue;
+
+	char buffer[VALUE_BUFFER_SIZE];
+	size_t length = showsValue ? formatValue( buffer, mValue, (int)mNumDigits ) : 0;
+	if( buildTitleLabel( &mTitleLabel, mTitle, buffer, length ) )
+		setNeedsDisplay();
 }
 
 std::string	NumberBox::getValueAsString() const
 {
-	return fmt::format( mFormatStr, getValue() );
+	char buffer[VALUE_BUFFER_SIZE];
+	size_t length = formatValue( buffer, getValue(), (int)mNumDigits );
+	return std::string( buffer, length );
 }
 
 void NumberBox::setNumDigits( size_t numDigits )
 {
 	mNumDigits = numDigits;
-	mFormatStr = "{0:." + to_string( numDigits ) + "f}";
+	mTitleLabelValid = false;
+	updateTitleLabel();
 }
 
 void NumberBox::updateValueFromTextField()
@@ -1005,6 +1138,7 @@ void NumberBox::onTextInputBegin()
 
 	mTextField->setText( getValueAsString() );	
 	mTextField->setHidden( false );
+	updateTitleLabel();
 }
 
 void NumberBox::onTextInputUpdated()
@@ -1020,12 +1154,12 @@ void NumberBox::onTextInputCompleted()
 
 	// text input is finished so hide the TextField
 	mTextField->setHidden( true );
+	updateTitleLabel();
 }
 
 bool NumberBox::touchesBegan( app::TouchEvent &event )
 {
 	setTouchCanceled( false );
-	mTapTracker.processTouchesBegan( event, getGraph()->getCurrentTime() );
 
 	auto &firstTouch = event.getTouches().front();
 	mDragStartPos = toLocal( firstTouch.getPos() );
@@ -1050,7 +1184,6 @@ bool NumberBox::touchesMoved( app::TouchEvent &event )
 bool NumberBox::touchesEnded( app::TouchEvent &event )
 {
 	setTouchCanceled( false );
-	mTapTracker.processTouchesEnded( event, getGraph()->getCurrentTime() );
 
 	auto &firstTouch = event.getTouches().front();
 	vec2 pos = toLocal( firstTouch.getPos() );
@@ -1074,8 +1207,10 @@ void NumberBox::updateValue( const ci::vec2 &pos )
 	if( mSnapToInt )
 		mValue = roundf( mValue );
 
-	if( mValue != prevValue )
+	if( mValue != prevValue ) {
+		updateTitleLabel();
 		getSignalValueChanged().emit();
+	}
 }
 
 
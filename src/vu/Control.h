@@ -26,7 +26,8 @@
 #include "vu/View.h"
 #include "vu/ImageView.h"
 #include "vu/Label.h"
-#include "vu/GestureTracker.h"
+#include "vu/GestureRecognizer.h"
+#include "vu/TextBuffer.h"
 
 namespace vu {
 
@@ -103,9 +104,16 @@ class CI_UI_API Button : public Control {
 
 	ci::signals::Signal<void ()>&	getSignalPressed()	{ return mSignalPressed; }
 	ci::signals::Signal<void ()>&	getSignalReleased()	{ return mSignalReleased; }
+	//! Signal emitted when the Button's State changes, with the new State.
+	ci::signals::Signal<void ( State )>&	getSignalStateChanged()	{ return mSignalStateChanged; }
 
   protected:
-	void update() override;
+	//! Button only draws with its subviews, subclasses that override draw() are flushed as usual unless they also override this.
+	bool canBatchDraw() const override;
+	//! Moves to \a state, updating the Button's appearance and emitting the state changed signal if it is different from the current State.
+	void setState( State state );
+	//! Updates the title, image and colors of subviews for the current State. Called when the State or any per-state property changes, rather than every frame.
+	virtual void updateVisualState();
 	void updateTitle();
 
 	bool touchesBegan( ci::app::TouchEvent &event )	override;
@@ -134,6 +142,7 @@ class CI_UI_API Button : public Control {
 	ImageRef   mImageNormal, mImageEnabled, mImagePressed;
 
 	ci::signals::Signal<void ()>	mSignalPressed, mSignalReleased; // TODO: look at other frameworks (like html5, dart) and see what they name these, and how they organize the events
+	ci::signals::Signal<void ( State )>	mSignalStateChanged;
 };
 
 //! Returns scaleMode in string representation.
@@ -148,6 +157,7 @@ class CI_UI_API CheckBox : public Button {
 
   protected:
 	void draw( Renderer *ren )	override;
+	void updateVisualState() override;
 
   private:
 	TextRef      mTextTitle;
@@ -165,8 +175,8 @@ class CI_UI_API TextField : public Control {
 	void setBorderColor( const ci::ColorA &color, State state = State::NORMAL );
 	void setTextColor( const ci::ColorA &color, State state = State::NORMAL );
 
-	void				setText( const std::string &text )				{ mInputString = text; }
-	const std::string&	getText() const									{ return mInputString; }
+	void				setText( const std::string &text );
+	const std::string&	getText() const									{ return mInputBuffer.getText(); }
 	void				setPlaceholderText( const std::string &text );
 	const std::string&	getPlaceholderText() const						{ return mPlaceholderString; }
 
@@ -188,10 +198,13 @@ class CI_UI_API TextField : public Control {
 	bool	keyDown( ci::app::KeyEvent &event ) override;
 	bool	checkCharIsValid( char c ) const;
 
+	void	insertAtCursor( const std::string &str );
+
 	TextRef		mText;
-	std::string mInputString, mInputStringBeforeInput;
+	TextBuffer	mInputBuffer;
+	std::string mInputStringBeforeInput;
 	std::string mPlaceholderString;
-	int			mCursorPos = -1; // position of next character input. -1 indicates it's never been set and will be at the end of the text once we're first responder
+	int			mCursorPos = -1; // byte position of next character input. -1 indicates it's never been set and will be at the end of the text once we're first responder
 
 	InputMode	mInputMode = InputMode::TEXT;
 	BorderMode  mBorderMode = BorderMode::LINE;
@@ -213,7 +226,7 @@ class CI_UI_API SliderBase : public Control {
 	float getMin() const	{ return mMin; }
 	float getMax() const	{ return mMax; }
 
-	void				setTitle( const std::string &title )	{ mTitle = title; }
+	void				setTitle( const std::string &title );
 	const std::string&	getTitle() const						{ return mTitle; }
 
 	float getValue() const	{ return mValue; }
@@ -236,12 +249,14 @@ class CI_UI_API SliderBase : public Control {
 	virtual float getValuePercentage( const ci::vec2 &pos )							= 0;
 	virtual ci::Rectf	getValueRect( float sliderPos, float sliderRadius ) const	= 0;
 
-	std::string	getTitleLabel() const;
+	//! Returns the title and value as they are drawn, which is only rebuilt when one of them changes.
+	const std::string&	getTitleLabel() const	{ return mTitleLabel; }
 
 	void updateSliderPos();
 	void updateValue( const ci::vec2 &pos );
 
   private:
+	void updateTitleLabel();
 
 	float	mValue = 0;
 	float	mMin = 0;
@@ -254,6 +269,9 @@ class CI_UI_API SliderBase : public Control {
 	ci::ColorA	mTitleColor = ci::ColorA::gray( 1, 0.6f );
 	std::string	mTitle;
 	TextRef		mTextLabel;
+	std::string	mTitleLabel;
+	float		mTitleLabelValue = 0;
+	bool		mTitleLabelValid = false;
 };
 
 class CI_UI_API HSlider : public SliderBase {
@@ -371,7 +389,8 @@ class CI_UI_API NumberBox : public Control {
 	bool touchesMoved( ci::app::TouchEvent &event )	override;
 	bool touchesEnded( ci::app::TouchEvent &event )	override;
 
-	std::string	getTitleLabel() const;
+	//! Returns the title and value as they are drawn, which is only rebuilt when one of them changes.
+	const std::string&	getTitleLabel() const	{ return mTitleLabel; }
 
 	void updateValue( const ci::vec2 &pos );
 
@@ -382,6 +401,7 @@ class CI_UI_API NumberBox : public Control {
 	void onTextInputCompleted();
 	std::string	getValueAsString() const;
 	void updateValueFromTextField();
+	void updateTitleLabel();
 
 	float	mValue = 0;
 	float	mMin;
@@ -395,12 +415,16 @@ class CI_UI_API NumberBox : public Control {
 	ci::ColorA	mBorderColor = ci::ColorA::gray( 1, 0.4f );
 	ci::ColorA	mTitleColor = ci::ColorA::gray( 1, 0.6f );
 	std::string	mTitle;
+	std::string	mTitleLabel;
 	TextRef		mTextLabel;
-	TapTracker	mTapTracker;
+	TapGestureRecognizerRef	mDoubleTapRecognizer;
 
-	size_t				mNumDigits;
-	std::string			mFormatStr;
+	size_t				mNumDigits = 3;
 	vu::TextFieldRef	mTextField;
+
+	float				mTitleLabelValue = 0;
+	bool				mTitleLabelShowsValue = false;
+	bool				mTitleLabelValid = false;
 };
 
 template <typename T>
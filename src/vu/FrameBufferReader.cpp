@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/FrameBufferReader.h"
+
+#include "cinder/gl/Fbo.h"
+#include "cinder/gl/Pbo.h"
+#include "cinder/gl/Sync.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/Log.h"
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+FrameBufferReader::FrameBufferReader( size_t numBuffers )
+	: mBuffers( std::max<size_t>( numBuffers, 1 ) )
+{
+}
+
+FrameBufferReader::~FrameBufferReader()
+{
+}
+
+bool FrameBufferReader::read( const FrameBufferRef &frameBuffer, const Callback &callback )
+{
+	CI_ASSERT( frameBuffer );
+
+	auto &buffer = mBuffers[mNextRead];
+	if( buffer.mFence )
+		return false;
+
+	const ivec2 size = frameBuffer->getSize();
+	const size_t numBytes = size_t( size.x ) * size_t( size.y ) * 4;
+	if( ! buffer.mPbo || buffer.mPbo->getSize() < numBytes ) {
+		buffer.mPbo = gl::Pbo::create( GL_PIXEL_PACK_BUFFER, numBytes, nullptr, GL_STREAM_READ );
+	}
+
+	{
+		gl::ScopedFramebuffer fboScope( GL_READ_FRAMEBUFFER, frameBuffer->mFbo->getId() );
+		gl::ScopedBuffer pboScope( buffer.mPbo );
+		glReadBuffer( GL_COLOR_ATTACHMENT0 );
+		glReadPixels( 0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+	}
+
+	buffer.mFence = gl::Sync::create();
+	buffer.mSize = size;
+	buffer.mCallback = callback;
+
+	mNextRead = ( mNextRead + 1 ) % mBuffers.size();
+	mNumPending++;
+	return true;
+}
+
+void FrameBufferReader::update()
+{
+	while( mNumPending > 0 && deliverNext( false ) )
+		;
+}
+
+void FrameBufferReader::flush()
+{
+	while( mNumPending > 0 )
+		deliverNext( true );
+}
+
+bool FrameBufferReader::deliverNext( bool wait )
+{
+	auto &buffer = mBuffers[mNextDeliver];
+	CI_ASSERT( buffer.mFence );
+
+	const GLuint64 timeout = wait ? GL_TIMEOUT_IGNORED : 0;
+	GLenum status = buffer.mFence->clientWaitSync( GL_SYNC_FLUSH_COMMANDS_BIT, timeout );
+	if( status == GL_TIMEOUT_EXPIRED )
+		return false;
+
+	if( status == GL_WAIT_FAILED ) {
+		CI_LOG_E( "waiting on readback fence failed" );
+	}
+	else {
+		const size_t numBytes = size_t( buffer.mSize.x ) * size_t( buffer.mSize.y ) * 4;
+		gl::ScopedBuffer pboScope( buffer.mPbo );
+		auto data = static_cast<uint8_t *>( buffer.mPbo->mapBufferRange( 0, numBytes, GL_MAP_READ_BIT ) );
+		if( data ) {
+			Surface8u surface( data, buffer.mSize.x, buffer.mSize.y, buffer.mSize.x * 4, SurfaceChannelOrder::RGBA );
+			try {
+				buffer.mCallback( surface );
+			}
+			catch( std::exception &exc ) {
+				CI_LOG_E( "exception caught from readback callback, what: " << exc.what() );
+			}
+			buffer.mPbo->unmap();
+		}
+		else {
+			CI_LOG_E( "failed to map readback buffer" );
+		}
+	}
+
+	buffer.mFence.reset();
+	buffer.mCallback = nullptr;
+	mNextDeliver = ( mNextDeliver + 1 ) % mBuffers.size();
+	mNumPending--;
+	return true;
+}
+
+} // namespace vu
@@ -0,0 +1,89 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Renderer.h"
+
+#include "cinder/Surface.h"
+
+#include <functional>
+#include <vector>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class Pbo>		PboRef;
+typedef std::shared_ptr<class Sync>		SyncRef;
+
+} } // namespace cinder::gl
+
+namespace vu {
+
+typedef std::shared_ptr<class FrameBufferReader>	FrameBufferReaderRef;
+
+//! Reads back the contents of FrameBuffers without stalling the GPU, unlike FrameBuffer::createImageSource().
+//! Pixels are copied into one of a ring of pixel buffer objects, and delivered from update() once the GPU has finished the transfer.
+class CI_UI_API FrameBufferReader {
+  public:
+	//! Called with the mapped pixels of a completed read. The Surface refers directly to GL memory and is only valid for the duration of the callback.
+	//! \note Rows are stored bottom to top, as GL reads them.
+	typedef std::function<void ( const ci::Surface8u &surface )>	Callback;
+
+	//! Creates a FrameBufferReader that can have up to \a numBuffers reads in flight.
+	explicit FrameBufferReader( size_t numBuffers = 3 );
+	~FrameBufferReader();
+
+	//! Starts reading the color contents of \a frameBuffer, \a callback will be called from update() once they are available.
+	//! Returns false if all buffers are in flight, in which case the read is dropped. The FrameBuffer can be reused immediately after.
+	bool	read( const FrameBufferRef &frameBuffer, const Callback &callback );
+	//! Delivers any reads that the GPU has completed, in the order they were made. Should be called once per frame.
+	void	update();
+	//! Blocks until all pending reads have completed and delivers them.
+	void	flush();
+
+	//! Returns the number of reads that have been started but not yet delivered.
+	size_t	getNumPending() const	{ return mNumPending; }
+	//! Returns the number of buffers, which is the maximum number of reads in flight.
+	size_t	getNumBuffers() const	{ return mBuffers.size(); }
+
+  private:
+	FrameBufferReader( const FrameBufferReader& )				= delete;
+	FrameBufferReader& operator=( const FrameBufferReader& )	= delete;
+
+	struct Buffer {
+		ci::gl::PboRef	mPbo;
+		ci::gl::SyncRef	mFence; // null when the buffer is available
+		ci::ivec2		mSize;
+		Callback		mCallback;
+	};
+
+	//! Returns true if the oldest pending read was delivered. If \a wait is true, blocks until it has completed.
+	bool	deliverNext( bool wait );
+
+	std::vector<Buffer>	mBuffers;
+	size_t				mNextRead = 0;		// index of the buffer that the next read() uses
+	size_t				mNextDeliver = 0;	// index of the oldest pending read
+	size_t				mNumPending = 0;
+};
+
+} // namespace vu
@@ -0,0 +1,606 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/GestureRecognizer.h"
+#include "vu/Graph.h"
+
+#include "cinder/CinderAssert.h"
+#include "cinder/CinderMath.h"
+
+#include <algorithm>
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+namespace {
+
+bool containsTouch( const vector<app::TouchEvent::Touch> &touches, uint32_t id )
+{
+	return find_if( touches.begin(), touches.end(), [id]( const app::TouchEvent::Touch &touch ) { return touch.getId() == id; } ) != touches.end();
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------------------------------
+// TouchHistory
+// ----------------------------------------------------------------------------------------------------
+
+TouchHistory::TouchHistory( size_t capacity )
+	: mSamples( std::max<size_t>( capacity, 1 ) )
+{
+}
+
+void TouchHistory::beginTouch( uint32_t id, const vec2 &pos, double time )
+{
+	// drop touches that have ended (or are being reused), the recognizers that needed them have been reset by now
+	mTouches.erase( remove_if( mTouches.begin(), mTouches.end(),
+		[id]( const TouchRecord &record ) { return ! record.mActive || record.mFirst.mId == id; } ),
+		mTouches.end() );
+
+	TouchRecord record;
+	record.mFirst = { id, pos, time };
+	record.mActive = true;
+	mTouches.push_back( record );
+
+	addSample( id, pos, time );
+}
+
+void TouchHistory::addSample( uint32_t id, const vec2 &pos, double time )
+{
+	Sample sample = { id, pos, time };
+	mSamples[mNextSample] = sample;
+	mNextSample = ( mNextSample + 1 ) % mSamples.size();
+	mNumSamples = std::min( mNumSamples + 1, mSamples.size() );
+
+	auto record = findTouch( id );
+	if( record ) {
+		record->mLast = sample;
+	}
+	else {
+		// touch began before the history was recording
+		TouchRecord newRecord;
+		newRecord.mFirst = newRecord.mLast = sample;
+		newRecord.mActive = true;
+		mTouches.push_back( newRecord );
+	}
+}
+
+void TouchHistory::endTouch( uint32_t id, const vec2 &pos, double time )
+{
+	addSample( id, pos, time );
+
+	auto record = findTouch( id );
+	if( record )
+		record->mActive = false;
+}
+
+TouchHistory::TouchRecord* TouchHistory::findTouch( uint32_t id )
+{
+	for( auto &record : mTouches ) {
+		if( record.mFirst.mId == id )
+			return &record;
+	}
+
+	return nullptr;
+}
+
+const TouchHistory::TouchRecord* TouchHistory::findTouch( uint32_t id ) const
+{
+	for( const auto &record : mTouches ) {
+		if( record.mFirst.mId == id )
+			return &record;
+	}
+
+	return nullptr;
+}
+
+const TouchHistory::Sample* TouchHistory::getFirstSample( uint32_t id ) const
+{
+	auto record = findTouch( id );
+	return record ? &record->mFirst : nullptr;
+}
+
+const TouchHistory::Sample* TouchHistory::getLastSample( uint32_t id ) const
+{
+	auto record = findTouch( id );
+	return record ? &record->mLast : nullptr;
+}
+
+vec2 TouchHistory::calcVelocity( uint32_t id, double duration ) const
+{
+	auto record = findTouch( id );
+	if( ! record )
+		return vec2( 0 );
+
+	// walk back from the newest sample to the oldest one of this touch that is within duration
+	const Sample &last = record->mLast;
+	const Sample *oldest = &last;
+	const size_t capacity = mSamples.size();
+	for( size_t i = 0; i < mNumSamples; i++ ) {
+		const Sample &sample = mSamples[( mNextSample + capacity - 1 - i ) % capacity];
+		if( sample.mTime < record->mFirst.mTime || last.mTime - sample.mTime > duration )
+			break;
+
+		if( sample.mId == id )
+			oldest = &sample;
+	}
+
+	double dt = last.mTime - oldest->mTime;
+	if( dt <= 0 )
+		return vec2( 0 );
+
+	return ( last.mPos - oldest->mPos ) / float( dt );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// GestureRecognizer
+// ----------------------------------------------------------------------------------------------------
+
+const char* gestureStateToString( GestureState state )
+{
+	switch( state ) {
+		case GestureState::POSSIBLE:	return "POSSIBLE";
+		case GestureState::BEGAN:		return "BEGAN";
+		case GestureState::CHANGED:		return "CHANGED";
+		case GestureState::ENDED:		return "ENDED";
+		case GestureState::CANCELLED:	return "CANCELLED";
+		case GestureState::FAILED:		return "FAILED";
+		default: CI_ASSERT_NOT_REACHABLE();
+	}
+
+	return "(unknown)";
+}
+
+bool GestureRecognizer::isRecognized() const
+{
+	return mState == GestureState::BEGAN || mState == GestureState::CHANGED || mState == GestureState::ENDED;
+}
+
+bool GestureRecognizer::isFinished() const
+{
+	return mState == GestureState::ENDED || mState == GestureState::CANCELLED || mState == GestureState::FAILED;
+}
+
+void GestureRecognizer::requireToFail( const GestureRecognizerRef &other )
+{
+	CI_ASSERT( other && other.get() != this );
+	mRequiredToFail.push_back( other );
+}
+
+vec2 GestureRecognizer::getLocation() const
+{
+	static const vector<app::TouchEvent::Touch> sNoTouches;
+	return calcLocation( sNoTouches );
+}
+
+vec2 GestureRecognizer::getLocationInView() const
+{
+	return mView ? mView->toLocal( getLocation() ) : getLocation();
+}
+
+vec2 GestureRecognizer::calcLocation( const vector<app::TouchEvent::Touch> &excludedTouches ) const
+{
+	if( ! mGraph )
+		return mLastLocation;
+
+	vec2 sum( 0 );
+	int count = 0;
+	for( uint32_t id : mTouchIds ) {
+		auto sample = mGraph->getTouchHistory().getLastSample( id );
+		if( sample && ! containsTouch( excludedTouches, id ) ) {
+			sum += sample->mPos;
+			count++;
+		}
+	}
+
+	return count > 0 ? sum / float( count ) : mLastLocation;
+}
+
+vec2 GestureRecognizer::getTouchPos( size_t index ) const
+{
+	CI_ASSERT( index < mTouchIds.size() );
+
+	auto sample = getTouchHistory().getLastSample( mTouchIds[index] );
+	return sample ? sample->mPos : mLastLocation;
+}
+
+double GestureRecognizer::getCurrentTime() const
+{
+	CI_ASSERT( mGraph );
+	return mGraph->getCurrentTime();
+}
+
+const TouchHistory& GestureRecognizer::getTouchHistory() const
+{
+	CI_ASSERT( mGraph );
+	return mGraph->getTouchHistory();
+}
+
+void GestureRecognizer::setState( GestureState state )
+{
+	if( mPendingState != GestureState::POSSIBLE ) {
+		// Waiting on other recognizers to fail, the only change allowed is giving up.
+		if( state == GestureState::FAILED || state == GestureState::CANCELLED || ( state == GestureState::ENDED && mPendingState == GestureState::BEGAN ) ) {
+			mPendingState = GestureState::POSSIBLE;
+			transitionTo( GestureState::FAILED );
+		}
+		return;
+	}
+
+	if( mState == GestureState::POSSIBLE && ( state == GestureState::BEGAN || state == GestureState::ENDED ) ) {
+		mPendingState = state;
+		resolvePendingState();
+		return;
+	}
+
+	transitionTo( state );
+}
+
+void GestureRecognizer::resolvePendingState()
+{
+	if( mPendingState == GestureState::POSSIBLE )
+		return;
+
+	for( const auto &weakOther : mRequiredToFail ) {
+		auto other = weakOther.lock();
+		if( ! other )
+			continue;
+
+		if( other->isRecognized() ) {
+			mPendingState = GestureState::POSSIBLE;
+			transitionTo( GestureState::FAILED );
+			return;
+		}
+
+		// an inactive recognizer isn't tracking any touches, so it has nothing to decide
+		if( other->mActive && other->mState == GestureState::POSSIBLE )
+			return;
+	}
+
+	auto state = mPendingState;
+	mPendingState = GestureState::POSSIBLE;
+	transitionTo( state );
+}
+
+void GestureRecognizer::transitionTo( GestureState state )
+{
+	if( mState == state && state != GestureState::CHANGED )
+		return;
+
+	mState = state;
+	if( state != GestureState::POSSIBLE && state != GestureState::FAILED ) {
+		mSignalGesture.emit( this );
+	}
+}
+
+void GestureRecognizer::resetState()
+{
+	mState = GestureState::POSSIBLE;
+	mPendingState = GestureState::POSSIBLE;
+	mTouchIds.clear();
+	mActive = false;
+	mGraph = nullptr;
+	reset();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// TapGestureRecognizer
+// ----------------------------------------------------------------------------------------------------
+
+void TapGestureRecognizer::touchesBegan( const vector<app::TouchEvent::Touch> &touches )
+{
+	double currentTime = getCurrentTime();
+	if( mTapCount > 0 && currentTime - mLastTapTime > mMaxTimeBetweenTaps ) {
+		setState( GestureState::FAILED );
+		return;
+	}
+
+	if( isLastTouches( touches ) ) {
+		// first touches of a new tap
+		mTapBeganTime = currentTime;
+		mNumTouchesInTap = 0;
+	}
+
+	mNumTouchesInTap = std::max( mNumTouchesInTap, (int)getNumTouches() );
+	if( mNumTouchesInTap > mNumTouchesRequired ) {
+		setState( GestureState::FAILED );
+	}
+}
+
+void TapGestureRecognizer::touchesMoved( const vector<app::TouchEvent::Touch> &touches )
+{
+	for( const auto &touch : touches ) {
+		auto first = getTouchHistory().getFirstSample( touch.getId() );
+		if( first && glm::distance( touch.getPos(), first->mPos ) > mMaxMovement ) {
+			setState( GestureState::FAILED );
+			return;
+		}
+	}
+}
+
+void TapGestureRecognizer::touchesEnded( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( ! isLastTouches( touches ) )
+		return;
+
+	double currentTime = getCurrentTime();
+	if( currentTime - mTapBeganTime > mMaxTapDuration || mNumTouchesInTap != mNumTouchesRequired ) {
+		setState( GestureState::FAILED );
+		return;
+	}
+
+	mTapCount++;
+	mLastTapTime = currentTime;
+	if( mTapCount >= mNumTapsRequired ) {
+		setState( GestureState::ENDED );
+	}
+}
+
+void TapGestureRecognizer::update( double currentTime )
+{
+	// fail as soon as possible so that recognizers waiting on this one can proceed
+	if( getNumTouches() > 0 ) {
+		if( currentTime - mTapBeganTime > mMaxTapDuration )
+			setState( GestureState::FAILED );
+	}
+	else if( mTapCount > 0 && currentTime - mLastTapTime > mMaxTimeBetweenTaps ) {
+		setState( GestureState::FAILED );
+	}
+}
+
+void TapGestureRecognizer::reset()
+{
+	mTapCount = 0;
+	mNumTouchesInTap = 0;
+	mTapBeganTime = -1;
+	mLastTapTime = -1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// LongPressGestureRecognizer
+// ----------------------------------------------------------------------------------------------------
+
+void LongPressGestureRecognizer::touchesBegan( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( getState() != GestureState::POSSIBLE )
+		return;
+
+	if( (int)getNumTouches() > mNumTouchesRequired ) {
+		setState( GestureState::FAILED );
+	}
+	else if( (int)getNumTouches() == mNumTouchesRequired ) {
+		mBeganTime = getCurrentTime();
+	}
+}
+
+void LongPressGestureRecognizer::touchesMoved( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( isRecognized() ) {
+		setState( GestureState::CHANGED );
+		return;
+	}
+
+	for( const auto &touch : touches ) {
+		auto first = getTouchHistory().getFirstSample( touch.getId() );
+		if( first && glm::distance( touch.getPos(), first->mPos ) > mMaxMovement ) {
+			setState( GestureState::FAILED );
+			return;
+		}
+	}
+}
+
+void LongPressGestureRecognizer::touchesEnded( const vector<app::TouchEvent::Touch> &touches )
+{
+	setState( isRecognized() ? GestureState::ENDED : GestureState::FAILED );
+}
+
+void LongPressGestureRecognizer::update( double currentTime )
+{
+	if( getState() == GestureState::POSSIBLE && mBeganTime >= 0 && (int)getNumTouches() == mNumTouchesRequired && currentTime - mBeganTime >= mMinDuration ) {
+		setState( GestureState::BEGAN );
+	}
+}
+
+void LongPressGestureRecognizer::reset()
+{
+	mBeganTime = -1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// PanGestureRecognizer
+// ----------------------------------------------------------------------------------------------------
+
+void PanGestureRecognizer::touchesBegan( const vector<app::TouchEvent::Touch> &touches )
+{
+	// re-base on the new centroid so that adding touches doesn't jump the translation
+	mLastCentroid = getLocation();
+}
+
+void PanGestureRecognizer::touchesMoved( const vector<app::TouchEvent::Touch> &touches )
+{
+	vec2 centroid = getLocation();
+	mTranslation += centroid - mLastCentroid;
+	mLastCentroid = centroid;
+	updateVelocity();
+
+	if( isRecognized() )
+		setState( GestureState::CHANGED );
+	else if( glm::length( mTranslation ) >= mMinDistance )
+		setState( GestureState::BEGAN );
+}
+
+void PanGestureRecognizer::touchesEnded( const vector<app::TouchEvent::Touch> &touches )
+{
+	updateVelocity();
+
+	if( isLastTouches( touches ) )
+		setState( isRecognized() ? GestureState::ENDED : GestureState::FAILED );
+	else
+		mLastCentroid = calcLocation( touches );
+}
+
+void PanGestureRecognizer::updateVelocity()
+{
+	if( getNumTouches() == 0 )
+		return;
+
+	vec2 velocity( 0 );
+	for( uint32_t id : getTouchIds() ) {
+		velocity += getTouchHistory().calcVelocity( id );
+	}
+
+	mVelocity = velocity / float( getNumTouches() );
+}
+
+void PanGestureRecognizer::reset()
+{
+	mTranslation = vec2( 0 );
+	mVelocity = vec2( 0 );
+	mLastCentroid = vec2( 0 );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// PinchGestureRecognizer
+// ----------------------------------------------------------------------------------------------------
+
+void PinchGestureRecognizer::touchesBegan( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( getState() == GestureState::POSSIBLE && mStartDistance <= 0 && getNumTouches() >= 2 ) {
+		mStartDistance = std::max( glm::distance( getTouchPos( 0 ), getTouchPos( 1 ) ), 1.0f );
+	}
+}
+
+void PinchGestureRecognizer::touchesMoved( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( getNumTouches() < 2 )
+		return;
+
+	float distance = glm::distance( getTouchPos( 0 ), getTouchPos( 1 ) );
+	if( mStartDistance <= 0 ) {
+		// one of the first two touches ended, start over with the current pair
+		mStartDistance = std::max( distance, 1.0f );
+		return;
+	}
+
+	if( isRecognized() ) {
+		mScale = distance / mStartDistance;
+		setState( GestureState::CHANGED );
+	}
+	else if( fabsf( distance - mStartDistance ) >= mMinDistance ) {
+		mScale = distance / mStartDistance;
+		setState( GestureState::BEGAN );
+	}
+}
+
+void PinchGestureRecognizer::touchesEnded( const vector<app::TouchEvent::Touch> &touches )
+{
+	const auto &ids = getTouchIds();
+	bool pairEnded = containsTouch( touches, ids[0] ) || ( ids.size() > 1 && containsTouch( touches, ids[1] ) );
+	if( ! pairEnded )
+		return;
+
+	if( isRecognized() )
+		setState( GestureState::ENDED );
+	else if( isLastTouches( touches ) )
+		setState( GestureState::FAILED );
+	else
+		mStartDistance = 0;
+}
+
+void PinchGestureRecognizer::reset()
+{
+	mStartDistance = 0;
+	mScale = 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// RotationGestureRecognizer
+// ----------------------------------------------------------------------------------------------------
+
+void RotationGestureRecognizer::touchesBegan( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( getState() == GestureState::POSSIBLE && ! mTracking && getNumTouches() >= 2 ) {
+		mLastAngle = calcAngle();
+		mTracking = true;
+	}
+}
+
+void RotationGestureRecognizer::touchesMoved( const vector<app::TouchEvent::Touch> &touches )
+{
+	if( getNumTouches() < 2 )
+		return;
+
+	float angle = calcAngle();
+	if( ! mTracking ) {
+		mLastAngle = angle;
+		mTracking = true;
+		return;
+	}
+
+	// accumulate the smallest change in angle, so that rotating past +/- pi doesn't wrap
+	float delta = angle - mLastAngle;
+	if( delta > float( M_PI ) )
+		delta -= float( 2 * M_PI );
+	else if( delta < - float( M_PI ) )
+		delta += float( 2 * M_PI );
+
+	mRotation += delta;
+	mLastAngle = angle;
+
+	if( isRecognized() )
+		setState( GestureState::CHANGED );
+	else if( fabsf( mRotation ) >= mMinRotation )
+		setState( GestureState::BEGAN );
+}
+
+void RotationGestureRecognizer::touchesEnded( const vector<app::TouchEvent::Touch> &touches )
+{
+	const auto &ids = getTouchIds();
+	bool pairEnded = containsTouch( touches, ids[0] ) || ( ids.size() > 1 && containsTouch( touches, ids[1] ) );
+	if( ! pairEnded )
+		return;
+
+	if( isRecognized() )
+		setState( GestureState::ENDED );
+	else if( isLastTouches( touches ) )
+		setState( GestureState::FAILED );
+	else
+		mTracking = false;
+}
+
+float RotationGestureRecognizer::calcAngle() const
+{
+	vec2 d = getTouchPos( 1 ) - getTouchPos( 0 );
+	return atan2f( d.y, d.x );
+}
+
+void RotationGestureRecognizer::reset()
+{
+	mRotation = 0;
+	mLastAngle = 0;
+	mTracking = false;
+}
+
+} // namespace vu
@@ -0,0 +1,308 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Export.h"
+
+#include "cinder/app/TouchEvent.h"
+#include "cinder/Signals.h"
+
+#include <memory>
+#include <vector>
+
+namespace vu {
+
+class Graph;
+class View;
+
+typedef std::shared_ptr<class GestureRecognizer>			GestureRecognizerRef;
+typedef std::shared_ptr<class TapGestureRecognizer>			TapGestureRecognizerRef;
+typedef std::shared_ptr<class LongPressGestureRecognizer>	LongPressGestureRecognizerRef;
+typedef std::shared_ptr<class PanGestureRecognizer>			PanGestureRecognizerRef;
+typedef std::shared_ptr<class PinchGestureRecognizer>		PinchGestureRecognizerRef;
+typedef std::shared_ptr<class RotationGestureRecognizer>	RotationGestureRecognizerRef;
+
+//! Recent touch samples for all touches in a Graph, kept in a fixed size ring buffer that is shared by all GestureRecognizers.
+class CI_UI_API TouchHistory {
+  public:
+	struct Sample {
+		uint32_t	mId = 0;
+		ci::vec2	mPos;
+		double		mTime = -1;
+	};
+
+	explicit TouchHistory( size_t capacity = 256 );
+
+	void	beginTouch( uint32_t id, const ci::vec2 &pos, double time );
+	void	addSample( uint32_t id, const ci::vec2 &pos, double time );
+	void	endTouch( uint32_t id, const ci::vec2 &pos, double time );
+
+	//! Returns the sample recorded when touch \a id began, or null if it isn't known.
+	const Sample*	getFirstSample( uint32_t id ) const;
+	//! Returns the most recent sample of touch \a id, or null if it isn't known.
+	const Sample*	getLastSample( uint32_t id ) const;
+	//! Returns the velocity of touch \a id over the last \a duration seconds, in points per second.
+	ci::vec2		calcVelocity( uint32_t id, double duration = 0.1 ) const;
+
+	//! Returns the number of samples currently stored, which is at most the capacity.
+	size_t	getNumSamples() const	{ return mNumSamples; }
+
+  private:
+	struct TouchRecord {
+		Sample	mFirst;
+		Sample	mLast;
+		bool	mActive = false;
+	};
+
+	TouchRecord*		findTouch( uint32_t id );
+	const TouchRecord*	findTouch( uint32_t id ) const;
+
+	std::vector<Sample>			mSamples;
+	size_t						mNextSample = 0;
+	size_t						mNumSamples = 0;
+	std::vector<TouchRecord>	mTouches; // ended touches are kept until the next touch begins, so recognizers can still query them
+};
+
+//! States of a GestureRecognizer. Discrete gestures (ex. tap) go directly from POSSIBLE to ENDED, continuous gestures (ex. pan) go through BEGAN and CHANGED.
+enum class GestureState { POSSIBLE, BEGAN, CHANGED, ENDED, CANCELLED, FAILED };
+
+CI_UI_API const char* gestureStateToString( GestureState state );
+
+//! Base class for recognizing gestures from the touches of a View. Add one to a View with View::addGestureRecognizer(), it is then
+//! run by the Graph with touches that begin within the View (or its subviews), before the touches are dispatched to the View hierarchy.
+//! A recognizer is reset to POSSIBLE once it has ended, been cancelled or failed and all of its touches have ended.
+class CI_UI_API GestureRecognizer : public std::enable_shared_from_this<GestureRecognizer> {
+  public:
+	virtual ~GestureRecognizer() = default;
+
+	GestureState	getState() const		{ return mState; }
+	//! Returns true if the gesture has begun, changed or ended.
+	bool			isRecognized() const;
+
+	void	setEnabled( bool enable = true )	{ mEnabled = enable; }
+	bool	isEnabled() const					{ return mEnabled; }
+
+	//! Returns the View this recognizer is attached to, or null.
+	View*	getView() const		{ return mView; }
+
+	//! Prevents this recognizer from recognizing until \a other has failed, and makes it fail if \a other recognizes. For example, a single tap that requires a double tap to fail.
+	void	requireToFail( const GestureRecognizerRef &other );
+
+	//! Returns the number of touches currently tracked.
+	size_t	getNumTouches() const	{ return mTouchIds.size(); }
+	//! Returns the ids of the touches currently tracked, in the order they began.
+	const std::vector<uint32_t>&	getTouchIds() const	{ return mTouchIds; }
+	//! Returns the centroid of the tracked touches in world coordinates, or the last known centroid if there are none.
+	ci::vec2	getLocation() const;
+	//! Returns getLocation() in the local coordinates of the attached View.
+	ci::vec2	getLocationInView() const;
+
+	//! Emitted when the state changes to BEGAN, CHANGED, ENDED or CANCELLED, and each time a continuous gesture changes.
+	ci::signals::Signal<void ( GestureRecognizer* )>&	getSignalGesture()	{ return mSignalGesture; }
+
+  protected:
+	GestureRecognizer() = default;
+
+	//! Called with the touches that began within the View. The touches are already included in getTouchIds().
+	virtual void	touchesBegan( const std::vector<ci::app::TouchEvent::Touch> &touches )	{}
+	virtual void	touchesMoved( const std::vector<ci::app::TouchEvent::Touch> &touches )	{}
+	//! Called with this recognizer's touches that ended. The touches are removed from getTouchIds() afterwards.
+	virtual void	touchesEnded( const std::vector<ci::app::TouchEvent::Touch> &touches )	{}
+	//! Called once per Graph update while the recognizer is active, for time based gestures.
+	virtual void	update( double currentTime )	{}
+	//! Override to clear gesture specific state, called when the recognizer returns to POSSIBLE.
+	virtual void	reset()		{}
+
+	//! Requests a state transition. BEGAN and ENDED from POSSIBLE are deferred while a recognizer from requireToFail() is still undecided.
+	void	setState( GestureState state );
+
+	//! Returns the Graph's current time.
+	double				getCurrentTime() const;
+	//! Returns the Graph's TouchHistory.
+	const TouchHistory&	getTouchHistory() const;
+	//! Returns the most recent position of the tracked touch at \a index, in world coordinates.
+	ci::vec2			getTouchPos( size_t index ) const;
+	//! Returns the centroid of the tracked touches, not including \a excludedTouches.
+	ci::vec2			calcLocation( const std::vector<ci::app::TouchEvent::Touch> &excludedTouches ) const;
+	//! Returns true if all tracked touches are in \a touches.
+	bool				isLastTouches( const std::vector<ci::app::TouchEvent::Touch> &touches ) const	{ return touches.size() >= mTouchIds.size(); }
+
+  private:
+	bool	isFinished() const;
+	void	transitionTo( GestureState state );
+	void	resolvePendingState();
+	void	resetState();
+
+	View*			mView = nullptr;
+	Graph*			mGraph = nullptr; // set while active
+	GestureState	mState = GestureState::POSSIBLE;
+	GestureState	mPendingState = GestureState::POSSIBLE; // BEGAN or ENDED while waiting on requireToFail() recognizers
+	bool			mEnabled = true;
+	bool			mActive = false;
+	ci::vec2		mLastLocation;
+
+	std::vector<uint32_t>							mTouchIds;
+	std::vector<std::weak_ptr<GestureRecognizer>>	mRequiredToFail;
+
+	ci::signals::Signal<void ( GestureRecognizer* )>	mSignalGesture;
+
+	friend class Graph;
+	friend class View;
+};
+
+//! Recognizes one or more consecutive taps with one or more touches. Discrete.
+class CI_UI_API TapGestureRecognizer : public GestureRecognizer {
+  public:
+	void	setNumTapsRequired( int count )		{ mNumTapsRequired = count; }
+	int		getNumTapsRequired() const			{ return mNumTapsRequired; }
+	void	setNumTouchesRequired( int count )	{ mNumTouchesRequired = count; }
+	int		getNumTouchesRequired() const		{ return mNumTouchesRequired; }
+	//! Sets the maximum seconds a touch can be down and still count as a tap. Default is 0.3.
+	void	setMaxTapDuration( double seconds )		{ mMaxTapDuration = seconds; }
+	//! Sets the maximum seconds between consecutive taps. Default is 0.3.
+	void	setMaxTimeBetweenTaps( double seconds )	{ mMaxTimeBetweenTaps = seconds; }
+	//! Sets how far in points a touch can move and still count as a tap. Default is 10.
+	void	setMaxMovement( float distance )		{ mMaxMovement = distance; }
+
+	//! Returns the number of taps completed so far.
+	int		getTapCount() const		{ return mTapCount; }
+
+  protected:
+	void	touchesBegan( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesMoved( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesEnded( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	update( double currentTime ) override;
+	void	reset() override;
+
+  private:
+	int		mNumTapsRequired = 1;
+	int		mNumTouchesRequired = 1;
+	double	mMaxTapDuration = 0.3;
+	double	mMaxTimeBetweenTaps = 0.3;
+	float	mMaxMovement = 10;
+
+	int		mTapCount = 0;
+	int		mNumTouchesInTap = 0;
+	double	mTapBeganTime = -1;
+	double	mLastTapTime = -1;
+};
+
+//! Recognizes touches held in place for a minimum duration. Continuous, it begins once the duration has passed and changes as the touches move.
+class CI_UI_API LongPressGestureRecognizer : public GestureRecognizer {
+  public:
+	void	setNumTouchesRequired( int count )	{ mNumTouchesRequired = count; }
+	int		getNumTouchesRequired() const		{ return mNumTouchesRequired; }
+	//! Sets the seconds touches need to be held before the gesture begins. Default is 0.5.
+	void	setMinDuration( double seconds )	{ mMinDuration = seconds; }
+	//! Sets how far in points touches can move before the gesture begins. Default is 10.
+	void	setMaxMovement( float distance )	{ mMaxMovement = distance; }
+
+  protected:
+	void	touchesBegan( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesMoved( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesEnded( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	update( double currentTime ) override;
+	void	reset() override;
+
+  private:
+	int		mNumTouchesRequired = 1;
+	double	mMinDuration = 0.5;
+	float	mMaxMovement = 10;
+
+	double	mBeganTime = -1;
+};
+
+//! Recognizes one or more touches dragging. Continuous, it begins once the touches have moved a minimum distance.
+class CI_UI_API PanGestureRecognizer : public GestureRecognizer {
+  public:
+	//! Sets how far in points the touches need to move before the gesture begins. Default is 10.
+	void	setMinDistance( float distance )	{ mMinDistance = distance; }
+	float	getMinDistance() const				{ return mMinDistance; }
+
+	//! Returns the distance the touches' centroid has moved since they began, in points.
+	ci::vec2	getTranslation() const	{ return mTranslation; }
+	//! Returns the average velocity of the touches, in points per second. Retains the value from when the touches ended.
+	ci::vec2	getVelocity() const		{ return mVelocity; }
+
+  protected:
+	void	touchesBegan( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesMoved( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesEnded( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	reset() override;
+
+  private:
+	void	updateVelocity();
+
+	float		mMinDistance = 10;
+	ci::vec2	mTranslation;
+	ci::vec2	mVelocity;
+	ci::vec2	mLastCentroid;
+};
+
+//! Recognizes two touches moving towards or away from each other. Continuous.
+class CI_UI_API PinchGestureRecognizer : public GestureRecognizer {
+  public:
+	//! Sets how far in points the distance between the touches needs to change before the gesture begins. Default is 10.
+	void	setMinDistance( float distance )	{ mMinDistance = distance; }
+
+	//! Returns the distance between the touches relative to when they began.
+	float	getScale() const	{ return mScale; }
+
+  protected:
+	void	touchesBegan( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesMoved( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesEnded( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	reset() override;
+
+  private:
+	float	mMinDistance = 10;
+	float	mStartDistance = 0;
+	float	mScale = 1;
+};
+
+//! Recognizes two touches rotating around each other. Continuous.
+class CI_UI_API RotationGestureRecognizer : public GestureRecognizer {
+  public:
+	//! Sets how far in radians the touches need to rotate before the gesture begins. Default is 0.1.
+	void	setMinRotation( float radians )	{ mMinRotation = radians; }
+
+	//! Returns the rotation of the touches since they began, in radians.
+	float	getRotation() const		{ return mRotation; }
+
+  protected:
+	void	touchesBegan( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesMoved( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	touchesEnded( const std::vector<ci::app::TouchEvent::Touch> &touches ) override;
+	void	reset() override;
+
+  private:
+	float	calcAngle() const;
+
+	float	mMinRotation = 0.1f;
+	float	mRotation = 0;
+	float	mLastAngle = 0;
+	bool	mTracking = false;
+};
+
+} // namespace vu
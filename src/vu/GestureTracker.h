@@ -22,6 +22,8 @@
 */
 
 // Notes:
+// New code should use the GestureRecognizers in GestureRecognizer.h, which are run by the Graph. These trackers are
+// still driven manually from a View's touches handlers (ex. ScrollView).
 // First off, these 'trackers' are not yet in any unified form. For now I'm just adding what useful in moving forward,
 // and planning to rewrite this part when there is more gesture functionality to work with. Current thoughts:
 // - Makes sense to pass in a Responder to the tracker (which is itself a View but we don't need all the View stuff).
@@ -22,8 +22,12 @@
 */
 
 #include "vu/Graph.h"
+#include "vu/ImageCache.h"
+#include "vu/ImageLoader.h"
+#include "vu/Label.h"
 
 #include "cinder/app/AppBase.h"
+#include "cinder/Timer.h"
 #include "vu/Debug.h"
 
 using namespace ci;
@@ -31,6 +35,14 @@ using namespace std;
 
 namespace vu {
 
+namespace {
+
+// Below this many dirty Labels, the overhead of dispatching to worker threads isn't worth it.
+const size_t MIN_LABELS_FOR_PARALLEL_MEASURE = 32;
+const size_t LABELS_PER_MEASURE_TASK = 16;
+
+} // anonymous namespace
+
 Graph::Graph( const ci::app::WindowRef &window )
 	: mWindow( window )
 {
@@ -39,6 +51,11 @@ Graph::Graph( const ci::app::WindowRef &window )
 	// The Graph always gets a Layer because it is root.
 	mLayer = makeLayer( this );
 
+	// Everything that isn't within another InteractionRegion belongs to the Graph's own.
+	mRootRegion.reset( new InteractionRegion( this, this ) );
+	mInteractionRegion = mRootRegion.get();
+	mKeyRegion = mRootRegion.get();
+
 	if( ! mWindow ) {
 		auto app = app::AppBase::get();
 		if( ! app ) {
@@ -55,10 +72,34 @@ Graph::Graph( const ci::app::WindowRef &window )
 
 Graph::~Graph()
 {
+	// Views in the queue may outlive the Graph, make sure they don't try to dequeue themselves later.
+	for( auto view : mLayoutQueue ) {
+		if( ! isRemovedFromLayoutQueue( view ) )
+			view->mLayoutQueued = false;
+	}
+
+	// Same for the root Views of any regions
+	for( const auto &region : mInteractionRegions ) {
+		if( region->mRootView ) {
+			region->mRootView->mInteractionRegion = nullptr;
+			region->mRootView = nullptr;
+		}
+	}
+	mInteractionRegion = nullptr;
 }
 
 void Graph::setNeedsLayer( View *view )
 {
+	// mLayers is shared by the whole Graph, so Layers needed during parallel work are made once it is complete
+	if( currentParallelUpdateTask() || InteractionRegion::getCurrentParallelRegion() ) {
+		auto viewRef = view->shared_from_this();
+		defer( [this, viewRef] {
+			if( ! viewRef->mLayer )
+				makeLayer( viewRef.get() );
+		} );
+		return;
+	}
+
 	makeLayer( view );
 }
 
@@ -100,27 +141,54 @@ void Graph::layout()
 
 void Graph::propagateUpdate()
 {
-	// TODO: see note in Time section on allowing this to be customized.
-	mCurrentTime = app::getElapsedSeconds();
-	mCurrentFrame = app::getElapsedFrames();
+	if( mTimeSource ) {
+		mCurrentTime = mTimeSource();
+		mCurrentFrame++;
+	}
+	else {
+		mCurrentTime = app::getElapsedSeconds();
+		mCurrentFrame = app::getElapsedFrames();
+	}
+
+	// Dispatch touches that were queued since last frame, before anything that depends on touch state
+	mNumTouchesCoalesced = mNumTouchesCoalescedPending;
+	mNumTouchesCoalescedPending = 0;
+	if( mNumQueuedTouchEvents > 0 ) {
+		dispatchQueuedTouches();
+	}
+
+	// Run time based gestures and settle recognizers that were waiting on others
+	if( ! mActiveGestureRecognizers.empty() ) {
+		updateGestureRecognizers();
+	}
 
 	// Check if views should release their intercepting touches
 	// - if yes, will allow subviews a chance at touchesBegan()
-	for( auto viewIt = mViewsWithTouches.begin(); viewIt != mViewsWithTouches.end(); /* */ ) {
-		const auto &view = *viewIt;
-		if( ! view->mInterceptedTouchEvent.getTouches().empty() ) {
-			UI_LOG_TOUCHES( view->getName() << " | updating intercepted touch" );
-			if( handleInterceptingTouches( view, false ) ) {
-				// view has released its intercepted event
-				UI_LOG_TOUCHES( view->getName() << " | erasing." );
-				view->mInterceptedTouchEvent = {};
-				view->mActiveTouches.clear(); // TODO (intercept): only clear touches that have been marked as handled (either by this view or the next one in line)
-				viewIt = mViewsWithTouches.erase( viewIt ); // TODO (intercept): consider marking for removal and erasing later
-				continue;
-			}
-		}
+	updateInterceptingTouches( mRootRegion.get() );
+	for( size_t i = 0; i < mInteractionRegions.size(); i++ ) {
+		auto region = mInteractionRegions[i];
+		updateInterceptingTouches( region.get() );
+	}
 
-		++viewIt;
+	// Upload any asynchronously loaded images, so that ImageViews can pick them up during this update
+	if( mImageLoader ) {
+		mImageLoader->update();
+	}
+	if( mImageCache ) {
+		mImageCache->update();
+	}
+
+	// Measure dirty Labels up front, so that they don't each measure serially during layout
+	if( mParallelTextLayoutEnabled && ! mDirtyLabels.empty() ) {
+		layoutTextInParallel( false );
+	}
+
+	// Lay out all Views that were marked as needing it since last frame
+	processLayoutQueue();
+
+	// Wrapped Labels are measured once they've been given their width
+	if( mParallelTextLayoutEnabled && ! mDirtyLabels.empty() ) {
+		layoutTextInParallel( true );
 	}
 
 	// Update the Layer tree, starting with the root
@@ -140,19 +208,461 @@ void Graph::propagateUpdate()
 	}
 
 	// Remove Views marked for removal
-	mViewsWithTouches.erase(
-			remove_if( mViewsWithTouches.begin(), mViewsWithTouches.end(),
-			           []( const ViewRef &view ) {
-				           return view->mMarkedForRemoval || view->mActiveTouches.empty();
-			           } ),
-			mViewsWithTouches.end() );
+	auto removeViewsWithTouches = []( InteractionRegion *region ) {
+		auto &viewsWithTouches = region->mViewsWithTouches;
+		viewsWithTouches.erase(
+				remove_if( viewsWithTouches.begin(), viewsWithTouches.end(),
+				           []( const ViewRef &view ) {
+					           return view->mMarkedForRemoval || view->mActiveTouches.empty();
+				           } ),
+				viewsWithTouches.end() );
+	};
+
+	removeViewsWithTouches( mRootRegion.get() );
+	for( const auto &region : mInteractionRegions ) {
+		removeViewsWithTouches( region.get() );
+	}
+
+	// Remove regions whose root View has been destroyed
+	for( size_t i = 0; i < mInteractionRegions.size(); /* */ ) {
+		auto region = mInteractionRegions[i];
+		if( ! region->mRootView )
+			removeInteractionRegion( region );
+		else
+			i++;
+	}
+}
+
+void Graph::updateInterceptingTouches( InteractionRegion *region )
+{
+	auto &viewsWithTouches = region->mViewsWithTouches;
+	for( auto viewIt = viewsWithTouches.begin(); viewIt != viewsWithTouches.end(); /* */ ) {
+		const auto &view = *viewIt;
+		if( ! view->mInterceptedTouchEvent.getTouches().empty() ) {
+			UI_LOG_TOUCHES( view->getName() << " | updating intercepted touch" );
+			if( handleInterceptingTouches( region, view, false ) ) {
+				// view has released its intercepted event
+				UI_LOG_TOUCHES( view->getName() << " | erasing." );
+				view->mInterceptedTouchEvent = {};
+				view->mActiveTouches.clear(); // TODO (intercept): only clear touches that have been marked as handled (either by this view or the next one in line)
+				viewIt = viewsWithTouches.erase( viewIt ); // TODO (intercept): consider marking for removal and erasing later
+				continue;
+			}
+		}
+
+		++viewIt;
+	}
 }
 
 void Graph::propagateDraw()
 {
 	CI_ASSERT( getLayer() );
 
+	mRenderer->resetBatchStats();
+	mDrawStats = DrawStats();
 	mLayer->draw( mRenderer.get() );
+	mRenderer->flush();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Layout
+// ----------------------------------------------------------------------------------------------------
+
+void Graph::enqueueLayout( View *view )
+{
+	CI_ASSERT( ! view->mLayoutQueued );
+
+	view->mLayoutQueued = true;
+
+	// During parallel update or touch dispatch each subtree or region queues separately, these are merged in order afterwards.
+	// A new View may have the address of one that was destroyed while queued, so it must no longer be skipped.
+	auto task = currentParallelUpdateTask();
+	auto region = InteractionRegion::getCurrentParallelRegion();
+	if( task || region ) {
+		lock_guard<mutex> lock( mParallelLayoutMutex );
+		mLayoutQueueRemoved.erase( view );
+		if( task )
+			task->mDeferredLayouts.push_back( view );
+		else
+			region->mDeferredLayouts.push_back( view );
+	}
+	else {
+		if( ! mLayoutQueueRemoved.empty() )
+			mLayoutQueueRemoved.erase( view );
+
+		mLayoutQueue.push_back( view );
+	}
+}
+
+void Graph::dequeueLayout( View *view )
+{
+	// Called when a queued View is destroyed. Rather than searching the queues for it, it is skipped when they are
+	// next processed, so that tearing down a large queued subtree stays linear.
+	// Views may also be destroyed on worker threads during parallel update or touch dispatch.
+	unique_lock<mutex> lock( mParallelLayoutMutex, defer_lock );
+	if( mUpdatingInParallel || mDispatchingInParallel )
+		lock.lock();
+
+	view->mLayoutQueued = false;
+	mLayoutQueueRemoved.insert( view );
+}
+
+bool Graph::isRemovedFromLayoutQueue( const View *view ) const
+{
+	return ! mLayoutQueueRemoved.empty() && mLayoutQueueRemoved.count( view ) != 0;
+}
+
+// Each pass processes the queue in batches sorted by depth, so parents are always laid out before their subviews:
+// - measure: bottom-up, so that sizes of subviews are up to date before their parent's Layout arranges them.
+// - arrange: top-down, calling layout() at most once per View. Any subviews that this dirties are handled in the next batch.
+// A View that gets dirtied again after it was laid out (ex. by a subview resizing itself) is deferred until the next frame.
+void Graph::processLayoutQueue()
+{
+	mLayoutPass++;
+	mLayoutStats = LayoutStats();
+	mLayoutStats.mNumQueued = mLayoutQueue.size();
+
+	while( ! mLayoutQueue.empty() ) {
+		mLayoutEntries.clear();
+		for( auto view : mLayoutQueue ) {
+			if( isRemovedFromLayoutQueue( view ) )
+				continue;
+
+			if( ! view->mNeedsLayout ) {
+				view->mLayoutQueued = false;
+				continue;
+			}
+
+			if( view->mLayoutPass == mLayoutPass ) {
+				mLayoutDeferred.push_back( view );
+				mLayoutStats.mNumDeferred++;
+				continue;
+			}
+
+			// Find the depth, skipping Views that are no longer attached to this Graph (they'll be re-queued when they are added again).
+			size_t depth = 0;
+			const View *root = view;
+			while( root->mParent ) {
+				root = root->mParent;
+				depth++;
+			}
+
+			if( root != this ) {
+				view->mLayoutQueued = false;
+				continue;
+			}
+
+			mLayoutEntries.push_back( { view, depth } );
+		}
+		mLayoutQueue.clear();
+
+		stable_sort( mLayoutEntries.begin(), mLayoutEntries.end(), []( const LayoutEntry &a, const LayoutEntry &b ) {
+			return a.mDepth < b.mDepth;
+		} );
+
+		// Views can also be destroyed while their batch is being processed
+		for( auto entryIt = mLayoutEntries.rbegin(); entryIt != mLayoutEntries.rend(); ++entryIt ) {
+			if( ! isRemovedFromLayoutQueue( entryIt->mView ) )
+				entryIt->mView->measure();
+		}
+
+		for( size_t i = 0; i < mLayoutEntries.size(); i++ ) {
+			View *view = mLayoutEntries[i].mView;
+			if( isRemovedFromLayoutQueue( view ) )
+				continue;
+
+			view->mLayoutQueued = false;
+			if( ! view->mNeedsLayout || view->mLayoutPass == mLayoutPass )
+				continue;
+
+			// Filters on the owning Layer need to be reconfigured whenever something within it is laid out.
+			for( View *v = view; v; v = v->mParent ) {
+				if( v->mLayer ) {
+					if( ! v->mFilters.empty() )
+						v->mLayer->setFiltersNeedConfiguration();
+					break;
+				}
+			}
+
+			view->layoutImpl();
+		}
+	}
+
+	mLayoutEntries.clear();
+	mLayoutQueue.swap( mLayoutDeferred );
+
+	// Only deferred Views can still refer to destroyed ones at this point
+	if( ! mLayoutQueueRemoved.empty() ) {
+		mLayoutQueue.erase( remove_if( mLayoutQueue.begin(), mLayoutQueue.end(), [this]( View *view ) {
+			return mLayoutQueueRemoved.count( view ) != 0;
+		} ), mLayoutQueue.end() );
+
+		mLayoutQueueRemoved.clear();
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Parallel Text Layout
+// ----------------------------------------------------------------------------------------------------
+
+WorkerPool* Graph::getWorkerPool()
+{
+	if( ! mWorkerPool ) {
+		mWorkerPool = make_unique<WorkerPool>();
+	}
+
+	return mWorkerPool.get();
+}
+
+ImageLoader* Graph::getImageLoader()
+{
+	if( ! mImageLoader ) {
+		mImageLoader = make_unique<ImageLoader>( getWorkerPool() );
+	}
+
+	return mImageLoader.get();
+}
+
+ImageCache* Graph::getImageCache()
+{
+	if( ! mImageCache ) {
+		mImageCache = make_unique<ImageCache>( getImageLoader() );
+	}
+
+	return mImageCache.get();
+}
+
+ImageRef Graph::renderToImage( View *view, float scale )
+{
+	CI_ASSERT( view );
+	CI_ASSERT( scale > 0 );
+
+	const Rectf bounds = view->getBoundsForFrameBuffer();
+	const ivec2 size = ivec2( glm::ceil( bounds.getSize() * scale ) );
+	if( size.x <= 0 || size.y <= 0 )
+		return nullptr;
+
+	// The FrameBuffer isn't taken from the Renderer's cache, as the returned Image keeps its texture.
+	auto frameBuffer = make_shared<FrameBuffer>( FrameBuffer::Format().size( size ) );
+	auto layer = make_shared<Layer>( view );
+	layer->mGraph = this;
+	layer->drawToFrameBuffer( mRenderer.get(), frameBuffer, bounds, scale );
+
+	return make_shared<Image>( frameBuffer->getColorTexture(), Image::Format().premultiply() );
+}
+
+void Graph::setParallelTextLayoutEnabled( bool enable )
+{
+	if( mParallelTextLayoutEnabled == enable )
+		return;
+
+	mParallelTextLayoutEnabled = enable;
+	if( enable ) {
+		// pick up any Labels that were dirtied before this was enabled
+		collectDirtyLabels( this );
+	}
+	else {
+		for( const auto &weakLabel : mDirtyLabels ) {
+			auto label = weakLabel.lock();
+			if( label )
+				label->mTextLayoutQueued = false;
+		}
+		mDirtyLabels.clear();
+	}
+}
+
+void Graph::queueTextLayout( Label *label )
+{
+	if( label->mTextLayoutQueued )
+		return;
+
+	// the queue is shared by the whole Graph, so Labels dirtied during parallel work are queued once it is complete
+	if( currentParallelUpdateTask() || InteractionRegion::getCurrentParallelRegion() ) {
+		auto labelRef = static_pointer_cast<Label>( label->shared_from_this() );
+		defer( [this, labelRef] { queueTextLayout( labelRef.get() ); } );
+		return;
+	}
+
+	label->mTextLayoutQueued = true;
+	mDirtyLabels.push_back( static_pointer_cast<Label>( label->shared_from_this() ) );
+}
+
+void Graph::collectDirtyLabels( View *view )
+{
+	auto label = dynamic_cast<Label *>( view );
+	if( label && label->mTextLayoutDirty ) {
+		queueTextLayout( label );
+	}
+
+	for( const auto &subview : view->getSubviews() ) {
+		collectDirtyLabels( subview.get() );
+	}
+}
+
+void Graph::layoutTextInParallel( bool afterLayout )
+{
+	// Take the Labels that can be measured now, keeping the rest queued in order
+	mLabelsToMeasure.clear();
+	size_t numStillQueued = 0;
+	for( size_t i = 0; i < mDirtyLabels.size(); i++ ) {
+		auto label = mDirtyLabels[i].lock();
+		if( ! label )
+			continue;
+
+		if( ! afterLayout && label->mWrapEnabled ) {
+			mDirtyLabels[numStillQueued++] = mDirtyLabels[i];
+			continue;
+		}
+
+		label->mTextLayoutQueued = false;
+		if( label->mTextLayoutDirty )
+			mLabelsToMeasure.push_back( label );
+	}
+	mDirtyLabels.resize( numStillQueued );
+
+	if( mLabelsToMeasure.empty() )
+		return;
+
+	// Glyph metrics need to be built on the main thread, this only does work the first time each Text is used.
+	for( const auto &label : mLabelsToMeasure ) {
+		label->mText->buildMetrics();
+	}
+
+	// Measuring only reads Label state, so it is safe to do on the workers while the main thread waits.
+	const size_t numLabels = mLabelsToMeasure.size();
+	mDirtyLabelTextSizes.resize( numLabels );
+	auto measureFn = [this]( size_t i ) {
+		mDirtyLabelTextSizes[i] = mLabelsToMeasure[i]->calcTextSize( true );
+	};
+
+	if( numLabels < MIN_LABELS_FOR_PARALLEL_MEASURE ) {
+		for( size_t i = 0; i < numLabels; i++ )
+			measureFn( i );
+	}
+	else {
+		getWorkerPool()->parallelFor( numLabels, measureFn, LABELS_PER_MEASURE_TASK );
+	}
+
+	// Applying sizes can trigger layout on the main thread, so this is done serially afterwards.
+	for( size_t i = 0; i < numLabels; i++ ) {
+		mLabelsToMeasure[i]->applyTextSize( mDirtyLabelTextSizes[i] );
+	}
+
+	UI_LOG_TEXT( "measured " << numLabels << ( afterLayout ? " Labels after layout" : " Labels" ) );
+	mLabelsToMeasure.clear();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Parallel Update
+// ----------------------------------------------------------------------------------------------------
+
+// static
+Graph::ParallelUpdateTask*& Graph::currentParallelUpdateTask()
+{
+	static thread_local ParallelUpdateTask *sTask = nullptr;
+	return sTask;
+}
+
+bool Graph::isCurrentParallelUpdateRoot( const View *view ) const
+{
+	auto task = currentParallelUpdateTask();
+	return task && task->mRootView == view;
+}
+
+bool Graph::canUpdateInParallel() const
+{
+	return mParallelUpdateEnabled && ! mUpdatingInParallel && ! mDispatchingInParallel;
+}
+
+void Graph::defer( const function<void ()> &fn )
+{
+	auto task = currentParallelUpdateTask();
+	if( task ) {
+		task->mDeferred.push_back( fn );
+		return;
+	}
+
+	auto region = InteractionRegion::getCurrentParallelRegion();
+	if( region ) {
+		region->defer( fn );
+		return;
+	}
+
+	fn();
+}
+
+void Graph::updateInParallel( View *parent, const vector<View *> &subtrees, const function<void ( View * )> &updateFn )
+{
+	// Every subtree reads the parent's world transform, so make sure it is valid beforehand. Invalidating a transform only
+	// marks the View's own subtree, so each subtree calculates its transforms top-down on its own thread as it's updated.
+	parent->validateWorldTransform();
+
+	// created lazily, which must not happen on the worker threads (ex. from ImageView and TiledImageView)
+	getImageLoader();
+
+	const size_t numSubtrees = subtrees.size();
+	mParallelUpdateTasks.resize( numSubtrees );
+	for( size_t i = 0; i < numSubtrees; i++ ) {
+		mParallelUpdateTasks[i].mRootView = subtrees[i];
+	}
+
+	auto finishParallel = [this] {
+		mUpdatingInParallel = false;
+	};
+
+	// parallelFor() runs each chunk on one thread, so limiting the number of chunks limits the number of threads
+	size_t grainSize = 1;
+	if( mMaxParallelUpdateThreads > 0 )
+		grainSize = ( numSubtrees + mMaxParallelUpdateThreads - 1 ) / mMaxParallelUpdateThreads;
+
+	mUpdatingInParallel = true;
+	try {
+		getWorkerPool()->parallelFor( numSubtrees, [this, &subtrees, &updateFn]( size_t i ) {
+			currentParallelUpdateTask() = &mParallelUpdateTasks[i];
+			try {
+				updateFn( subtrees[i] );
+			}
+			catch( ... ) {
+				currentParallelUpdateTask() = nullptr;
+				throw;
+			}
+			currentParallelUpdateTask() = nullptr;
+		}, grainSize );
+	}
+	catch( ... ) {
+		finishParallel();
+		throw;
+	}
+
+	finishParallel();
+
+	// Apply deferred work in subtree order, so the result doesn't depend on which threads ran first.
+	// Deferred functions are moved out first, since the tasks are reused if they lead to another parallel update.
+	vector<function<void ()>> deferred;
+	vector<ViewRef> deferredUpdateLayouts;
+	for( auto &task : mParallelUpdateTasks ) {
+		mLayoutQueue.insert( mLayoutQueue.end(), task.mDeferredLayouts.begin(), task.mDeferredLayouts.end() );
+		task.mDeferredLayouts.clear();
+
+		for( auto &fn : task.mDeferred ) {
+			deferred.push_back( move( fn ) );
+		}
+		task.mDeferred.clear();
+
+		deferredUpdateLayouts.insert( deferredUpdateLayouts.end(), task.mDeferredUpdateLayouts.begin(), task.mDeferredUpdateLayouts.end() );
+		task.mDeferredUpdateLayouts.clear();
+		task.mRootView = nullptr;
+	}
+
+	for( const auto &fn : deferred ) {
+		fn();
+	}
+
+	// Same check as View::updateImpl(), these may have been removed or laid out by a deferred function in the meantime.
+	for( const auto &view : deferredUpdateLayouts ) {
+		if( view->needsLayout() && view->mParent && view->mGraph == this && view->mLayoutPass != mLayoutPass )
+			view->layoutImpl();
+	}
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -177,6 +687,11 @@ double Graph::getCurrentTime() const
 	return mCurrentTime;
 }
 
+void Graph::setTimeSource( const function<double ()> &timeSource )
+{
+	mTimeSource = timeSource;
+}
+
 // ----------------------------------------------------------------------------------------------------
 // Events
 // ----------------------------------------------------------------------------------------------------
@@ -186,36 +701,66 @@ void Graph::connectEvents( const EventOptions &options )
 	mEventSlotPriority = options.mPriority;
 	mEventConnections.clear();
 
+	if( options.mCoalesceTouchesSpecified )
+		setTouchCoalescingEnabled( options.mCoalesceTouches );
+
 	if( options.mMouse ) {
 		mEventConnections += mWindow->getSignalMouseDown().connect( mEventSlotPriority, [&]( app::MouseEvent &event ) {
-			app::TouchEvent touchEvent( event.getWindow(), vector<app::TouchEvent::Touch>( 1, app::TouchEvent::Touch( event.getPos(), vec2( 0 ), 0, 0, &event ) ) );
-			propagateTouchesBegan( touchEvent );
-			event.setHandled( touchEvent.isHandled() );
+			if( mTouchCoalescingEnabled ) {
+				app::TouchEvent::Touch touch( event.getPos(), vec2( 0 ), 0, app::getElapsedSeconds(), nullptr );
+				queueTouches( QueuedTouchType::BEGAN, &touch, 1 );
+			}
+			else {
+				app::TouchEvent touchEvent( event.getWindow(), vector<app::TouchEvent::Touch>( 1, app::TouchEvent::Touch( event.getPos(), vec2( 0 ), 0, app::getElapsedSeconds(), &event ) ) );
+				propagateTouchesBegan( touchEvent );
+				event.setHandled( touchEvent.isHandled() );
+			}
 			mPrevMousePos = event.getPos();
 		} );
 		mEventConnections += mWindow->getSignalMouseDrag().connect( mEventSlotPriority, [&]( app::MouseEvent &event ) {
-			app::TouchEvent touchEvent( event.getWindow(), vector<app::TouchEvent::Touch>( 1, app::TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, 0, &event ) ) );
-			propagateTouchesMoved( touchEvent );
-			event.setHandled( touchEvent.isHandled() );
+			if( mTouchCoalescingEnabled ) {
+				app::TouchEvent::Touch touch( event.getPos(), mPrevMousePos, 0, app::getElapsedSeconds(), nullptr );
+				queueTouches( QueuedTouchType::MOVED, &touch, 1 );
+			}
+			else {
+				app::TouchEvent touchEvent( event.getWindow(), vector<app::TouchEvent::Touch>( 1, app::TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, app::getElapsedSeconds(), &event ) ) );
+				propagateTouchesMoved( touchEvent );
+				event.setHandled( touchEvent.isHandled() );
+			}
 			mPrevMousePos = event.getPos();
 		} );
 		mEventConnections += mWindow->getSignalMouseUp().connect( mEventSlotPriority, [&]( app::MouseEvent &event ) {
-			app::TouchEvent touchEvent( event.getWindow(), vector<app::TouchEvent::Touch>( 1, app::TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, 0, &event ) ) );
-			propagateTouchesEnded( touchEvent );
-			event.setHandled( touchEvent.isHandled() );
+			if( mTouchCoalescingEnabled ) {
+				app::TouchEvent::Touch touch( event.getPos(), mPrevMousePos, 0, app::getElapsedSeconds(), nullptr );
+				queueTouches( QueuedTouchType::ENDED, &touch, 1 );
+			}
+			else {
+				app::TouchEvent touchEvent( event.getWindow(), vector<app::TouchEvent::Touch>( 1, app::TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, app::getElapsedSeconds(), &event ) ) );
+				propagateTouchesEnded( touchEvent );
+				event.setHandled( touchEvent.isHandled() );
+			}
 			mPrevMousePos = event.getPos();
 		} );
 	}
 
 	if( options.mTouches ) {
 		mEventConnections += mWindow->getSignalTouchesBegan().connect( mEventSlotPriority, [&]( app::TouchEvent &event ) {
-			propagateTouchesBegan( event );
+			if( mTouchCoalescingEnabled )
+				queueTouchesBegan( event );
+			else
+				propagateTouchesBegan( event );
 		} );
 		mEventConnections += mWindow->getSignalTouchesMoved().connect( mEventSlotPriority, [&]( app::TouchEvent &event ) {
-			propagateTouchesMoved( event );
+			if( mTouchCoalescingEnabled )
+				queueTouchesMoved( event );
+			else
+				propagateTouchesMoved( event );
 		} );
 		mEventConnections += mWindow->getSignalTouchesEnded().connect( mEventSlotPriority, [&]( app::TouchEvent &event ) {
-			propagateTouchesEnded( event );
+			if( mTouchCoalescingEnabled )
+				queueTouchesEnded( event );
+			else
+				propagateTouchesEnded( event );
 		} );
 	}
 
@@ -234,34 +779,323 @@ void Graph::disconnectEvents()
 	mEventConnections.clear();
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Gestures
+// ----------------------------------------------------------------------------------------------------
+
+// Returns the front-most, deepest interactive View containing pos, or null.
+View* Graph::findGestureView( View *view, const vec2 &pos ) const
+{
+	if( view->isHidden() || ! view->isInteractive() || ! view->isPointInside( view->toLocal( pos ) ) )
+		return nullptr;
+
+	for( auto rIt = view->mSubviews.rbegin(); rIt != view->mSubviews.rend(); ++rIt ) {
+		View *result = findGestureView( rIt->get(), pos );
+		if( result )
+			return result;
+	}
+
+	return view;
+}
+
+void Graph::beginGestureTouches( const vector<app::TouchEvent::Touch> &touches )
+{
+	bool began = false;
+	for( const auto &touch : touches ) {
+		// the touch goes to the recognizers of the View it landed in and all of its ancestors, deepest first
+		for( View *view = findGestureView( this, touch.getPos() ); view; view = view->mParent ) {
+			for( const auto &recognizer : view->mGestureRecognizers ) {
+				if( ! recognizer->mEnabled )
+					continue;
+
+				if( ! recognizer->mActive ) {
+					recognizer->mActive = true;
+					recognizer->mGraph = this;
+					mActiveGestureRecognizers.push_back( recognizer );
+				}
+
+				recognizer->mTouchIds.push_back( touch.getId() );
+				began = true;
+			}
+		}
+	}
+
+	if( began ) {
+		dispatchGestureTouches( &GestureRecognizer::touchesBegan, touches, false );
+	}
+}
+
+void Graph::dispatchGestureTouches( GestureTouchesFn fn, const vector<app::TouchEvent::Touch> &touches, bool ending )
+{
+	// index based, a recognizer's signal may cause Views to begin or end touches
+	for( size_t i = 0; i < mActiveGestureRecognizers.size(); i++ ) {
+		auto recognizer = mActiveGestureRecognizers[i];
+		auto &touchIds = recognizer->mTouchIds;
+
+		mGestureTouches.clear();
+		for( const auto &touch : touches ) {
+			if( find( touchIds.begin(), touchIds.end(), touch.getId() ) != touchIds.end() )
+				mGestureTouches.push_back( touch );
+		}
+
+		if( mGestureTouches.empty() )
+			continue;
+
+		// finished recognizers still track their touches until they end, but no longer process them
+		if( ! recognizer->isFinished() ) {
+			( recognizer.get()->*fn )( mGestureTouches );
+		}
+
+		recognizer->mLastLocation = recognizer->getLocation();
+
+		if( ending ) {
+			for( const auto &touch : mGestureTouches ) {
+				touchIds.erase( remove( touchIds.begin(), touchIds.end(), touch.getId() ), touchIds.end() );
+			}
+		}
+	}
+
+	resolveGestureRecognizers();
+}
+
+void Graph::updateGestureRecognizers()
+{
+	for( size_t i = 0; i < mActiveGestureRecognizers.size(); i++ ) {
+		auto recognizer = mActiveGestureRecognizers[i];
+
+		// cancel recognizers whose View has gone away, without waiting for their touches to end
+		View *view = recognizer->mView;
+		if( ! view || view->mMarkedForRemoval || ! recognizer->mEnabled ) {
+			if( ! recognizer->isFinished() ) {
+				recognizer->mPendingState = GestureState::POSSIBLE;
+				recognizer->transitionTo( recognizer->isRecognized() ? GestureState::CANCELLED : GestureState::FAILED );
+			}
+			recognizer->mTouchIds.clear();
+		}
+		else if( ! recognizer->isFinished() && recognizer->mPendingState == GestureState::POSSIBLE ) {
+			recognizer->update( mCurrentTime );
+		}
+	}
+
+	resolveGestureRecognizers();
+}
+
+void Graph::resolveGestureRecognizers()
+{
+	// Recognizers waiting on others are resolved first, while the ones they depend on still hold their final state
+	for( size_t i = 0; i < mActiveGestureRecognizers.size(); i++ ) {
+		mActiveGestureRecognizers[i]->resolvePendingState();
+	}
+
+	// Reset recognizers that are done and no longer tracking touches
+	for( auto it = mActiveGestureRecognizers.begin(); it != mActiveGestureRecognizers.end(); /* */ ) {
+		const auto &recognizer = *it;
+		if( recognizer->isFinished() && recognizer->mTouchIds.empty() ) {
+			recognizer->resetState();
+			it = mActiveGestureRecognizers.erase( it );
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Touch Coalescing
+// ----------------------------------------------------------------------------------------------------
+
+void Graph::setTouchCoalescingEnabled( bool enable )
+{
+	// don't strand any queued touches
+	if( ! enable && mNumQueuedTouchEvents > 0 ) {
+		dispatchQueuedTouches();
+	}
+
+	mTouchCoalescingEnabled = enable;
+}
+
+void Graph::queueTouches( QueuedTouchType type, const app::TouchEvent::Touch *touches, size_t numTouches )
+{
+	// Moves can be merged with the last queued event if it is also a move, which keeps the order relative to began and ended events.
+	QueuedTouchEvent *lastMoved = nullptr;
+	if( type == QueuedTouchType::MOVED && mNumQueuedTouchEvents > 0 && mQueuedTouchEvents[mNumQueuedTouchEvents - 1].mType == QueuedTouchType::MOVED ) {
+		lastMoved = &mQueuedTouchEvents[mNumQueuedTouchEvents - 1];
+	}
+
+	QueuedTouchEvent *queued = lastMoved;
+	if( ! queued ) {
+		if( mNumQueuedTouchEvents == mQueuedTouchEvents.size() ) {
+			mQueuedTouchEvents.emplace_back();
+		}
+
+		queued = &mQueuedTouchEvents[mNumQueuedTouchEvents++];
+		queued->mType = type;
+		queued->mTouches.clear();
+
+		// keep the buffers of touches that were coalesced last time this entry was used, drop the rest
+		for( auto it = queued->mCoalescedTouches.begin(); it != queued->mCoalescedTouches.end(); ) {
+			if( it->second.empty() )
+				it = queued->mCoalescedTouches.erase( it );
+			else {
+				it->second.clear();
+				++it;
+			}
+		}
+	}
+
+	for( size_t i = 0; i < numTouches; i++ ) {
+		// native events don't outlive the Window's signal, so they aren't kept
+		const auto &touch = touches[i];
+		app::TouchEvent::Touch queuedTouch( touch.getPos(), touch.getPrevPos(), touch.getId(), touch.getTime(), nullptr );
+
+		if( type == QueuedTouchType::MOVED ) {
+			queued->mCoalescedTouches[touch.getId()].push_back( queuedTouch );
+		}
+
+		if( lastMoved ) {
+			auto it = find_if( lastMoved->mTouches.begin(), lastMoved->mTouches.end(), [&touch]( const auto &t ) { return t.getId() == touch.getId(); } );
+			if( it != lastMoved->mTouches.end() ) {
+				// keep the previous position from the first move, so the coalesced move spans all of them
+				*it = app::TouchEvent::Touch( touch.getPos(), it->getPrevPos(), touch.getId(), touch.getTime(), nullptr );
+				mNumTouchesCoalescedPending++;
+				continue;
+			}
+		}
+
+		queued->mTouches.push_back( queuedTouch );
+	}
+}
+
+void Graph::dispatchQueuedTouches()
+{
+	if( ! mDispatchTouchEvent.getWindow() ) {
+		mDispatchTouchEvent = app::TouchEvent( mWindow, vector<app::TouchEvent::Touch>() );
+	}
+
+	// the outer call dispatches anything queued by handlers, ex. if one disables coalescing
+	if( mDispatchingQueuedTouches )
+		return;
+
+	auto finishDispatch = [this] {
+		mCurrentQueuedTouchEvent = nullptr;
+		mDispatchingQueuedTouches = false;
+	};
+
+	mDispatchingQueuedTouches = true;
+	try {
+		// The queue is swapped out before dispatching, so that touches queued by handlers are never coalesced into an event
+		// that was already dispatched. Those are dispatched afterwards, in the order they were queued.
+		while( mNumQueuedTouchEvents > 0 ) {
+			swap( mQueuedTouchEvents, mDispatchingTouchEvents );
+			const size_t numEvents = mNumQueuedTouchEvents;
+			mNumQueuedTouchEvents = 0;
+
+			for( size_t i = 0; i < numEvents; i++ ) {
+				const auto &queued = mDispatchingTouchEvents[i];
+				mCurrentQueuedTouchEvent = &queued;
+				mDispatchTouchEvent.getTouches() = queued.mTouches; // reuses the dispatch event's capacity
+				mDispatchTouchEvent.setHandled( false );
+
+				switch( queued.mType ) {
+					case QueuedTouchType::BEGAN:	propagateTouchesBegan( mDispatchTouchEvent ); break;
+					case QueuedTouchType::MOVED:	propagateTouchesMoved( mDispatchTouchEvent ); break;
+					case QueuedTouchType::ENDED:	propagateTouchesEnded( mDispatchTouchEvent ); break;
+				}
+			}
+		}
+	}
+	catch( ... ) {
+		finishDispatch();
+		throw;
+	}
+
+	finishDispatch();
+}
+
+const vector<app::TouchEvent::Touch>& Graph::getCoalescedTouches( uint32_t touchId ) const
+{
+	static const vector<app::TouchEvent::Touch> sEmpty;
+	if( ! mCurrentQueuedTouchEvent )
+		return sEmpty;
+
+	const auto &coalesced = mCurrentQueuedTouchEvent->mCoalescedTouches;
+	auto it = coalesced.find( touchId );
+	return it != coalesced.end() ? it->second : sEmpty;
+}
+
 void Graph::propagateTouchesBegan( app::TouchEvent &event )
 {
+	ScopedTouchDispatch dispatch( this );
 	mCurrentTouchEvent = event;
-	for( const auto &touch : event.getTouches() )
+	for( const auto &touch : event.getTouches() ) {
 		mActiveTouches[touch.getId()] = touch;
+		mTouchHistory.beginTouch( touch.getId(), touch.getPos(), getTouchTime( touch ) );
+
+		// a touch belongs to the region it began in until it ends
+		InteractionRegion *region = findTouchBeganRegion( touch.getPos() );
+		mTouchRegions[touch.getId()] = region;
+		region->addTouchId( touch.getId() );
+	}
+
+	// GestureRecognizers see the touches before the View hierarchy
+	beginGestureTouches( event.getTouches() );
+
+	if( mInteractionRegions.empty() ) {
+		beginTouches( mRootRegion.get(), event );
+	}
+	else {
+		auto regionEvents = splitTouchesByRegion( event );
+		bool handled = true;
+		event.getTouches().clear();
+		for( auto &regionEvent : regionEvents ) {
+			beginTouches( regionEvent.mRegion.get(), regionEvent.mEvent );
+
+			// pass on the remaining touches, same as with a single region
+			handled = handled && regionEvent.mEvent.isHandled();
+			auto &remaining = regionEvent.mEvent.getTouches();
+			event.getTouches().insert( event.getTouches().end(), remaining.begin(), remaining.end() );
+		}
+
+		event.setHandled( handled );
+	}
+
+	dispatch.finish();
+}
+
+void Graph::beginTouches( InteractionRegion *region, app::TouchEvent &event )
+{
+	if( ! region->mRootView )
+		return;
+
+	region->mCurrentTouchEvent = event;
 
 	size_t numTouchesHandled = 0;
 	ViewRef firstResponder;
-	auto thisRef = shared_from_this();
-	propagateTouchesBegan( thisRef, event, numTouchesHandled, firstResponder );
+	auto rootRef = region->mRootView->shared_from_this();
+	propagateTouchesBegan( region, rootRef, event, numTouchesHandled, firstResponder );
 
-	UI_LOG_RESPONDER( "mFirstResponder: " << ( ! mFirstResponder ? "(none)" : mFirstResponder->getName() )
+	UI_LOG_RESPONDER( "region first responder: " << ( ! region->mFirstResponder ? "(none)" : region->mFirstResponder->getName() )
 		<< ", firstResponder, : " << ( ! firstResponder ? "(none)" : firstResponder->getName() ) );
 	
-	if( mFirstResponder && mFirstResponder != firstResponder ) {
-		Graph::resignFirstResponder(); // TODO: consider renaming this, as View also has a non-virtual resignFirstResponder() method.
+	// only the responder of the region that was touched is resigned, so users in other regions keep theirs
+	if( region->mFirstResponder && region->mFirstResponder != firstResponder ) {
+		region->resignFirstResponder();
 	}
 
 	if( firstResponder ) {
-		setFirstResponder( firstResponder );
+		region->setFirstResponder( firstResponder );
 	}
 }
 
-void Graph::propagateTouchesBegan( const ViewRef &view, app::TouchEvent &event, size_t &numTouchesHandled, ViewRef &firstResponder )
+void Graph::propagateTouchesBegan( InteractionRegion *region, const ViewRef &view, app::TouchEvent &event, size_t &numTouchesHandled, ViewRef &firstResponder )
 {
 	if( view->isHidden() || ! view->isInteractive() )
 		return;
 
+	// Views that are the root of another region only see that region's touches
+	if( view->mInteractionRegion && view->mInteractionRegion != region )
+		return;
+
 	UI_LOG_TOUCHES( view->getName() << " | num touches A: " << event.getTouches().size() );
 
 	vector<app::TouchEvent::Touch> touchesInside;
@@ -300,7 +1134,7 @@ void Graph::propagateTouchesBegan( const ViewRef &view, app::TouchEvent &event,
 		// - Might defer adding but need to think through how the ordering will be handled
 		auto subviews = view->mSubviews;
 		for( auto rIt = subviews.rbegin(); rIt != subviews.rend(); ++rIt ) {
-			propagateTouchesBegan( *rIt, event, numTouchesHandled, firstResponder );
+			propagateTouchesBegan( region, *rIt, event, numTouchesHandled, firstResponder );
 			if( event.isHandled() )
 				return;
 		}
@@ -326,12 +1160,13 @@ void Graph::propagateTouchesBegan( const ViewRef &view, app::TouchEvent &event,
 			touches.end()
 		);
 		
-		if( numTouchesHandledThisView != 0 && find( mViewsWithTouches.begin(), mViewsWithTouches.end(), view ) == mViewsWithTouches.end() ) {
-			mViewsWithTouches.push_back( view );
+		auto &viewsWithTouches = region->mViewsWithTouches;
+		if( numTouchesHandledThisView != 0 && find( viewsWithTouches.begin(), viewsWithTouches.end(), view ) == viewsWithTouches.end() ) {
+			viewsWithTouches.push_back( view );
 		}
 
 		// Allow other app signal connections to respond to the event with remaining touches if not all were handled
-		event.setHandled( numTouchesHandled == mCurrentTouchEvent.getTouches().size() );
+		event.setHandled( numTouchesHandled == region->mCurrentTouchEvent.getTouches().size() );
 
 		UI_LOG_TOUCHES( view->getName() << " | num touches C: " << event.getTouches().size() << ", event handled: " << boolalpha << event.isHandled() << dec );
 	}
@@ -339,23 +1174,61 @@ void Graph::propagateTouchesBegan( const ViewRef &view, app::TouchEvent &event,
 
 void Graph::propagateTouchesMoved( app::TouchEvent &event )
 {
+	ScopedTouchDispatch dispatch( this );
 	mCurrentTouchEvent = event;
-	for( const auto &touch : event.getTouches() )
+	// when dispatching a coalesced move, every move merged into it goes into the history so velocities use the full input rate
+	const bool isCoalesced = &event == &mDispatchTouchEvent;
+	for( const auto &touch : event.getTouches() ) {
 		mActiveTouches[touch.getId()] = touch;
 
-	size_t numTouchesHandled = 0;
+		const auto *coalesced = isCoalesced ? &getCoalescedTouches( touch.getId() ) : nullptr;
+		if( ! coalesced || coalesced->empty() )
+			mTouchHistory.addSample( touch.getId(), touch.getPos(), getTouchTime( touch ) );
+		else {
+			for( const auto &sample : *coalesced )
+				mTouchHistory.addSample( sample.getId(), sample.getPos(), getTouchTime( sample ) );
+		}
+	}
+
+	if( ! mActiveGestureRecognizers.empty() ) {
+		dispatchGestureTouches( &GestureRecognizer::touchesMoved, event.getTouches(), false );
+	}
 
-	for( auto &view : mViewsWithTouches ) {
+	if( mInteractionRegions.empty() ) {
+		moveTouches( mRootRegion.get(), event );
+	}
+	else {
+		auto regionEvents = splitTouchesByRegion( event );
+		if( mParallelTouchDispatchEnabled && regionEvents.size() > 1 && ! mDispatchingInParallel && ! mUpdatingInParallel ) {
+			moveTouchesInParallel( regionEvents );
+		}
+		else {
+			for( auto &regionEvent : regionEvents ) {
+				moveTouches( regionEvent.mRegion.get(), regionEvent.mEvent );
+			}
+		}
+	}
+
+	dispatch.finish();
+}
+
+// Only modifies the region and its Views, so that regions can be dispatched on worker threads.
+void Graph::moveTouches( InteractionRegion *region, app::TouchEvent &event )
+{
+	Timer timer( true );
+	region->mCurrentTouchEvent = event;
+
+	for( auto &view : region->mViewsWithTouches ) {
 		UI_LOG_TOUCHES( view->getName() << " | num touches A: " << event.getTouches().size() );
 
 		// update intercepted touches
 		if( ! view->mInterceptedTouchEvent.getTouches().empty() ) {
 			for( auto &touch : view->mInterceptedTouchEvent.getTouches() ) {
-				auto it = find_if( mCurrentTouchEvent.getTouches().begin(), mCurrentTouchEvent.getTouches().end(),
+				auto it = find_if( region->mCurrentTouchEvent.getTouches().begin(), region->mCurrentTouchEvent.getTouches().end(),
 					[&touch]( const auto &t ) { return touch.getId() == t.getId(); }
 				);
 
-				if( it != mCurrentTouchEvent.getTouches().end() ) {
+				if( it != region->mCurrentTouchEvent.getTouches().end() ) {
 					touch = *it;
 					UI_LOG_TOUCHES( view->getName() << " | intercepted touch updated with id: " << touch.getId() << ", pos: " << touch.getPos() );
 				}
@@ -370,7 +1243,7 @@ void Graph::propagateTouchesMoved( app::TouchEvent &event )
 		// Update active touches
 		if( ! view->mActiveTouches.empty() ) {
 			vector<app::TouchEvent::Touch> touchesContinued;
-			for( const auto &touch : mCurrentTouchEvent.getTouches() ) {
+			for( const auto &touch : region->mCurrentTouchEvent.getTouches() ) {
 				auto it = view->mActiveTouches.find( touch.getId() );
 				if( it == view->mActiveTouches.end() )
 					continue;
@@ -399,28 +1272,72 @@ void Graph::propagateTouchesMoved( app::TouchEvent &event )
 	// Allow other app signal connections to respond to the event with remaining touches if not all were handled
 	// TODO: probably need above commented out for loop to be enabled for this to work
 	//		 - and to also account for intercepted touches
-	//event.setHandled( numTouchesHandled == mCurrentTouchEvent.getTouches().size() );
+	//event.setHandled( numTouchesHandled == region->mCurrentTouchEvent.getTouches().size() );
 
 	//UI_LOG_TOUCHES( "event handled: " << event.isHandled() );
+
+	region->mLastMovedMillis = timer.getSeconds() * 1000.0;
 }
 
 void Graph::propagateTouchesEnded( app::TouchEvent &event, const vu::ViewRef &interceptingView )
 {
+	ScopedTouchDispatch dispatch( this );
 	mCurrentTouchEvent = event; // TODO (intercept): may want to only set this if it isn't an intercepting event
+
+	for( const auto &touch : event.getTouches() ) {
+		mTouchHistory.endTouch( touch.getId(), touch.getPos(), getTouchTime( touch ) );
+	}
+
+	if( ! mActiveGestureRecognizers.empty() ) {
+		dispatchGestureTouches( &GestureRecognizer::touchesEnded, event.getTouches(), true );
+	}
+
+	if( mInteractionRegions.empty() ) {
+		endTouches( mRootRegion.get(), event );
+	}
+	else {
+		auto regionEvents = splitTouchesByRegion( event );
+		for( auto &regionEvent : regionEvents ) {
+			endTouches( regionEvent.mRegion.get(), regionEvent.mEvent );
+		}
+	}
+
+	for( const auto &touch : mCurrentTouchEvent.getTouches() ) {
+		size_t numRemoved = mActiveTouches.erase( touch.getId() );
+		//CI_VERIFY( numRemoved != 0 );
+		if( numRemoved == 0 ) {
+			CI_LOG_W( "stray touch attempted to be removed" );
+		}
+		UI_LOG_TOUCHES( "touch id: " << touch.getId() << ", num removed: " << numRemoved );
+
+		auto regionIt = mTouchRegions.find( touch.getId() );
+		if( regionIt != mTouchRegions.end() ) {
+			regionIt->second->removeTouchId( touch.getId() );
+			mTouchRegions.erase( regionIt );
+		}
+	}
+
+	mCurrentTouchEvent.getTouches().clear();
+	dispatch.finish();
+}
+
+void Graph::endTouches( InteractionRegion *region, app::TouchEvent &event )
+{
+	region->mCurrentTouchEvent = event;
 //	size_t numTouchesHandled = 0;
 
-	for(const auto &view : mViewsWithTouches ) {
+	for(const auto &view : region->mViewsWithTouches ) {
 		UI_LOG_TOUCHES( view->getName() << " | num active touches: " << view->mActiveTouches.size() << ", intercepting touches: " << view->mInterceptedTouchEvent.getTouches().size() );
 
 		// Update touches on view's mInterceptedTouchEvent
 		bool intercepting = false;
 		if( ! view->mInterceptedTouchEvent.getTouches().empty() ) {
 			for( auto &touch : view->mInterceptedTouchEvent.getTouches() ) {
-				auto it = find_if( mCurrentTouchEvent.getTouches().begin(), mCurrentTouchEvent.getTouches().end(),
+				auto it = find_if( region->mCurrentTouchEvent.getTouches().begin(), region->mCurrentTouchEvent.getTouches().end(),
 					[&touch]( const auto &t ) { return touch.getId() == t.getId(); }
 				);
 
-				if( it != mCurrentTouchEvent.getTouches().end() ) {
+				if( it != region->mCurrentTouchEvent.getTouches().end() ) {
 					intercepting = true;
 					touch = *it;
 					UI_LOG_TOUCHES( view->getName() << " | intercepted touch updated with id: " << touch.getId() << ", pos: " << touch.getPos() );
@@ -431,7 +1348,7 @@ void Graph::propagateTouchesEnded( app::TouchEvent &event, const vu::ViewRef &in
 		// Update active touches
 		if( ! view->mActiveTouches.empty() ) {
 			vector<app::TouchEvent::Touch> touchesEnded;
-			for( const auto &touch : mCurrentTouchEvent.getTouches() ) {
+			for( const auto &touch : region->mCurrentTouchEvent.getTouches() ) {
 				auto touchIt = view->mActiveTouches.find( touch.getId() );
 				if( touchIt == view->mActiveTouches.end() )
 					continue;
@@ -453,28 +1370,19 @@ void Graph::propagateTouchesEnded( app::TouchEvent &event, const vu::ViewRef &in
 
 			// - if the view is intercepting a touch, then updateViewsInterceptingTouches() will clear it later
 			if( intercepting ) {
-				handleInterceptingTouches( view, true );
+				handleInterceptingTouches( region, view, true );
 				//view->mInterceptedTouchEvent = {};
 			}
 		}
 	}
 
-	for( const auto &touch : mCurrentTouchEvent.getTouches() ) {
-		size_t numRemoved = mActiveTouches.erase( touch.getId() );
-		//CI_VERIFY( numRemoved != 0 );
-		if( numRemoved == 0 ) {
-			CI_LOG_W( "stray touch attempted to be removed" );
-		}
-		UI_LOG_TOUCHES( "touch id: " << touch.getId() << ", num removed: " << numRemoved );
-	}
-
-	mCurrentTouchEvent.getTouches().clear();
+	region->mCurrentTouchEvent.getTouches().clear();
 }
 
-// If eventEnding is true, will call propagateTouchesEnded(). Otherwise, released touches will allow subviews a chance at touchesBegan
-// Returns true if view should be erased from mViewsWithTouches and the intercepted event was released.
+// If eventEnding is true, will call endTouches(). Otherwise, released touches will allow subviews a chance at touchesBegan
+// Returns true if view should be erased from the region's Views with touches and the intercepted event was released.
 // TODO (intercept): call this from touchesMoved() too
-bool Graph::handleInterceptingTouches( const ViewRef &view, bool eventEnding )
+bool Graph::handleInterceptingTouches( InteractionRegion *region, const ViewRef &view, bool eventEnding )
 {
 	if( view->shouldStopInterceptingTouches( view->mInterceptedTouchEvent ) ) {
 		// if the view claimed ownership of any touches, make it handle a touchesMoved()
@@ -493,7 +1401,7 @@ bool Graph::handleInterceptingTouches( const ViewRef &view, bool eventEnding )
 			UI_LOG_TOUCHES( "\t- touches claimed: " << handledTouches.size() );
 			auto claimedEvent = view->mInterceptedTouchEvent;
 			claimedEvent.getTouches() = handledTouches;
-			propagateTouchesMoved( claimedEvent );
+			moveTouches( region, claimedEvent );
 		}
 
 		// TODO (intercept): I think this doesn't work well if a view tries to give the touch to children but no one takes it
@@ -515,7 +1423,7 @@ bool Graph::handleInterceptingTouches( const ViewRef &view, bool eventEnding )
 			ViewRef firstResponder;
 			auto subviews = view->mSubviews;
 			for( auto rIt = subviews.rbegin(); rIt != subviews.rend(); ++rIt ) {
-				propagateTouchesBegan( *rIt, beganEvent, numTouchesHandled, firstResponder );
+				propagateTouchesBegan( region, *rIt, beganEvent, numTouchesHandled, firstResponder );
 				if( beganEvent.isHandled() )
 					break;
 			}
@@ -533,7 +1441,7 @@ bool Graph::handleInterceptingTouches( const ViewRef &view, bool eventEnding )
 			// If a subview handled the event from the intercepting view's touchesEnded, subview also gets a touchesEnded
 			if( eventEnding ) {
 				UI_LOG_TOUCHES( "\t- touches ending: " << endedEvent.getTouches().size() );
-				propagateTouchesEnded( endedEvent, view );
+				endTouches( region, endedEvent );
 			}
 			return true;
 		}
@@ -542,110 +1450,225 @@ bool Graph::handleInterceptingTouches( const ViewRef &view, bool eventEnding )
 	return false;
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Responder
+// ----------------------------------------------------------------------------------------------------
+
+// Hardware keys go to the region where a first responder was most recently set.
 void Graph::propagateKeyDown( ci::app::KeyEvent &event )
 {
-	if( mFirstResponder ) {
-		// tab / shift-tab to navigate next and previous responders
-		if( event.getCode() == app::KeyEvent::KEY_TAB ) {
-			if( event.isShiftDown() ) {
-				moveToPreviousResponder();
-			}
-			else {
-				moveToNextResponder();
-			}
-		}
-		else {
-			if( mFirstResponder->keyDown( event ) )
-				event.setHandled();
-		}
-	}
+	mKeyRegion->propagateKeyDown( event );
 	//auto thisRef = shared_from_this();
 	//propagateKeyDown( thisRef, event );
 }
 
 void Graph::propagateKeyUp( ci::app::KeyEvent &event )
 {
-	if( mFirstResponder ) {
-		if( mFirstResponder->keyUp( event ) )
-			event.setHandled();
-	}
+	mKeyRegion->propagateKeyUp( event );
 	//auto thisRef = shared_from_this();
 	//propagateKeyUp( thisRef, event );
 }
 
-// TODO: refactor, this is pretty kludgy in that it was moved from the ad-hoc Responder class that will soon be removed.
 void Graph::setFirstResponder( const ViewRef &view )
 {
-	UI_LOG_RESPONDER( "view: " << view->getName() << ", current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) );
-	if( view->willBecomeFirstResponder() ) {
-		if( mFirstResponder && mFirstResponder != view ) {
-			UI_LOG_RESPONDER( "\t\t- resigning first responder." );
-			mFirstResponder->willResignFirstResponder(); // TODO: should this return false here if mFirstResponder returns false?
-		}
-
-		auto previousFirstResponder = mFirstResponder;
-		mFirstResponder = view;
-		mPreviousFirstResponder = previousFirstResponder;
-	}
-	else {
-		// if view declines to become first responder, try the next in the chain.
-		CI_LOG_I( "\t- view declined first responder: " << view->getName() );
-		if( view->getNextResponder() ) {
-			setFirstResponder( view->getNextResponder() );
-		}
-	}
+	findInteractionRegion( view.get() )->setFirstResponder( view );
 }
 
 void Graph::moveToNextResponder()
 {
-	UI_LOG_RESPONDER( "current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) );
-	if( ! mFirstResponder )
+	mKeyRegion->moveToNextResponder();
+}
+
+void Graph::moveToPreviousResponder()
+{
+	mKeyRegion->moveToPreviousResponder();
+}
+
+void Graph::resignFirstResponder()
+{
+	mKeyRegion->resignFirstResponder();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Interaction Regions
+// ----------------------------------------------------------------------------------------------------
+
+InteractionRegionRef Graph::addInteractionRegion( const ViewRef &rootView )
+{
+	CI_ASSERT( rootView );
+
+	if( rootView->mInteractionRegion )
+		throw GraphExc( "View '" + rootView->getName() + "' is already the root of an InteractionRegion" );
+
+	InteractionRegionRef region( new InteractionRegion( this, rootView.get() ) );
+	rootView->mInteractionRegion = region.get();
+	mInteractionRegions.push_back( region );
+	return region;
+}
+
+void Graph::removeInteractionRegion( const InteractionRegionRef &region )
+{
+	CI_ASSERT( ! mDispatchingInParallel );
+
+	auto it = find( mInteractionRegions.begin(), mInteractionRegions.end(), region );
+	if( it == mInteractionRegions.end() )
 		return;
 
-	// find the next responder willing to accept responder status
-	auto nextResponder = mFirstResponder->getNextResponder();
-	while( nextResponder ) {
-		UI_LOG_RESPONDER( "\t- next responder: " << nextResponder->getName() << ", accepts first responder: " << nextResponder->getAcceptsFirstResponder() );
+	// hand over active touches so that they still end normally
+	auto rootRegion = mRootRegion.get();
+	for( uint32_t id : region->mTouchIds ) {
+		mTouchRegions[id] = rootRegion;
+		rootRegion->addTouchId( id );
+	}
+	rootRegion->mViewsWithTouches.splice( rootRegion->mViewsWithTouches.end(), region->mViewsWithTouches );
+	region->mTouchIds.clear();
 
-		if( nextResponder->getAcceptsFirstResponder() )
-			break;
+	region->resignFirstResponder();
+	if( mKeyRegion == region.get() )
+		mKeyRegion = rootRegion;
 
-		nextResponder = nextResponder->getNextResponder();
+	if( region->mRootView ) {
+		region->mRootView->mInteractionRegion = nullptr;
+		region->mRootView = nullptr;
 	}
 
-	if( nextResponder ) {
-		setFirstResponder( nextResponder );
+	mInteractionRegions.erase( it );
+}
+
+InteractionRegion* Graph::findInteractionRegion( const View *view ) const
+{
+	for( ; view; view = view->mParent ) {
+		if( view->mInteractionRegion )
+			return view->mInteractionRegion;
 	}
-	else {
-		UI_LOG_RESPONDER( "\t- no next responder, resigning current." );
-		resignFirstResponder();
+
+	return mRootRegion.get();
+}
+
+InteractionRegion* Graph::findTouchBeganRegion( const vec2 &pos )
+{
+	// without any added regions every touch belongs to the Graph's own region, so there's no need to hit test
+	if( mInteractionRegions.empty() )
+		return mRootRegion.get();
+
+	View *view = findGestureView( this, pos );
+	return view ? findInteractionRegion( view ) : mRootRegion.get();
+}
+
+InteractionRegion* Graph::findTouchRegion( uint32_t touchId ) const
+{
+	auto it = mTouchRegions.find( touchId );
+	return it != mTouchRegions.end() ? it->second : mRootRegion.get();
+}
+
+// Splits event by the region that each touch belongs to, starting with the Graph's own region and then in the order regions were added.
+vector<Graph::RegionTouchEvent> Graph::splitTouchesByRegion( const app::TouchEvent &event ) const
+{
+	vector<RegionTouchEvent> result;
+
+	auto addRegion = [&]( const InteractionRegionRef &region ) {
+		RegionTouchEvent *regionEvent = nullptr;
+		for( const auto &touch : event.getTouches() ) {
+			if( findTouchRegion( touch.getId() ) != region.get() )
+				continue;
+
+			if( ! regionEvent ) {
+				result.push_back( { region, app::TouchEvent( event.getWindow(), vector<app::TouchEvent::Touch>() ) } );
+				regionEvent = &result.back();
+			}
+
+			regionEvent->mEvent.getTouches().push_back( touch );
+		}
+	};
+
+	addRegion( mRootRegion );
+	for( const auto &region : mInteractionRegions ) {
+		addRegion( region );
 	}
+
+	return result;
 }
 
-void Graph::moveToPreviousResponder()
+void Graph::moveTouchesInParallel( vector<RegionTouchEvent> &regionEvents )
 {
-	UI_LOG_RESPONDER( "current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) << ", previous first responder: " <<  ( mPreviousFirstResponder ? mPreviousFirstResponder->getName() : "(none)" ) );
-	
-	// FIXME: this isn't good enough, only goes back one level
-	// - this also needs to resign the current responder
-	auto previousFirstResponder = mPreviousFirstResponder.lock();
-	if( previousFirstResponder ) {
-		setFirstResponder( previousFirstResponder );
+	// Make sure the world transforms of region roots are up to date, they stay that way until all regions are complete (see View::setWorldPosDirty()).
+	// Each region's thread then only calculates transforms beneath its root, and never reads the root's ancestors.
+	for( const auto &regionEvent : regionEvents ) {
+		if( regionEvent.mRegion->mRootView )
+			regionEvent.mRegion->mRootView->validateWorldTransform();
+	}
+
+	mDispatchingInParallel = true;
+
+	auto finishParallel = [this] {
+		mDispatchingInParallel = false;
+	};
+
+	try {
+		getWorkerPool()->parallelFor( regionEvents.size(), [this, &regionEvents]( size_t i ) {
+			auto &regionEvent = regionEvents[i];
+			InteractionRegion::setCurrentParallelRegion( regionEvent.mRegion.get() );
+			try {
+				moveTouches( regionEvent.mRegion.get(), regionEvent.mEvent );
+			}
+			catch( ... ) {
+				InteractionRegion::setCurrentParallelRegion( nullptr );
+				throw;
+			}
+			InteractionRegion::setCurrentParallelRegion( nullptr );
+		} );
+	}
+	catch( ... ) {
+		finishParallel();
+		throw;
+	}
+
+	finishParallel();
+
+	// Merge anything that affects the whole Graph in region order, so the result doesn't depend on which threads ran first
+	for( auto &regionEvent : regionEvents ) {
+		auto region = regionEvent.mRegion.get();
+		mLayoutQueue.insert( mLayoutQueue.end(), region->mDeferredLayouts.begin(), region->mDeferredLayouts.end() );
+		region->mDeferredLayouts.clear();
+
+		if( region->mBecameKeyRegion ) {
+			region->mBecameKeyRegion = false;
+			mKeyRegion = region;
+		}
 	}
 }
 
-void Graph::resignFirstResponder()
+// Calls functions deferred by regions once the outermost touch dispatch is complete, since they may dispatch touches too.
+void Graph::finishTouchDispatch()
 {
-	UI_LOG_RESPONDER( "current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) );
-	if( ! mFirstResponder )
+	CI_ASSERT( mTouchDispatchDepth > 0 );
+	if( --mTouchDispatchDepth > 0 )
 		return;
 
-	UI_LOG_RESPONDER( "\t- resigning current responder." );
-	if( mFirstResponder->getParent() ) {
-		mPreviousFirstResponder = mFirstResponder;
+	mRootRegion->callDeferred();
+	for( size_t i = 0; i < mInteractionRegions.size(); i++ ) {
+		auto region = mInteractionRegions[i];
+		region->callDeferred();
 	}
-	mFirstResponder->willResignFirstResponder();
-	mFirstResponder = nullptr;
+}
+
+Graph::ScopedTouchDispatch::ScopedTouchDispatch( Graph *graph )
+	: mGraph( graph )
+{
+	mGraph->mTouchDispatchDepth++;
+}
+
+Graph::ScopedTouchDispatch::~ScopedTouchDispatch()
+{
+	// when unwinding from a handler, functions that were deferred are called at the end of the next dispatch instead
+	if( ! mFinished )
+		mGraph->mTouchDispatchDepth--;
+}
+
+void Graph::ScopedTouchDispatch::finish()
+{
+	mFinished = true;
+	mGraph->finishTouchDispatch();
 }
 
 #if 0
@@ -22,13 +22,20 @@
 #pragma once
 
 #include "vu/Renderer.h"
+#include "vu/GestureRecognizer.h"
+#include "vu/Image.h"
+#include "vu/InteractionRegion.h"
 #include "vu/Layer.h"
 #include "vu/View.h"
+#include "vu/WorkerPool.h"
 
 #include "cinder/Cinder.h"
 #include "cinder/Exception.h"
 #include "cinder/Signals.h"
 
+#include <mutex>
+#include <unordered_set>
+
 namespace cinder { namespace app {
 
 typedef std::shared_ptr<class Window>   WindowRef;
@@ -40,6 +47,10 @@ namespace vu {
 typedef std::shared_ptr<class Graph>	GraphRef;
 typedef std::shared_ptr<class View>		ViewRef;
 
+class ImageCache;
+class ImageLoader;
+class Label;
+
 //! This is where it all starts! Construct a Graph as the root of your UI scene graph, add other views to it.
 class CI_UI_API Graph : public View {
   public:
@@ -66,7 +77,7 @@ class CI_UI_API Graph : public View {
 	void propagateKeyDown( ci::app::KeyEvent &event );
 	void propagateKeyUp( ci::app::KeyEvent &event );
 
-	//! Sets the View that current receives Responder events (ex. keys)
+	//! Sets the View that current receives Responder events (ex. keys), within the InteractionRegion that it belongs to.
 	void setFirstResponder( const ViewRef &view );
 	//! Moves to the next responder in the responder chain if there is one, resigning any current responder.
 	void moveToNextResponder();
@@ -74,8 +85,27 @@ class CI_UI_API Graph : public View {
 	void moveToPreviousResponder();
 	//! Resigns current View that receives Responder events, ex. when Esc or Return keys are hit.
 	void resignFirstResponder();
-	//! Returns the View that currently receives first responder status
-	 const ViewRef&	getFirstResponder() const	{ return mFirstResponder; }
+	//! Returns the View that currently receives key events, which is the first responder of the InteractionRegion where one was most recently set.
+	 const ViewRef&	getFirstResponder() const	{ return mKeyRegion->getFirstResponder(); }
+
+	//! Makes \a rootView and its subviews an InteractionRegion, with its own touches and first responder. \a rootView can't already be the root of a region.
+	//! \note The Graph keeps the region until it is removed or \a rootView is destroyed.
+	InteractionRegionRef	addInteractionRegion( const ViewRef &rootView );
+	//! Removes \a region. Any touches that it currently has are handed over to the Graph's own region, so they end normally.
+	void					removeInteractionRegion( const InteractionRegionRef &region );
+	//! Returns the regions added with addInteractionRegion(), in the order they were added.
+	const std::vector<InteractionRegionRef>&	getInteractionRegions() const	{ return mInteractionRegions; }
+	//! Returns the Graph's own region, which has everything that isn't within a region added with addInteractionRegion().
+	InteractionRegion*		getRootInteractionRegion() const	{ return mRootRegion.get(); }
+	//! Returns the region that \a view belongs to, which is the closest ancestor (or itself) that is the root of a region.
+	InteractionRegion*		findInteractionRegion( const View *view ) const;
+
+	//! Enables dispatching touch moves for different InteractionRegions in parallel on the WorkerPool. Touches began and ended are still dispatched serially. Default is false.
+	//! \note While enabled, touchesMoved() may be called on worker threads and must only modify Views within the same region, anything else should use InteractionRegion::defer().
+	//! The world transforms of region roots aren't recalculated until all regions have been dispatched, so moving a region's root View is only reflected in toWorld() and toLocal() afterwards. Views within a region are unaffected.
+	void	setParallelTouchDispatchEnabled( bool enable = true )	{ mParallelTouchDispatchEnabled = enable; }
+	//! Returns whether touch moves for different InteractionRegions are dispatched in parallel.
+	bool	isParallelTouchDispatchEnabled() const					{ return mParallelTouchDispatchEnabled; }
 
 	struct EventOptions {
 		EventOptions() {}
@@ -84,11 +114,15 @@ class CI_UI_API Graph : public View {
 		EventOptions& touches( bool enable = true )		{ mTouches = enable; return *this; }
 		EventOptions& keyboard( bool enable = true )	{ mKeyboard = enable; return *this; }
 		EventOptions& priority( int priority )			{ mPriority = priority; return *this; }
+		//! Queues mouse and touch events and dispatches them once per propagateUpdate(), see setTouchCoalescingEnabled(). If not specified, the current setting is kept.
+		EventOptions& coalesceTouches( bool enable = true )	{ mCoalesceTouches = enable; mCoalesceTouchesSpecified = true; return *this; }
 
 	  private:
 		bool	mMouse		= true;
 		bool	mTouches	= true;
 		bool	mKeyboard	= true;
+		bool	mCoalesceTouches = false;
+		bool	mCoalesceTouchesSpecified = false;
 		int		mPriority	= -1;
 
 		friend class Graph;
@@ -103,20 +137,106 @@ class CI_UI_API Graph : public View {
 	const std::map<uint32_t, ci::app::TouchEvent::Touch>&  getAllTouchesInWindow() const   { return mActiveTouches; }
 	//! Returns the current TouchEvent, if one is currently being processed.
 	const ci::app::TouchEvent&  getCurrentTouchEvent() const    { return mCurrentTouchEvent; }
-	//! Returns all Views that currently have active touches.
-	const std::list<ViewRef>&	    getViewsWithTouches() const { return mViewsWithTouches; }
+	//! Returns all Views that currently have active touches, outside of any InteractionRegion added with addInteractionRegion().
+	const std::list<ViewRef>&	    getViewsWithTouches() const { return mRootRegion->getViewsWithTouches(); }
+
+	//! Enables queuing touches from connectEvents() and the queueTouches*() methods, which are then dispatched once at the start of propagateUpdate().
+	//! Consecutive moves of the same touch are coalesced into one, so dispatch cost is bounded by the frame rate rather than the input rate. Default is false.
+	//! \note Queued mouse events can't be marked as handled, since they are dispatched after the Window's signal has returned.
+	void	setTouchCoalescingEnabled( bool enable = true );
+	//! Returns whether touches are queued and coalesced until the next propagateUpdate().
+	bool	isTouchCoalescingEnabled() const	{ return mTouchCoalescingEnabled; }
+	//! Queues \a event's touches to be dispatched with propagateTouchesBegan() at the next propagateUpdate().
+	void	queueTouchesBegan( const ci::app::TouchEvent &event )	{ queueTouches( QueuedTouchType::BEGAN, event.getTouches().data(), event.getTouches().size() ); }
+	//! Queues \a event's touches to be dispatched with propagateTouchesMoved() at the next propagateUpdate(), coalescing them with already queued moves.
+	void	queueTouchesMoved( const ci::app::TouchEvent &event )	{ queueTouches( QueuedTouchType::MOVED, event.getTouches().data(), event.getTouches().size() ); }
+	//! Queues \a event's touches to be dispatched with propagateTouchesEnded() at the next propagateUpdate().
+	void	queueTouchesEnded( const ci::app::TouchEvent &event )	{ queueTouches( QueuedTouchType::ENDED, event.getTouches().data(), event.getTouches().size() ); }
+	//! Returns every move of \a touchId that was merged into the move being dispatched, oldest first. Useful for velocity tracking at the full input rate.
+	//! Only valid during touchesMoved() while touch coalescing is enabled, otherwise it is empty.
+	const std::vector<ci::app::TouchEvent::Touch>&	getCoalescedTouches( uint32_t touchId ) const;
+	//! Returns the number of touch moves that were merged into other moves during the last propagateUpdate().
+	size_t	getNumTouchesCoalesced() const		{ return mNumTouchesCoalesced; }
+
+	//! Returns the recent touch samples shared by all GestureRecognizers. Samples are timestamped with each touch's own time (falling back to getCurrentTime() for touches without one), and include every coalesced move.
+	const TouchHistory&	getTouchHistory() const		{ return mTouchHistory; }
+	//! Returns the number of GestureRecognizers that are currently tracking touches or waiting to decide.
+	size_t	getNumActiveGestureRecognizers() const	{ return mActiveGestureRecognizers.size(); }
 
 	//! Sets the size used for clipping operations.
 	void setClippingSize( const ci::ivec2 &size );
 	//! Returns the size used for clipping operations. Defaults to the size of the window
 	ci::ivec2 getClippingSize() const;
 
+	//! Counters for the layout pass of the current frame.
+	struct LayoutStats {
+		size_t	mNumQueued		= 0;	//! Number of Views that were in the layout queue at the start of the frame.
+		size_t	mNumLayouts		= 0;	//! Number of View::layout() calls, including those outside of the layout pass.
+		size_t	mNumDeferred	= 0;	//! Number of Views that needed layout again after already being laid out, which were deferred to the next frame.
+	};
+
+	//! Returns the layout counters for the current frame.
+	const LayoutStats&	getLayoutStats() const	{ return mLayoutStats; }
+
+	//! Counters for the most recent draw.
+	struct DrawStats {
+		size_t	mNumViewsDrawn		= 0;	//! Number of Views whose draw() was called (or were drawn from a raster).
+		size_t	mNumViewsCulled		= 0;	//! Number of Views outside of the window, FrameBuffer or clipping ancestor. A View whose clip is outside counts once for its subtree.
+		size_t	mNumViewsOccluded	= 0;	//! Number of Views (and their subtrees) skipped because an opaque sibling covers them.
+	};
+
+	//! Returns the draw counters for the most recent call to propagateDraw().
+	const DrawStats&	getDrawStats() const	{ return mDrawStats; }
+
+	//! Enables skipping Views that can't be seen, either because they are outside of the window or a clipping ancestor, or covered by an opaque sibling (see View::setOpaque()). Default is true.
+	void	setCullingEnabled( bool enable = true )	{ mCullingEnabled = enable; }
+	//! Returns whether Views that can't be seen are skipped when drawing.
+	bool	isCullingEnabled() const				{ return mCullingEnabled; }
+
+	//! Returns the WorkerPool used for processing work off of the main thread. It is created on first use.
+	WorkerPool*	getWorkerPool();
+
+	//! Returns the ImageLoader used for loading Images asynchronously, which uploads a limited amount of image data each frame. It is created on first use.
+	ImageLoader*	getImageLoader();
+	//! Returns the ImageCache shared by ImageViews that draw image files (see ImageView::setImageFile()). It is created on first use.
+	ImageCache*		getImageCache();
+
+	//! Draws \a view and its subviews offscreen into a new Image, at \a scale times their size. Returns null if \a view has no size.
+	//! The Image is premultiplied and doesn't include \a view's position or its Layer's alpha. Must be called with the Graph's GL context current, after the Graph has been updated.
+	ImageRef	renderToImage( View *view, float scale = 1 );
+	//! Draws \a view and its subviews offscreen into a new Image, at \a scale times their size.
+	ImageRef	renderToImage( const ViewRef &view, float scale = 1 )	{ return renderToImage( view.get(), scale ); }
+
+	//! Enables measuring all dirty Labels in parallel on the WorkerPool before each layout pass. Default is false.
+	//! \note When enabled, Labels are measured with Text's CPU-side glyph metrics, which do not account for kerning.
+	//! \note Wrapped Labels depend on the width they are given, so they are measured after the layout pass instead.
+	void	setParallelTextLayoutEnabled( bool enable = true );
+	//! Returns whether dirty Labels are measured in parallel before each layout pass.
+	bool	isParallelTextLayoutEnabled() const		{ return mParallelTextLayoutEnabled; }
+
+	//! Enables updating independent subtrees (see View::setIndependentUpdateEnabled()) in parallel on the WorkerPool. Default is false.
+	//! \note Subtrees within a Layer that renders to a FrameBuffer are still updated serially.
+	void	setParallelUpdateEnabled( bool enable = true )	{ mParallelUpdateEnabled = enable; }
+	//! Returns whether independent subtrees are updated in parallel.
+	bool	isParallelUpdateEnabled() const					{ return mParallelUpdateEnabled; }
+	//! Limits the number of threads (including the calling thread) that independent subtrees are updated on, ex. to measure how the update scales. Default is 0, which uses all of the WorkerPool's threads.
+	void	setMaxParallelUpdateThreads( size_t numThreads )	{ mMaxParallelUpdateThreads = numThreads; }
+	//! Returns the maximum number of threads that independent subtrees are updated on, or 0 if there is no limit.
+	size_t	getMaxParallelUpdateThreads() const					{ return mMaxParallelUpdateThreads; }
+	//! Calls \a fn once the parallel work that the calling thread is part of is complete, ex. to add or remove Views outside of an independent subtree from its update().
+	//! Deferred functions are called on the thread that started the work, in the order of the subtrees or InteractionRegions that deferred them. Otherwise \a fn is called immediately.
+	void	defer( const std::function<void ()> &fn );
+
 	//!
 	double	getTargetFrameRate() const;
 	//!
 	size_t	getCurrentFrame() const;
 	//!
 	double	getCurrentTime() const;
+	//! Sets a function that returns the time used by propagateUpdate() instead of the app's elapsed seconds. The frame count is then incremented once per update. Pass in null to use the app's clock again.
+	void	setTimeSource( const std::function<double ()> &timeSource );
+	//! Returns whether the Graph's time is provided by setTimeSource().
+	bool	hasTimeSource() const	{ return (bool)mTimeSource; }
 
   protected:
 	void layout() override;
@@ -124,10 +244,81 @@ class CI_UI_API Graph : public View {
   private:
 	LayerRef makeLayer( View *rootView );
 
-	void propagateTouchesBegan( const ViewRef &view, ci::app::TouchEvent &event, size_t &numTouchesHandled, ViewRef &firstResponder );
+	void enqueueLayout( View *view );
+	void dequeueLayout( View *view );
+	bool isRemovedFromLayoutQueue( const View *view ) const;
+	void processLayoutQueue();
+
+	//! Measures the queued Labels in parallel. Before layout, wrapped Labels are left in the queue since their width isn't known yet.
+	void layoutTextInParallel( bool afterLayout );
+	//! Called by Label when its text needs to be measured, or when it is added to the Graph with dirty text.
+	void queueTextLayout( Label *label );
+	void collectDirtyLabels( View *view );
+
+	// Work from an independent subtree that is being updated on a worker thread, applied in subtree order afterwards.
+	struct ParallelUpdateTask {
+		View*								mRootView = nullptr;
+		std::vector<std::function<void ()>>	mDeferred;
+		std::vector<View *>					mDeferredLayouts;
+		std::vector<ViewRef>				mDeferredUpdateLayouts;	// Views that View::updateImpl() would have laid out, laid out on the main thread afterwards
+	};
+
+	//! Returns the task for the subtree that the calling thread is currently updating, or null.
+	static ParallelUpdateTask*&	currentParallelUpdateTask();
+	bool	isCurrentParallelUpdateRoot( const View *view ) const;
+	//! Returns true if independent subtrees reached from the calling thread can be updated in parallel, which isn't the case if it is already doing parallel work.
+	bool	canUpdateInParallel() const;
+	//! Called by Layer to run \a updateFn for each of \a parent's independent \a subtrees on the WorkerPool, then apply their deferred work.
+	void	updateInParallel( View *parent, const std::vector<View *> &subtrees, const std::function<void ( View * )> &updateFn );
+
+	void propagateTouchesBegan( InteractionRegion *region, const ViewRef &view, ci::app::TouchEvent &event, size_t &numTouchesHandled, ViewRef &firstResponder );
 	
-	//! Returns true if view should be erased from mViewsWithTouches and the intercepted event was released.
-	bool handleInterceptingTouches( const ViewRef &view, bool eventEnding );
+	//! Returns true if view should be erased from the region's Views with touches and the intercepted event was released.
+	bool handleInterceptingTouches( InteractionRegion *region, const ViewRef &view, bool eventEnding );
+	void updateInterceptingTouches( InteractionRegion *region );
+
+	struct RegionTouchEvent {
+		InteractionRegionRef	mRegion;
+		ci::app::TouchEvent		mEvent;
+	};
+
+	InteractionRegion*				findTouchBeganRegion( const ci::vec2 &pos );
+	InteractionRegion*				findTouchRegion( uint32_t touchId ) const;
+	std::vector<RegionTouchEvent>	splitTouchesByRegion( const ci::app::TouchEvent &event ) const;
+	void beginTouches( InteractionRegion *region, ci::app::TouchEvent &event );
+	void moveTouches( InteractionRegion *region, ci::app::TouchEvent &event );
+	void moveTouchesInParallel( std::vector<RegionTouchEvent> &regionEvents );
+	void endTouches( InteractionRegion *region, ci::app::TouchEvent &event );
+	void finishTouchDispatch();
+
+	//! Counts a touch dispatch for as long as it is in scope, so that the depth stays balanced if a handler throws.
+	//! finish() ends the dispatch normally, calling deferred functions if it was the outermost one.
+	class ScopedTouchDispatch {
+	  public:
+		ScopedTouchDispatch( Graph *graph );
+		~ScopedTouchDispatch();
+
+		void	finish();
+
+	  private:
+		Graph*	mGraph;
+		bool	mFinished = false;
+	};
+
+	enum class QueuedTouchType { BEGAN, MOVED, ENDED };
+
+	void queueTouches( QueuedTouchType type, const ci::app::TouchEvent::Touch *touches, size_t numTouches );
+	void dispatchQueuedTouches();
+	//! Returns the time \a touch happened at for the TouchHistory, which is the current time for touches that don't have one (ex. injected or replayed).
+	double getTouchTime( const ci::app::TouchEvent::Touch &touch ) const	{ return touch.getTime() > 0 ? touch.getTime() : mCurrentTime; }
+
+	typedef void (GestureRecognizer::*GestureTouchesFn)( const std::vector<ci::app::TouchEvent::Touch> &touches );
+
+	View* findGestureView( View *view, const ci::vec2 &pos ) const;
+	void beginGestureTouches( const std::vector<ci::app::TouchEvent::Touch> &touches );
+	void dispatchGestureTouches( GestureTouchesFn fn, const std::vector<ci::app::TouchEvent::Touch> &touches, bool ending );
+	void updateGestureRecognizers();
+	void resolveGestureRecognizers();
 
 #if 0
 	void propagateKeyDown( ViewRef &view, ci::app::KeyEvent &event );
@@ -141,19 +332,75 @@ class CI_UI_API Graph : public View {
 	int					mEventSlotPriority = 1;
 	ci::ivec2			mClippingSize;
 	bool				mClippingSizeSet = false;
-	double				mCurrentTime;
-	uint64_t			mCurrentFrame;
+	double				mCurrentTime = 0;
+	uint64_t			mCurrentFrame = 0;
+	std::function<double ()>	mTimeSource;
 	
 
 	ci::signals::ConnectionList				mEventConnections;
 	ci::vec2								mPrevMousePos;
 
+	struct QueuedTouchEvent {
+		QueuedTouchType							mType;
+		std::vector<ci::app::TouchEvent::Touch>	mTouches;
+		std::map<uint32_t, std::vector<ci::app::TouchEvent::Touch>>	mCoalescedTouches; // every move merged into mTouches, by touch id
+	};
+
+	bool											mTouchCoalescingEnabled = false;
+	std::vector<QueuedTouchEvent>					mQueuedTouchEvents; // entries past mNumQueuedTouchEvents are kept so their buffers are reused
+	size_t											mNumQueuedTouchEvents = 0;
+	std::vector<QueuedTouchEvent>					mDispatchingTouchEvents; // swapped with mQueuedTouchEvents while dispatching
+	const QueuedTouchEvent*							mCurrentQueuedTouchEvent = nullptr;
+	bool											mDispatchingQueuedTouches = false;
+	ci::app::TouchEvent								mDispatchTouchEvent;
+	size_t											mNumTouchesCoalesced = 0;
+	size_t											mNumTouchesCoalescedPending = 0;
+
+	TouchHistory									mTouchHistory;
+	std::vector<GestureRecognizerRef>				mActiveGestureRecognizers;
+	std::vector<ci::app::TouchEvent::Touch>			mGestureTouches; // reused for dispatching to each recognizer
+
 	std::list<LayerRef>	    mLayers;
-	std::list<ViewRef>	    mViewsWithTouches;
-	ViewRef					mFirstResponder;
-	std::weak_ptr<View>		mPreviousFirstResponder; //! Only store a weak reference to the previous responder so we don't retain it (mFirstResponder will get unset when it is removed from the view hierarchy)
+
+	InteractionRegionRef						mRootRegion;
+	std::vector<InteractionRegionRef>			mInteractionRegions;
+	InteractionRegion*							mKeyRegion = nullptr;	// region whose first responder receives key events
+	std::map<uint32_t, InteractionRegion *>		mTouchRegions;			// region that each active touch began in
+	size_t										mTouchDispatchDepth = 0;
+	bool										mParallelTouchDispatchEnabled = false;
+	bool										mDispatchingInParallel = false;
+	std::mutex									mParallelLayoutMutex;	// guards the layout queue if Views are destroyed during parallel touch dispatch or update
+
+	struct LayoutEntry {
+		View*	mView;
+		size_t	mDepth;
+	};
+
+	std::vector<View *>				mLayoutQueue;
+	std::vector<LayoutEntry>		mLayoutEntries;
+	std::vector<View *>				mLayoutDeferred;
+	std::unordered_set<const View *>	mLayoutQueueRemoved;	// Views destroyed while queued, skipped until the queue is next processed
+	uint64_t						mLayoutPass = 0;
+	LayoutStats						mLayoutStats;
+	DrawStats						mDrawStats;
+	bool							mCullingEnabled = true;
+
+	std::unique_ptr<WorkerPool>		mWorkerPool;
+	std::unique_ptr<ImageLoader>	mImageLoader; // declared after mWorkerPool so that it is destroyed first
+	std::unique_ptr<ImageCache>		mImageCache;
+	bool							mParallelTextLayoutEnabled = false;
+	bool							mParallelUpdateEnabled = false;
+	size_t							mMaxParallelUpdateThreads = 0;
+	bool							mUpdatingInParallel = false;
+	std::vector<ParallelUpdateTask>	mParallelUpdateTasks;
+	std::vector<std::weak_ptr<Label>>	mDirtyLabels;			// queued by Label, expired entries are skipped
+	std::vector<std::shared_ptr<Label>>	mLabelsToMeasure;
+	std::vector<ci::vec2>				mDirtyLabelTextSizes;
 
 	friend class Layer;
+	friend class View;
+	friend class InteractionRegion;
+	friend class Label;
 };
 
 class CI_UI_API GraphExc : public ci::Exception {
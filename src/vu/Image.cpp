@@ -24,20 +24,109 @@
 #include "vu/Image.h"
 
 #include "cinder/gl/Texture.h"
+#include "cinder/gl/Pbo.h"
+#include "cinder/gl/wrapper.h"
+#include "cinder/ip/Premultiply.h"
 
 using namespace ci;
 
 namespace vu {
 
-Image::Image( const ImageSourceRef &imageSource )
-	: Image( gl::Texture::create( imageSource ) )
+namespace {
+
+bool isBptcSupported()
+{
+#if defined( CINDER_GL_ES )
+	return false;
+#else
+	static bool sSupported = gl::isExtensionAvailable( "GL_ARB_texture_compression_bptc" );
+	return sSupported;
+#endif
+}
+
+gl::Texture2d::Format makeTextureFormat( const Image::Format &format, bool hasAlpha )
+{
+	gl::Texture2d::Format result;
+	result.minFilter( GL_LINEAR ).magFilter( GL_LINEAR );
+
+	if( format.isMipmapEnabled() ) {
+		result.mipmap().minFilter( GL_LINEAR_MIPMAP_LINEAR );
+	}
+
+#if ! defined( CINDER_GL_ES )
+	if( format.getCompression() == Image::Compression::AUTO && isBptcSupported() ) {
+		result.internalFormat( format.isSrgbEnabled() ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM );
+		return result;
+	}
+#endif
+
+	if( format.isSrgbEnabled() ) {
+		result.internalFormat( hasAlpha ? GL_SRGB8_ALPHA8 : GL_SRGB8 );
+	}
+
+	return result;
+}
+
+} // anonymous namespace
+
+Image::Image( const ImageSourceRef &imageSource, const Format &format )
+	: mFormat( format )
+{
+	// Let the texture load directly from the ImageSource unless we need to process the pixels first
+	if( ! format.isPremultiplyEnabled() && ! format.isRetainSurfaceEnabled() ) {
+		mTexture = gl::Texture::create( imageSource, makeTextureFormat( format, imageSource->hasAlpha() ) );
+		mSize = mTexture->getSize();
+	}
+	else {
+		setup( Surface8u( imageSource ), false, nullptr );
+	}
+}
+
+Image::Image( const Surface8u &surface, const Format &format )
+	: mFormat( format )
+{
+	setup( surface, false, nullptr );
+}
+
+Image::Image( const Surface8u &surface, const Format &format, bool isPremultiplied, const gl::PboRef &intermediatePbo )
+	: mFormat( format )
+{
+	setup( surface, isPremultiplied, intermediatePbo );
+}
+
+void Image::setup( const Surface8u &surface, bool isPremultiplied, const gl::PboRef &intermediatePbo )
 {
+	const Surface8u *pixels = &surface;
+	Surface8u premultiplied;
+	if( mFormat.isPremultiplyEnabled() && ! isPremultiplied && surface.hasAlpha() ) {
+		premultiplied = surface.clone();
+		ip::premultiply( &premultiplied );
+		pixels = &premultiplied;
+	}
+
+	auto textureFormat = makeTextureFormat( mFormat, pixels->hasAlpha() );
+	if( intermediatePbo ) {
+		textureFormat.intermediatePbo( intermediatePbo );
+	}
+
+	mTexture = gl::Texture2d::create( *pixels, textureFormat );
+	mSize = mTexture->getSize();
+
+	if( mFormat.isRetainSurfaceEnabled() ) {
+		mSurface = std::make_shared<Surface8u>( pixels == &surface ? surface.clone() : std::move( premultiplied ) );
+	}
 }
 
-Image::Image( const ci::gl::TextureRef &texture )
-	: mTexture( texture )
+Image::Image( const ci::gl::TextureRef &texture, const Format &format )
+	: mTexture( texture ), mFormat( format )
 {
 	mSize = mTexture->getSize();
 }
 
+Image::Image( const ci::gl::TextureRef &texture, const ci::Area &region )
+	: mTexture( texture ), mSize( region.getSize() ), mIsTextureRegion( true )
+{
+	mTexCoords = mTexture->getAreaTexCoords( region );
+}
+
 } // namespace vu
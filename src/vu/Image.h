@@ -26,6 +26,8 @@
 #include "vu/Export.h"
 #include "cinder/Cinder.h"
 #include "cinder/ImageIo.h"
+#include "cinder/Rect.h"
+#include "cinder/Surface.h"
 
 #include <memory>
 
@@ -34,6 +36,7 @@ namespace cinder { namespace gl {
 //typedef std::shared_ptr<class Texture>  TextureRef; // TODO: fix this forward decl. in Texture.h
 typedef std::shared_ptr<class Texture2d>		Texture2dRef;
 typedef Texture2dRef							TextureRef;
+typedef std::shared_ptr<class Pbo>				PboRef;
 
 } } // namespace cinder::gl
 
@@ -43,19 +46,79 @@ typedef std::shared_ptr<class Image>	ImageRef;
 
 class CI_UI_API Image {
   public:
-	Image( const ci::ImageSourceRef &imageSource );
+	//! Texture compression, used when supported by the current GL context and otherwise ignored.
+	enum class Compression {
+		NONE,
+		//! Compressed by the driver on upload, BC7 on desktop GL. Not available on GL ES, where compressed textures need to be loaded from pre-compressed (ex. KTX) files.
+		AUTO
+	};
+
+	//! Options for how an Image's texture is created.
+	struct Format {
+		Format() {}
+
+		//! Generates mipmaps and uses trilinear filtering, which avoids shimmering when the Image is drawn smaller than its size. Default is false.
+		Format& mipmap( bool enable = true )			{ mMipmap = enable; return *this; }
+		//! Premultiplies color by alpha on load, so the Image is drawn with BlendMode::PREMULT_ALPHA like Labels and Layers. Default is false.
+		Format& premultiply( bool enable = true )		{ mPremultiply = enable; return *this; }
+		//! Stores the texture in the sRGB color space. Default is false.
+		Format& srgb( bool enable = true )				{ mSrgb = enable; return *this; }
+		//! Sets the texture compression. Default is Compression::NONE.
+		Format& compression( Compression compression )	{ mCompression = compression; return *this; }
+		//! Keeps a CPU-side copy of the pixels, available from Image::getSurface(). Default is false.
+		Format& retainSurface( bool enable = true )		{ mRetainSurface = enable; return *this; }
+
+		bool		isMipmapEnabled() const			{ return mMipmap; }
+		bool		isPremultiplyEnabled() const	{ return mPremultiply; }
+		bool		isSrgbEnabled() const			{ return mSrgb; }
+		Compression	getCompression() const			{ return mCompression; }
+		bool		isRetainSurfaceEnabled() const	{ return mRetainSurface; }
+
+	  private:
+		bool		mMipmap = false;
+		bool		mPremultiply = false;
+		bool		mSrgb = false;
+		Compression	mCompression = Compression::NONE;
+		bool		mRetainSurface = false;
+	};
+
+	Image( const ci::ImageSourceRef &imageSource, const Format &format = Format() );
+	Image( const ci::Surface8u &surface, const Format &format = Format() );
 	//! \note this is public although in the long run, we will want a way to load textures without being tied to gl, so this will likely change.
-	Image( const ci::gl::TextureRef &texture );
+	//! \a format describes the contents of \a texture, ex. whether they are already premultiplied.
+	Image( const ci::gl::TextureRef &texture, const Format &format = Format() );
+	//! Creates an Image that refers to \a region of a shared \a texture, ex. an ImageAtlas page.
+	Image( const ci::gl::TextureRef &texture, const ci::Area &region );
+
+	const Format&		getFormat() const	{ return mFormat; }
+	//! Returns true if the Image's colors are premultiplied by alpha.
+	bool				isPremultiplied() const	{ return mFormat.isPremultiplyEnabled(); }
+	//! Returns the CPU-side pixels if Format::retainSurface() was enabled, otherwise null.
+	const ci::Surface8uRef&	getSurface() const	{ return mSurface; }
 
 	const ci::ivec2&    getSize() const     { return mSize; }
 	ci::Area            getBounds() const   { return ci::Area( 0, 0, mSize.x, mSize.y ); }
 
 	const ci::gl::TextureRef&	getTexture() const	{ return mTexture; }
+	//! Returns true if this Image only uses a region of its texture.
+	bool				isTextureRegion() const		{ return mIsTextureRegion; }
+	//! Returns the texture coordinates of this Image within its texture, upper left to lower right.
+	const ci::Rectf&	getTexCoords() const		{ return mTexCoords; }
 
   private:
+	//! Used by ImageLoader, which premultiplies on a worker thread and uploads through a PBO.
+	Image( const ci::Surface8u &surface, const Format &format, bool isPremultiplied, const ci::gl::PboRef &intermediatePbo );
+
+	void	setup( const ci::Surface8u &surface, bool isPremultiplied, const ci::gl::PboRef &intermediatePbo );
+
 	ci::gl::TextureRef	mTexture;
+	Format				mFormat;
+	ci::Surface8uRef	mSurface;
 	ci::ivec2           mSize;
+	ci::Rectf			mTexCoords = ci::Rectf( 0, 0, 1, 1 );
+	bool				mIsTextureRegion = false;
 
+	friend class ImageLoader;
 	friend class Renderer;
 };
 
@@ -0,0 +1,155 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/ImageAtlas.h"
+
+#include "cinder/gl/Texture.h"
+
+#include <cstring>
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+namespace {
+
+// Each entry has its edge pixels repeated into a border of this size, so that linear filtering doesn't sample neighboring entries.
+const int ENTRY_PADDING = 1;
+
+// Copies the edge pixels of the entry inside \a surface outwards into its padding.
+void extrudeEdges( Surface8u &surface )
+{
+	const int width = surface.getWidth();
+	const int height = surface.getHeight();
+	const int rowBytes = (int)surface.getRowBytes();
+	uint8_t *data = surface.getData();
+
+	// left and right columns
+	for( int y = ENTRY_PADDING; y < height - ENTRY_PADDING; y++ ) {
+		uint8_t *row = data + y * rowBytes;
+		memcpy( row, row + ENTRY_PADDING * 4, 4 );
+		memcpy( row + ( width - 1 ) * 4, row + ( width - 1 - ENTRY_PADDING ) * 4, 4 );
+	}
+
+	// top and bottom rows, including corners
+	memcpy( data, data + ENTRY_PADDING * rowBytes, rowBytes );
+	memcpy( data + ( height - 1 ) * rowBytes, data + ( height - 1 - ENTRY_PADDING ) * rowBytes, rowBytes );
+}
+
+} // anonymous namespace
+
+ImageAtlas::ImageAtlas( const ivec2 &pageSize )
+	: mPageSize( pageSize )
+{
+}
+
+ImageRef ImageAtlas::add( const ImageSourceRef &imageSource )
+{
+	return add( Surface8u( imageSource ) );
+}
+
+ImageRef ImageAtlas::add( const Surface8u &surface )
+{
+	const ivec2 paddedSize = surface.getSize() + ivec2( ENTRY_PADDING * 2 );
+	if( paddedSize.x > mPageSize.x || paddedSize.y > mPageSize.y ) {
+		return make_shared<Image>( gl::Texture2d::create( surface ) );
+	}
+
+	ivec2 pos;
+	Page *page = nullptr;
+	for( auto &p : mPages ) {
+		if( allocate( p, paddedSize, &pos ) ) {
+			page = &p;
+			break;
+		}
+	}
+
+	if( ! page ) {
+		page = &makePage();
+		bool allocated = allocate( *page, paddedSize, &pos );
+		CI_VERIFY( allocated );
+	}
+
+	// Copy into a tightly packed RGBA surface with a border, converting the channel order if needed.
+	if( mUploadSurface.getSize() != paddedSize ) {
+		mUploadSurface = Surface8u( paddedSize.x, paddedSize.y, true, SurfaceChannelOrder::RGBA );
+	}
+
+	mUploadSurface.copyFrom( surface, surface.getBounds(), ivec2( ENTRY_PADDING ) );
+	if( ! surface.hasAlpha() ) {
+		// entries without alpha are opaque
+		for( int y = ENTRY_PADDING; y < paddedSize.y - ENTRY_PADDING; y++ ) {
+			uint8_t *pixel = mUploadSurface.getData( ivec2( ENTRY_PADDING, y ) );
+			for( int x = 0; x < surface.getWidth(); x++, pixel += 4 )
+				pixel[3] = 255;
+		}
+	}
+
+	extrudeEdges( mUploadSurface );
+
+	page->mTexture->update( mUploadSurface.getData(), GL_RGBA, GL_UNSIGNED_BYTE, 0, paddedSize.x, paddedSize.y, ivec2( pos ) );
+
+	Area region( pos + ivec2( ENTRY_PADDING ), pos + paddedSize - ivec2( ENTRY_PADDING ) );
+	return make_shared<Image>( page->mTexture, region );
+}
+
+bool ImageAtlas::allocate( Page &page, const ivec2 &size, ivec2 *pos )
+{
+	// Use the shortest existing shelf that is tall enough and has room left
+	Shelf *bestShelf = nullptr;
+	for( auto &shelf : page.mShelves ) {
+		if( shelf.mHeight >= size.y && shelf.mX + size.x <= mPageSize.x ) {
+			if( ! bestShelf || shelf.mHeight < bestShelf->mHeight )
+				bestShelf = &shelf;
+		}
+	}
+
+	if( ! bestShelf ) {
+		if( page.mNextShelfY + size.y > mPageSize.y )
+			return false;
+
+		page.mShelves.push_back( { page.mNextShelfY, size.y, 0 } );
+		page.mNextShelfY += size.y;
+		bestShelf = &page.mShelves.back();
+	}
+
+	*pos = ivec2( bestShelf->mX, bestShelf->mY );
+	bestShelf->mX += size.x;
+	return true;
+}
+
+ImageAtlas::Page& ImageAtlas::makePage()
+{
+	// Pages are top-down so that entries can be uploaded without flipping and regions map directly to texture coordinates.
+	auto format = gl::Texture2d::Format().loadTopDown().minFilter( GL_LINEAR ).magFilter( GL_LINEAR );
+	Surface8u clear( mPageSize.x, mPageSize.y, true, SurfaceChannelOrder::RGBA );
+	memset( clear.getData(), 0, clear.getRowBytes() * clear.getHeight() );
+
+	Page page;
+	page.mTexture = gl::Texture2d::create( clear, format );
+	mPages.push_back( move( page ) );
+	return mPages.back();
+}
+
+} // namespace vu
@@ -0,0 +1,77 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Image.h"
+
+#include "cinder/Surface.h"
+
+#include <vector>
+
+namespace vu {
+
+typedef std::shared_ptr<class ImageAtlas>	ImageAtlasRef;
+
+//! Packs many small Images into shared texture pages, so that the Renderer can draw them without rebinding textures between each one.
+//! \note Images that are a region of a page should be drawn with the Renderer's default shader, custom shaders (ex. ImageView::setShader()) sample the entire page.
+class CI_UI_API ImageAtlas {
+  public:
+	//! Creates an ImageAtlas with pages of \a pageSize pixels.
+	explicit ImageAtlas( const ci::ivec2 &pageSize = ci::ivec2( 1024 ) );
+
+	//! Adds \a surface to the atlas, returning an Image that refers to its region. Images that don't fit in a page are given their own texture.
+	ImageRef	add( const ci::Surface8u &surface );
+	//! Adds the image loaded from \a imageSource to the atlas.
+	ImageRef	add( const ci::ImageSourceRef &imageSource );
+
+	//! Returns the size of each page texture.
+	const ci::ivec2&			getPageSize() const					{ return mPageSize; }
+	//! Returns the number of page textures currently allocated.
+	size_t						getNumPages() const					{ return mPages.size(); }
+	//! Returns the texture for page \a index.
+	const ci::gl::TextureRef&	getPageTexture( size_t index ) const	{ return mPages.at( index ).mTexture; }
+
+  private:
+	struct Shelf {
+		int		mY;
+		int		mHeight;
+		int		mX;		// next free x position
+	};
+
+	struct Page {
+		ci::gl::TextureRef	mTexture;
+		std::vector<Shelf>	mShelves;
+		int					mNextShelfY = 0;
+	};
+
+	//! Finds space for a \a size region in \a page, returning false if it doesn't fit.
+	bool	allocate( Page &page, const ci::ivec2 &size, ci::ivec2 *pos );
+	Page&	makePage();
+
+	ci::ivec2			mPageSize;
+	std::vector<Page>	mPages;
+	ci::Surface8u		mUploadSurface; // reused for padding entries before upload
+};
+
+} // namespace vu
@@ -0,0 +1,165 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/ImageCache.h"
+
+#include "cinder/CinderMath.h"
+#include "cinder/Log.h"
+
+//#define LOG_IMAGE_CACHE( stream )	CI_LOG_I( stream )
+#define LOG_IMAGE_CACHE( stream )	( (void)( 0 ) )
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+ImageCache::ImageCache( ImageLoader *loader, size_t budgetBytes )
+	: mLoader( loader ), mBudget( budgetBytes )
+{
+	CI_ASSERT( mLoader );
+}
+
+// static
+ivec2 ImageCache::calcCacheSize( const ivec2 &targetSize )
+{
+	// Sizes are bucketed so that Views drawn at similar sizes share an entry.
+	int maxDim = std::max( 1, std::max( targetSize.x, targetSize.y ) );
+	int size = (int)nextPowerOf2( (uint32_t)maxDim );
+	return ivec2( size );
+}
+
+ImageCache::EntryRef ImageCache::acquire( const fs::path &filePath, const ivec2 &targetSize )
+{
+	const ivec2 cacheSize = calcCacheSize( targetSize );
+	string key = filePath.string() + "@" + to_string( cacheSize.x );
+
+	auto it = mEntries.find( key );
+	if( it != mEntries.end() ) {
+		mNumHits++;
+		return it->second;
+	}
+
+	mNumMisses++;
+
+	auto entry = make_shared<Entry>();
+	entry->mKey = key;
+	try {
+		entry->mRequest = mLoader->load( loadFile( filePath ), cacheSize, Image::Format().mipmap() );
+		mLoading.push_back( entry );
+	}
+	catch( std::exception &exc ) {
+		CI_LOG_EXCEPTION( "failed to open image file: " << filePath, exc );
+	}
+
+	mEntries[key] = entry;
+
+	LOG_IMAGE_CACHE( "miss: " << key );
+	return entry;
+}
+
+void ImageCache::markDrawn( const EntryRef &entry )
+{
+	entry->mLastDrawnFrame = mFrame;
+	if( entry->mResident && entry->mLruIt != mLru.begin() ) {
+		mLru.splice( mLru.begin(), mLru, entry->mLruIt );
+	}
+}
+
+void ImageCache::update()
+{
+	mFrame++;
+
+	// collect finished loads
+	for( auto it = mLoading.begin(); it != mLoading.end(); /* */ ) {
+		auto &entry = *it;
+		auto state = entry->mRequest->getState();
+		if( state == ImageLoadRequest::State::READY ) {
+			entry->mImage = entry->mRequest->getImage();
+			const ivec2 size = entry->mImage->getSize();
+			entry->mNumBytes = size_t( size.x ) * size_t( size.y ) * 4 * 4 / 3; // RGBA8 with mipmaps
+			entry->mResident = true;
+			entry->mLastDrawnFrame = mFrame;
+			mLru.push_front( entry );
+			entry->mLruIt = mLru.begin();
+			mResidentBytes += entry->mNumBytes;
+		}
+		else if( ! entry->mRequest->isDone() ) {
+			++it;
+			continue;
+		}
+
+		// failed entries stay in mEntries with no Image, so they aren't retried every frame
+		entry->mRequest = nullptr;
+		it = mLoading.erase( it );
+	}
+
+	// evict least recently drawn entries, keeping any that were drawn last frame
+	while( mResidentBytes > mBudget && ! mLru.empty() ) {
+		auto entry = mLru.back();
+		if( entry->mLastDrawnFrame + 1 >= mFrame )
+			break;
+
+		evict( entry );
+		mNumEvictions++;
+	}
+}
+
+void ImageCache::evict( const EntryRef &entry )
+{
+	LOG_IMAGE_CACHE( "evicting: " << entry->mKey << ", bytes: " << entry->mNumBytes );
+
+	mResidentBytes -= entry->mNumBytes;
+	mLru.erase( entry->mLruIt );
+	mEntries.erase( entry->mKey );
+
+	entry->mImage = nullptr;
+	entry->mResident = false;
+	entry->mEvicted = true;
+}
+
+void ImageCache::clear()
+{
+	while( ! mLru.empty() ) {
+		evict( mLru.back() );
+	}
+
+	// remove failed entries too
+	for( auto it = mEntries.begin(); it != mEntries.end(); /* */ ) {
+		if( ! it->second->isLoading() ) {
+			it->second->mEvicted = true;
+			it = mEntries.erase( it );
+		}
+		else
+			++it;
+	}
+}
+
+void ImageCache::resetCounters()
+{
+	mNumHits = 0;
+	mNumMisses = 0;
+	mNumEvictions = 0;
+}
+
+} // namespace vu
@@ -0,0 +1,114 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/ImageLoader.h"
+
+#include "cinder/Filesystem.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vu {
+
+typedef std::shared_ptr<class ImageCache>	ImageCacheRef;
+
+//! Shares Images loaded from files between Views, keyed by file path and the resolution they are drawn at.
+//! Images are decoded at the smallest power of two size that covers the requested size (with mipmaps), and the least recently drawn entries are evicted when the resident bytes exceed the budget.
+class CI_UI_API ImageCache {
+  public:
+	class Entry {
+	  public:
+		//! Returns the loaded Image, or null if it is still loading, failed or was evicted.
+		const ImageRef&		getImage() const	{ return mImage; }
+		//! Returns true if the Image is still loading.
+		bool				isLoading() const	{ return mRequest != nullptr; }
+		//! Returns true if this entry was evicted, in which case it should be acquired again.
+		bool				isEvicted() const	{ return mEvicted; }
+
+	  private:
+		std::string								mKey;
+		ImageRef								mImage;
+		ImageLoadRequestRef						mRequest;
+		size_t									mNumBytes = 0;
+		uint64_t								mLastDrawnFrame = 0;
+		bool									mResident = false;
+		bool									mEvicted = false;
+		std::list<std::shared_ptr<Entry>>::iterator	mLruIt;
+
+		friend class ImageCache;
+	};
+
+	typedef std::shared_ptr<Entry>	EntryRef;
+
+	//! Creates an ImageCache that loads with \a loader and keeps at most \a budgetBytes of textures resident.
+	ImageCache( ImageLoader *loader, size_t budgetBytes = 512 * 1024 * 1024 );
+
+	//! Returns the entry for \a filePath at a resolution suitable for drawing at \a targetSize pixels, starting a load if it isn't resident.
+	EntryRef	acquire( const ci::fs::path &filePath, const ci::ivec2 &targetSize );
+	//! Marks \a entry as drawn this frame, so that it is evicted after entries that were drawn less recently.
+	void		markDrawn( const EntryRef &entry );
+	//! Collects finished loads and evicts least recently drawn entries while over budget. Called once per frame by Graph.
+	void		update();
+	//! Evicts all entries that aren't loading.
+	void		clear();
+
+	//! Sets the maximum number of texture bytes kept resident. Entries drawn during the last frame are never evicted, so this can be exceeded.
+	void	setBudget( size_t bytes )		{ mBudget = bytes; }
+	size_t	getBudget() const				{ return mBudget; }
+	//! Returns the number of texture bytes currently resident (including mipmaps).
+	size_t	getResidentBytes() const		{ return mResidentBytes; }
+	//! Returns the number of entries, both loading and resident.
+	size_t	getNumEntries() const			{ return mEntries.size(); }
+	//! Returns the number of acquire() calls that found an existing entry.
+	size_t	getNumHits() const				{ return mNumHits; }
+	//! Returns the number of acquire() calls that started a new load.
+	size_t	getNumMisses() const			{ return mNumMisses; }
+	//! Returns the number of entries evicted to stay within the budget.
+	size_t	getNumEvictions() const			{ return mNumEvictions; }
+	//! Resets the hit, miss and eviction counters.
+	void	resetCounters();
+
+	//! Returns the power of two size used to cache an Image drawn at \a targetSize.
+	static ci::ivec2	calcCacheSize( const ci::ivec2 &targetSize );
+
+  private:
+	void	evict( const EntryRef &entry );
+
+	ImageLoader*								mLoader;
+	std::unordered_map<std::string, EntryRef>	mEntries;
+	std::list<EntryRef>							mLru;		// resident entries, most recently drawn first
+	std::vector<EntryRef>						mLoading;
+	size_t										mBudget;
+	size_t										mResidentBytes = 0;
+	uint64_t									mFrame = 0;
+
+	size_t	mNumHits = 0;
+	size_t	mNumMisses = 0;
+	size_t	mNumEvictions = 0;
+};
+
+} // namespace vu
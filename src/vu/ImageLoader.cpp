@@ -0,0 +1,235 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/ImageLoader.h"
+
+#include "cinder/gl/Pbo.h"
+#include "cinder/gl/Texture.h"
+#include "cinder/ImageIo.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Resize.h"
+#include "cinder/Log.h"
+
+//#define LOG_IMAGE_LOADER( stream )	CI_LOG_I( stream )
+#define LOG_IMAGE_LOADER( stream )	( (void)( 0 ) )
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+// ----------------------------------------------------------------------------------------------------
+// ImageLoadRequest
+// ----------------------------------------------------------------------------------------------------
+
+ImageLoadRequest::ImageLoadRequest( const function<Surface8u ()> &decodeFn, const ivec2 &maxSize, const Image::Format &format )
+	: mDecodeFn( decodeFn ), mMaxSize( maxSize ), mFormat( format ), mState( State::DECODING )
+{
+}
+
+void ImageLoadRequest::cancel()
+{
+	State expected = State::DECODING;
+	if( mState.compare_exchange_strong( expected, State::CANCELLED ) )
+		return;
+
+	// Once uploading, only the main thread modifies the state so this is safe.
+	expected = State::UPLOADING;
+	mState.compare_exchange_strong( expected, State::CANCELLED );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// ImageLoader
+// ----------------------------------------------------------------------------------------------------
+
+ImageLoader::ImageLoader( WorkerPool *workerPool )
+	: mWorkerPool( workerPool ), mDecoded( make_shared<DecodedQueue>() )
+{
+	CI_ASSERT( mWorkerPool );
+}
+
+ImageLoader::~ImageLoader()
+{
+	unique_lock<mutex> lock( mDecoded->mMutex );
+	mDecoded->mShutdown = true;
+
+	// Decode tasks that haven't started yet will see the shutdown flag and return right away.
+	for( auto &request : mDecoded->mDecoding ) {
+		request->cancel();
+	}
+	for( auto &request : mDecoded->mRequests ) {
+		request->cancel();
+		request->mSurface = Surface8u();
+	}
+	mDecoded->mDecoding.clear();
+	mDecoded->mRequests.clear();
+
+	// Decode functions may refer to objects that are destroyed along with the Graph, so wait for those that are already running.
+	mDecoded->mDecodeFinishedCond.wait( lock, [this] { return mDecoded->mNumInProgress == 0; } );
+}
+
+ImageLoadRequestRef ImageLoader::load( const DataSourceRef &source, const ivec2 &maxSize, const Image::Format &format )
+{
+	auto request = ImageLoadRequestRef( new ImageLoadRequest( [source] { return Surface8u( loadImage( source ) ); }, maxSize, format ) );
+	request->mSource = source;
+
+	enqueueDecode( request );
+	return request;
+}
+
+ImageLoadRequestRef ImageLoader::load( const function<Surface8u ()> &decodeFn, const ivec2 &maxSize, const Image::Format &format )
+{
+	auto request = ImageLoadRequestRef( new ImageLoadRequest( decodeFn, maxSize, format ) );
+
+	enqueueDecode( request );
+	return request;
+}
+
+void ImageLoader::enqueueDecode( const ImageLoadRequestRef &request )
+{
+	{
+		lock_guard<mutex> lock( mDecoded->mMutex );
+		mDecoded->mDecoding.insert( request );
+	}
+
+	auto decoded = mDecoded;
+	mWorkerPool->enqueue( [decoded, request] {
+		{
+			lock_guard<mutex> lock( decoded->mMutex );
+			if( decoded->mShutdown )
+				return;
+
+			if( request->getState() == ImageLoadRequest::State::CANCELLED ) {
+				decoded->mDecoding.erase( request );
+				return;
+			}
+
+			decoded->mNumInProgress++;
+		}
+
+		// Called on every path out of decoding, removes the request from those in progress and wakes up a waiting destructor.
+		auto finishDecode = [&decoded, &request]( bool succeeded ) {
+			lock_guard<mutex> lock( decoded->mMutex );
+			decoded->mNumInProgress--;
+			if( ! decoded->mShutdown ) {
+				decoded->mDecoding.erase( request );
+				if( succeeded )
+					decoded->mRequests.push_back( request );
+			}
+			decoded->mDecodeFinishedCond.notify_all();
+		};
+
+		Surface8u surface;
+		try {
+			surface = request->mDecodeFn();
+
+			const ivec2 &maxSize = request->mMaxSize;
+			if( maxSize.x > 0 && maxSize.y > 0 && ( surface.getWidth() > maxSize.x || surface.getHeight() > maxSize.y ) ) {
+				float scale = std::min( maxSize.x / (float)surface.getWidth(), maxSize.y / (float)surface.getHeight() );
+				ivec2 size = glm::max( ivec2( 1 ), ivec2( vec2( surface.getSize() ) * scale ) );
+				surface = ip::resize( surface, size );
+			}
+
+			if( request->mFormat.isPremultiplyEnabled() && surface.hasAlpha() ) {
+				ip::premultiply( &surface );
+			}
+		}
+		catch( std::exception &exc ) {
+			CI_LOG_EXCEPTION( "failed to decode image", exc );
+			request->mState = ImageLoadRequest::State::FAILED;
+			finishDecode( false );
+			return;
+		}
+
+		request->mSurface = move( surface );
+
+		auto expected = ImageLoadRequest::State::DECODING;
+		if( ! request->mState.compare_exchange_strong( expected, ImageLoadRequest::State::UPLOADING ) ) {
+			// cancelled while decoding
+			request->mSurface = Surface8u();
+			finishDecode( false );
+			return;
+		}
+
+		finishDecode( true );
+	} );
+}
+
+size_t ImageLoader::getNumWaitingForUpload() const
+{
+	lock_guard<mutex> lock( mDecoded->mMutex );
+	return mDecoded->mRequests.size();
+}
+
+void ImageLoader::update()
+{
+	mBytesUploadedLastUpdate = 0;
+
+	while( true ) {
+		ImageLoadRequestRef request;
+		{
+			lock_guard<mutex> lock( mDecoded->mMutex );
+			if( mDecoded->mRequests.empty() )
+				break;
+
+			request = mDecoded->mRequests.front();
+			if( request->getState() != ImageLoadRequest::State::CANCELLED ) {
+				size_t numBytes = request->mSurface.getRowBytes() * request->mSurface.getHeight();
+				if( mBytesUploadedLastUpdate > 0 && mBytesUploadedLastUpdate + numBytes > mUploadBudget )
+					break;
+
+				mBytesUploadedLastUpdate += numBytes;
+			}
+
+			mDecoded->mRequests.pop_front();
+		}
+
+		if( request->getState() == ImageLoadRequest::State::CANCELLED ) {
+			request->mSurface = Surface8u();
+			continue;
+		}
+
+		upload( request );
+	}
+}
+
+void ImageLoader::upload( const ImageLoadRequestRef &request )
+{
+	const auto &surface = request->mSurface;
+	const size_t numBytes = surface.getRowBytes() * surface.getHeight();
+
+	// Upload through the next PBO in the ring, growing it as needed.
+	auto &pbo = mPbos[mNextPbo];
+	mNextPbo = ( mNextPbo + 1 ) % NUM_UPLOAD_PBOS;
+	if( ! pbo || pbo->getSize() < numBytes ) {
+		pbo = gl::Pbo::create( GL_PIXEL_UNPACK_BUFFER, numBytes, nullptr, GL_STREAM_DRAW );
+	}
+
+	request->mImage = ImageRef( new Image( surface, request->mFormat, true, pbo ) );
+	request->mSurface = Surface8u();
+	request->mState = ImageLoadRequest::State::READY;
+
+	LOG_IMAGE_LOADER( "uploaded image: " << request->mImage->getSize() << ", bytes: " << numBytes );
+}
+
+} // namespace vu
@@ -0,0 +1,142 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Image.h"
+#include "vu/WorkerPool.h"
+
+#include "cinder/DataSource.h"
+#include "cinder/Surface.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class Pbo>	PboRef;
+
+} } // namespace cinder::gl
+
+namespace vu {
+
+typedef std::shared_ptr<class ImageLoader>			ImageLoaderRef;
+typedef std::shared_ptr<class ImageLoadRequest>		ImageLoadRequestRef;
+
+//! Handle to an Image that is being loaded by an ImageLoader.
+class CI_UI_API ImageLoadRequest {
+  public:
+	enum class State {
+		DECODING,	//! Waiting for or being decoded on a worker thread.
+		UPLOADING,	//! Decoded, waiting to be uploaded on the main thread.
+		READY,		//! getImage() is valid.
+		FAILED,		//! Decoding failed, see log for details.
+		CANCELLED
+	};
+
+	State	getState() const	{ return mState; }
+	bool	isReady() const		{ return mState == State::READY; }
+	bool	isDone() const		{ return mState == State::READY || mState == State::FAILED || mState == State::CANCELLED; }
+
+	//! Returns the loaded Image, or null if it isn't ready.
+	const ImageRef&		getImage() const	{ return mImage; }
+	//! Returns the source that the Image is loaded from, or null if it was loaded with a decode function.
+	const ci::DataSourceRef&	getSource() const	{ return mSource; }
+
+	//! Stops the request. Any work that has not started yet will be skipped.
+	void	cancel();
+
+  private:
+	ImageLoadRequest( const std::function<ci::Surface8u ()> &decodeFn, const ci::ivec2 &maxSize, const Image::Format &format );
+
+	std::function<ci::Surface8u ()>	mDecodeFn;
+	ci::DataSourceRef	mSource;
+	ci::ivec2			mMaxSize;
+	Image::Format		mFormat;
+	std::atomic<State>	mState;
+	ci::Surface8u		mSurface; // decoded pixels, released after upload
+	ImageRef			mImage;
+
+	friend class ImageLoader;
+};
+
+//! Loads Images asynchronously, decoding on a WorkerPool and uploading textures on the main thread within a per-frame budget.
+//! \note update() must be called once per frame on the main thread, Graph does this for the ImageLoader returned from Graph::getImageLoader().
+//! \note Destroying the ImageLoader cancels all requests that haven't completed, waiting for any decodes that are already in progress.
+class CI_UI_API ImageLoader {
+  public:
+	explicit ImageLoader( WorkerPool *workerPool );
+	~ImageLoader();
+
+	//! Starts loading an Image from \a source. The result is available from the returned request once it is ready.
+	//! If \a maxSize is non-zero, the image is downscaled on the worker thread to fit within it (preserving aspect ratio). Premultiplying for \a format is also done on the worker thread.
+	ImageLoadRequestRef		load( const ci::DataSourceRef &source, const ci::ivec2 &maxSize = ci::ivec2( 0 ), const Image::Format &format = Image::Format() );
+	//! Starts loading an Image from the Surface returned by \a decodeFn, which is called on a worker thread and may throw to indicate failure.
+	ImageLoadRequestRef		load( const std::function<ci::Surface8u ()> &decodeFn, const ci::ivec2 &maxSize = ci::ivec2( 0 ), const Image::Format &format = Image::Format() );
+
+	//! Uploads decoded images to textures, up to the upload budget. Must be called on the main thread.
+	void	update();
+
+	//! Sets the maximum number of bytes uploaded each update(). At least one image is always uploaded per update, even if it exceeds the budget. Default is 8MB.
+	void	setUploadBudget( size_t bytesPerFrame )		{ mUploadBudget = bytesPerFrame; }
+	//! Returns the maximum number of bytes uploaded each update().
+	size_t	getUploadBudget() const						{ return mUploadBudget; }
+	//! Returns the number of bytes uploaded during the last update().
+	size_t	getBytesUploadedLastUpdate() const			{ return mBytesUploadedLastUpdate; }
+	//! Returns the number of decoded images waiting to be uploaded.
+	size_t	getNumWaitingForUpload() const;
+
+  private:
+	ImageLoader( const ImageLoader& )				= delete;
+	ImageLoader& operator=( const ImageLoader& )	= delete;
+
+	void	enqueueDecode( const ImageLoadRequestRef &request );
+	void	upload( const ImageLoadRequestRef &request );
+
+	// Shared with worker tasks, so that tasks still queued when the ImageLoader is destroyed don't reference it.
+	struct DecodedQueue {
+		std::mutex								mMutex;
+		std::condition_variable					mDecodeFinishedCond;
+		std::unordered_set<ImageLoadRequestRef>	mDecoding;			// requests that haven't finished decoding, cancelled on shutdown
+		std::deque<ImageLoadRequestRef>			mRequests;			// decoded requests waiting for upload
+		size_t									mNumInProgress = 0;	// decodes running on a worker thread
+		bool									mShutdown = false;
+	};
+
+	// Uploads cycle through a few PBOs, so that one upload doesn't have to wait for the previous transfer to complete.
+	static const size_t NUM_UPLOAD_PBOS = 3;
+
+	WorkerPool*									mWorkerPool;
+	std::shared_ptr<DecodedQueue>				mDecoded;
+	std::array<ci::gl::PboRef, NUM_UPLOAD_PBOS>	mPbos;
+	size_t										mNextPbo = 0;
+	size_t										mUploadBudget = 8 * 1024 * 1024;
+	size_t										mBytesUploadedLastUpdate = 0;
+};
+
+} // namespace vu
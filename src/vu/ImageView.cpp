@@ -22,7 +22,11 @@
 */
 
 #include "ImageView.h"
+#include "vu/Graph.h"
 #include "cinder/gl/Batch.h"
+#include "cinder/Log.h"
+
+#include <typeinfo>
 
 using namespace ci;
 using namespace std;
@@ -35,11 +39,136 @@ ImageView::ImageView( const ci::Rectf &bounds )
 	setInteractive( false );
 }
 
+ImageView::~ImageView()
+{
+	cancelImageLoad();
+}
+
 void ImageView::setImage( const ImageRef &image )
 {
+	cancelImageLoad();
+	mImageSource = nullptr;
+	mImageFilePath.clear();
+	mImageCacheEntry = nullptr;
 	mImage = image;
 }
 
+void ImageView::setImageAsync( const DataSourceRef &source )
+{
+	cancelImageLoad();
+	mImageFilePath.clear();
+	mImageCacheEntry = nullptr;
+	mImageSource = source;
+}
+
+void ImageView::setImageFile( const fs::path &filePath )
+{
+	cancelImageLoad();
+	mImageSource = nullptr;
+	mImage = nullptr;
+	mImageCacheEntry = nullptr;
+	mImageFilePath = filePath;
+}
+
+const ImageRef& ImageView::getDisplayedImage() const
+{
+	if( mImage )
+		return mImage;
+
+	if( mImageCacheEntry && mImageCacheEntry->getImage() )
+		return mImageCacheEntry->getImage();
+
+	return mPlaceholderImage;
+}
+
+void ImageView::cancelImageLoad()
+{
+	if( mImageLoadRequest ) {
+		mImageLoadRequest->cancel();
+		mImageLoadRequest = nullptr;
+	}
+}
+
+bool ImageView::canBatchDraw() const
+{
+	// subclasses may draw with gl directly, so they need to opt in themselves
+	return typeid( *this ) == typeid( ImageView );
+}
+
+void ImageView::didLeaveHierarchy()
+{
+	// mImageSource and mImageFilePath are kept so that the load restarts if this ImageView is added back to the Graph
+	cancelImageLoad();
+	mImageCacheEntry = nullptr;
+	mDrawnSinceUpdate = false;
+}
+
+void ImageView::updateImageCacheEntry()
+{
+	ivec2 targetSize = ivec2( glm::ceil( getSize() ) );
+	if( targetSize.x <= 0 || targetSize.y <= 0 )
+		return;
+
+	// only acquire again when evicted or resized enough to need a different resolution
+	ivec2 cacheSize = ImageCache::calcCacheSize( targetSize );
+	if( mImageCacheEntry && ! mImageCacheEntry->isEvicted() && cacheSize == mImageCacheSize )
+		return;
+
+	// offscreen ImageViews don't load, otherwise an evicted entry would be loaded right back in every frame
+	if( ! mDrawnSinceUpdate ) {
+		const Rectf visibleBounds = calcVisibleBoundsLocal();
+		if( visibleBounds.getWidth() <= 0 || visibleBounds.getHeight() <= 0 )
+			return;
+	}
+
+	mImageCacheSize = cacheSize;
+
+	// ImageCache isn't thread-safe, so within an independent subtree the entry is acquired once the parallel update is complete
+	auto view = static_pointer_cast<ImageView>( shared_from_this() );
+	getGraph()->defer( [view, targetSize] {
+		// may have left the hierarchy or changed its image in the meantime
+		if( view->getGraph() && ! view->mImageFilePath.empty() )
+			view->mImageCacheEntry = view->getGraph()->getImageCache()->acquire( view->mImageFilePath, targetSize );
+	} );
+}
+
+void ImageView::update()
+{
+	if( ! mImageFilePath.empty() )
+		updateImageCacheEntry();
+	else if( mImageSource )
+		updateImageLoad();
+
+	mDrawnSinceUpdate = false;
+
+	// the displayed image changes without layout when loads complete, so let any rasterizing ancestor know
+	const auto &displayedImage = getDisplayedImage();
+	if( displayedImage != mDisplayedImageLastUpdate.lock() ) {
+		mDisplayedImageLastUpdate = displayedImage;
+		setNeedsDisplay();
+	}
+}
+
+void ImageView::updateImageLoad()
+{
+	if( ! mImageLoadRequest ) {
+		mImageLoadRequest = getGraph()->getImageLoader()->load( mImageSource );
+		return;
+	}
+
+	auto state = mImageLoadRequest->getState();
+	if( state == ImageLoadRequest::State::READY ) {
+		mImage = mImageLoadRequest->getImage();
+		mImageLoadRequest = nullptr;
+		mImageSource = nullptr;
+	}
+	else if( state == ImageLoadRequest::State::FAILED ) {
+		CI_LOG_E( "failed to load image for view: " << getName() );
+		mImageLoadRequest = nullptr;
+		mImageSource = nullptr;
+	}
+}
+
 void ImageView::setShader( const ci::gl::GlslProgRef &glsl )
 {
 	if( mBatch ) {
@@ -61,33 +190,52 @@ ci::gl::GlslProgRef	ImageView::getShader() const
 
 void ImageView::draw( Renderer *ren )
 {
-	if( ! mImage )
+	mDrawnSinceUpdate = true;
+
+	const auto &image = getDisplayedImage();
+	if( ! image )
 		return;
 
+	if( mImageCacheEntry && image == mImageCacheEntry->getImage() )
+		getGraph()->getImageCache()->markDrawn( mImageCacheEntry );
+
+	if( image->isPremultiplied() )
+		ren->pushBlendMode( BlendMode::PREMULT_ALPHA );
+
 	// TODO: this should be handled at the Renderer level
 	if( isRenderTransparencyToFrameBufferEnabled() )
 		ren->setColor( getColor() );
 	else {
 		ColorA color = getColor();
 		color.a = getAlphaCombined();
+		// with the premultiplied blend the tint has to be premultiplied too, otherwise fading out brightens the image
+		if( image->isPremultiplied() ) {
+			color.r *= color.a;
+			color.g *= color.a;
+			color.b *= color.a;
+		}
 		ren->setColor( color );
 	}
 
 	if( mBatch ) {
-		ren->draw( mImage, getDestRectLocal(), mBatch );
+		ren->draw( image, getDestRectLocal(), mBatch );
 	}
 	else {
-		ren->draw( mImage, getDestRectLocal() );
+		ren->draw( image, getDestRectLocal() );
 	}
+
+	if( image->isPremultiplied() )
+		ren->popBlendMode();
 }
 
 Rectf ImageView::getDestRectLocal() const
 {
-	if( ! mImage ) {
+	const auto &image = getDisplayedImage();
+	if( ! image ) {
 		return Rectf::zero();
 	}
 
-	Rectf texBounds = mImage->getBounds();
+	Rectf texBounds = image->getBounds();
 	auto bounds = getBoundsLocal();
 
 	switch( mScaleMode ) {
@@ -25,6 +25,8 @@
 
 #include "vu/View.h"
 #include "vu/Image.h"
+#include "vu/ImageCache.h"
+#include "vu/ImageLoader.h"
 
 namespace cinder {
 
@@ -55,17 +57,34 @@ class CI_UI_API ImageView : public View {
   public:
 
 	ImageView( const ci::Rectf &bounds = ci::Rectf::zero() );
+	~ImageView();
 
+	//! Sets the Image to draw, cancelling any load started with setImageAsync().
 	void			setImage( const ImageRef &image );
 	ImageRef		getImage() const	{ return mImage; }
 
-	void			setScaleMode( ImageScaleMode mode )	{ mScaleMode = mode; }
+	//! Loads the Image from \a source with the Graph's ImageLoader, replacing the current Image once it is ready. The placeholder Image is drawn until then.
+	//! \note Loading starts once this ImageView is part of a Graph, and is cancelled (then restarted if needed) when it leaves the hierarchy.
+	void			setImageAsync( const ci::DataSourceRef &source );
+	//! Returns true if an Image set with setImageAsync() has not finished loading.
+	bool			isImageLoading() const	{ return mImageSource != nullptr; }
+
+	//! Draws the image at \a filePath from the Graph's ImageCache, at a resolution that matches this ImageView's size rather than the full source resolution.
+	//! The placeholder Image is drawn while it loads, and it is reloaded automatically if evicted once this ImageView is visible again.
+	void				setImageFile( const ci::fs::path &filePath );
+	const ci::fs::path&	getImageFile() const	{ return mImageFilePath; }
+
+	//! Sets the Image drawn while there is no Image, ex. when one is loading. Default is null (nothing is drawn).
+	void			setPlaceholderImage( const ImageRef &image )	{ mPlaceholderImage = image; setNeedsDisplay(); }
+	const ImageRef&	getPlaceholderImage() const						{ return mPlaceholderImage; }
+
+	void			setScaleMode( ImageScaleMode mode )	{ mScaleMode = mode; setNeedsDisplay(); }
 	ImageScaleMode	getScaleMode() const				{ return mScaleMode; }
 
 	//! Returns the destination Rect in this ImageView's coordinate system.
 	ci::Rectf		getDestRectLocal() const;
 
-	void					setColor( const ci::Color &color )	{ mColor = color; }
+	void					setColor( const ci::Color &color )	{ mColor = color; setNeedsDisplay(); }
 	const ci::Color&		getColor() const					{ return mColor; }
 	ci::Anim<ci::Color>*	getColorAnim()						{ return &mColor; }
 
@@ -73,13 +92,30 @@ class CI_UI_API ImageView : public View {
 	ci::gl::GlslProgRef	getShader() const;
 
   protected:
+	void update() override;
 	void draw( Renderer *ren ) override;
+	//! Returns true for ImageView itself, subclasses that override draw() are flushed as usual unless they also override this.
+	bool canBatchDraw() const override;
+	void didLeaveHierarchy() override;
 
   private:
+	const ImageRef&	getDisplayedImage() const;
+	void			cancelImageLoad();
+	void			updateImageCacheEntry();
+	void			updateImageLoad();
+
 	ImageRef				mImage;
+	ImageRef				mPlaceholderImage;
+	ci::DataSourceRef		mImageSource; // non-null while an async load is in progress
+	ImageLoadRequestRef		mImageLoadRequest;
+	ci::fs::path			mImageFilePath;
+	ImageCache::EntryRef	mImageCacheEntry;
+	ci::ivec2				mImageCacheSize;
 	ImageScaleMode			mScaleMode = ImageScaleMode::FIT;
 	ci::Anim<ci::Color>		mColor = ci::Color::white();
 	ci::gl::BatchRef		mBatch;
+	std::weak_ptr<Image>	mDisplayedImageLastUpdate;
+	bool					mDrawnSinceUpdate = false;
 };
 
 
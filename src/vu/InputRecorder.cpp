@@ -0,0 +1,452 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/InputRecorder.h"
+#include "vu/Graph.h"
+
+#include "cinder/app/AppBase.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/Stream.h"
+#include "cinder/Timer.h"
+
+#include <algorithm>
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+namespace {
+
+const uint32_t	FILE_MAGIC			= 0x52495556; // "VUIR" when written little-endian
+const uint32_t	FILE_VERSION		= 1;
+const int		RECORDER_PRIORITY	= 1000;
+
+// sizes in the file, used to validate counts before anything is allocated for them
+const size_t	MIN_EVENT_BYTES		= sizeof( uint8_t ) + sizeof( double ) + sizeof( uint32_t ); // type, time and touch count (key events are larger)
+const size_t	TOUCH_BYTES			= sizeof( uint32_t ) + 4 * sizeof( float );
+
+bool isTouchEvent( InputRecording::EventType type )
+{
+	return type == InputRecording::EventType::TOUCHES_BEGAN || type == InputRecording::EventType::TOUCHES_MOVED || type == InputRecording::EventType::TOUCHES_ENDED;
+}
+
+uint8_t getModifiers( const app::KeyEvent &event )
+{
+	uint8_t result = 0;
+	if( event.isShiftDown() )
+		result |= app::KeyEvent::SHIFT_DOWN;
+	if( event.isAltDown() )
+		result |= app::KeyEvent::ALT_DOWN;
+	if( event.isControlDown() )
+		result |= app::KeyEvent::CTRL_DOWN;
+	if( event.isMetaDown() )
+		result |= app::KeyEvent::META_DOWN;
+
+	return result;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------------------------------
+// InputRecording
+// ----------------------------------------------------------------------------------------------------
+
+void InputRecording::addTouches( EventType type, double time, const vector<app::TouchEvent::Touch> &touches )
+{
+	CI_ASSERT( isTouchEvent( type ) );
+
+	Event event;
+	event.mType = type;
+	event.mTime = time;
+	event.mFirstTouch = (uint32_t)mTouches.size();
+	event.mNumTouches = (uint32_t)touches.size();
+	mEvents.push_back( event );
+
+	for( const auto &touch : touches ) {
+		mTouches.push_back( { touch.getId(), touch.getPos(), touch.getPrevPos() } );
+	}
+}
+
+void InputRecording::addKey( EventType type, double time, const app::KeyEvent &keyEvent )
+{
+	CI_ASSERT( type == EventType::KEY_DOWN || type == EventType::KEY_UP );
+
+	Event event;
+	event.mType = type;
+	event.mTime = time;
+	event.mKeyCode = keyEvent.getCode();
+	event.mKeyCharUtf32 = keyEvent.getCharUtf32();
+	event.mKeyChar = keyEvent.getChar();
+	event.mKeyModifiers = getModifiers( keyEvent );
+	mEvents.push_back( event );
+}
+
+void InputRecording::clear()
+{
+	mEvents.clear();
+	mTouches.clear();
+}
+
+void InputRecording::write( const fs::path &filePath ) const
+{
+	try {
+		auto stream = writeFileStream( filePath );
+		stream->writeLittle( FILE_MAGIC );
+		stream->writeLittle( FILE_VERSION );
+		stream->writeLittle( (uint32_t)mEvents.size() );
+
+		for( const auto &event : mEvents ) {
+			stream->writeLittle( (uint8_t)event.mType );
+			stream->writeLittle( event.mTime );
+
+			if( isTouchEvent( event.mType ) ) {
+				stream->writeLittle( event.mNumTouches );
+				for( uint32_t i = 0; i < event.mNumTouches; i++ ) {
+					const auto &touch = mTouches[event.mFirstTouch + i];
+					stream->writeLittle( touch.mId );
+					stream->writeLittle( touch.mPos.x );
+					stream->writeLittle( touch.mPos.y );
+					stream->writeLittle( touch.mPrevPos.x );
+					stream->writeLittle( touch.mPrevPos.y );
+				}
+			}
+			else {
+				stream->writeLittle( event.mKeyCode );
+				stream->writeLittle( event.mKeyCharUtf32 );
+				stream->writeLittle( (int8_t)event.mKeyChar );
+				stream->writeLittle( event.mKeyModifiers );
+			}
+		}
+	}
+	catch( ci::Exception &exc ) {
+		throw InputRecordingExc( "failed to write recording to '" + filePath.string() + "', what: " + exc.what() );
+	}
+}
+
+// static
+InputRecordingRef InputRecording::read( const fs::path &filePath )
+{
+	auto result = make_shared<InputRecording>();
+
+	try {
+		auto stream = loadFileStream( filePath );
+
+		uint32_t magic, version, numEvents;
+		stream->readLittle( &magic );
+		stream->readLittle( &version );
+		if( magic != FILE_MAGIC || version != FILE_VERSION ) {
+			throw InputRecordingExc( "'" + filePath.string() + "' is not a supported input recording" );
+		}
+
+		// the counts come from the file, so make sure the stream is big enough to hold them before reserving space
+		auto remainingBytes = [&stream] { return (uint64_t)( stream->size() - stream->tell() ); };
+		auto invalid = [&filePath]( const string &reason ) {
+			return InputRecordingExc( "invalid input recording '" + filePath.string() + "': " + reason );
+		};
+
+		stream->readLittle( &numEvents );
+		if( (uint64_t)numEvents * MIN_EVENT_BYTES > remainingBytes() ) {
+			throw invalid( "event count " + to_string( numEvents ) + " exceeds the file size" );
+		}
+
+		result->mEvents.reserve( numEvents );
+
+		for( uint32_t e = 0; e < numEvents; e++ ) {
+			uint8_t type;
+			stream->readLittle( &type );
+			if( type > (uint8_t)EventType::KEY_UP ) {
+				throw invalid( "event type " + to_string( type ) );
+			}
+
+			Event event;
+			event.mType = (EventType)type;
+			stream->readLittle( &event.mTime );
+
+			if( isTouchEvent( event.mType ) ) {
+				event.mFirstTouch = (uint32_t)result->mTouches.size();
+				stream->readLittle( &event.mNumTouches );
+				if( (uint64_t)event.mNumTouches * TOUCH_BYTES > remainingBytes() ) {
+					throw invalid( "touch count " + to_string( event.mNumTouches ) + " exceeds the file size" );
+				}
+
+				for( uint32_t i = 0; i < event.mNumTouches; i++ ) {
+					Touch touch;
+					stream->readLittle( &touch.mId );
+					stream->readLittle( &touch.mPos.x );
+					stream->readLittle( &touch.mPos.y );
+					stream->readLittle( &touch.mPrevPos.x );
+					stream->readLittle( &touch.mPrevPos.y );
+					result->mTouches.push_back( touch );
+				}
+			}
+			else {
+				int8_t keyChar;
+				stream->readLittle( &event.mKeyCode );
+				stream->readLittle( &event.mKeyCharUtf32 );
+				stream->readLittle( &keyChar );
+				stream->readLittle( &event.mKeyModifiers );
+				event.mKeyChar = (char)keyChar;
+			}
+
+			result->mEvents.push_back( event );
+		}
+
+		if( remainingBytes() != 0 ) {
+			throw invalid( to_string( remainingBytes() ) + " unexpected bytes after the last event" );
+		}
+	}
+	catch( InputRecordingExc & ) {
+		throw;
+	}
+	catch( ci::Exception &exc ) {
+		throw InputRecordingExc( "failed to read recording from '" + filePath.string() + "', what: " + exc.what() );
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// InputRecorder
+// ----------------------------------------------------------------------------------------------------
+
+InputRecorder::InputRecorder()
+	: mRecordingData( make_shared<InputRecording>() )
+{
+}
+
+void InputRecorder::start( const app::WindowRef &window, bool mouse, bool touches, bool keyboard )
+{
+	stop();
+
+	mRecordingData = make_shared<InputRecording>();
+	mStartTime = app::getElapsedSeconds();
+	mRecording = true;
+
+	if( mouse ) {
+		mConnections += window->getSignalMouseDown().connect( RECORDER_PRIORITY, [this]( app::MouseEvent &event ) {
+			mMouseTouches.assign( 1, app::TouchEvent::Touch( event.getPos(), vec2( 0 ), 0, 0, nullptr ) );
+			mRecordingData->addTouches( InputRecording::EventType::TOUCHES_BEGAN, getTime(), mMouseTouches );
+			mPrevMousePos = event.getPos();
+		} );
+		mConnections += window->getSignalMouseDrag().connect( RECORDER_PRIORITY, [this]( app::MouseEvent &event ) {
+			mMouseTouches.assign( 1, app::TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, 0, nullptr ) );
+			mRecordingData->addTouches( InputRecording::EventType::TOUCHES_MOVED, getTime(), mMouseTouches );
+			mPrevMousePos = event.getPos();
+		} );
+		mConnections += window->getSignalMouseUp().connect( RECORDER_PRIORITY, [this]( app::MouseEvent &event ) {
+			mMouseTouches.assign( 1, app::TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, 0, nullptr ) );
+			mRecordingData->addTouches( InputRecording::EventType::TOUCHES_ENDED, getTime(), mMouseTouches );
+			mPrevMousePos = event.getPos();
+		} );
+	}
+
+	if( touches ) {
+		mConnections += window->getSignalTouchesBegan().connect( RECORDER_PRIORITY, [this]( app::TouchEvent &event ) {
+			mRecordingData->addTouches( InputRecording::EventType::TOUCHES_BEGAN, getTime(), event.getTouches() );
+		} );
+		mConnections += window->getSignalTouchesMoved().connect( RECORDER_PRIORITY, [this]( app::TouchEvent &event ) {
+			mRecordingData->addTouches( InputRecording::EventType::TOUCHES_MOVED, getTime(), event.getTouches() );
+		} );
+		mConnections += window->getSignalTouchesEnded().connect( RECORDER_PRIORITY, [this]( app::TouchEvent &event ) {
+			mRecordingData->addTouches( InputRecording::EventType::TOUCHES_ENDED, getTime(), event.getTouches() );
+		} );
+	}
+
+	if( keyboard ) {
+		mConnections += window->getSignalKeyDown().connect( RECORDER_PRIORITY, [this]( app::KeyEvent &event ) {
+			mRecordingData->addKey( InputRecording::EventType::KEY_DOWN, getTime(), event );
+		} );
+		mConnections += window->getSignalKeyUp().connect( RECORDER_PRIORITY, [this]( app::KeyEvent &event ) {
+			mRecordingData->addKey( InputRecording::EventType::KEY_UP, getTime(), event );
+		} );
+	}
+}
+
+void InputRecorder::stop()
+{
+	mConnections.clear();
+	mRecording = false;
+}
+
+double InputRecorder::getTime() const
+{
+	return app::getElapsedSeconds() - mStartTime;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// InputReplayer
+// ----------------------------------------------------------------------------------------------------
+
+InputReplayer::InputReplayer( Graph *graph, const InputRecordingRef &recording )
+	: mGraph( graph ), mRecording( recording )
+{
+	CI_ASSERT( mGraph );
+	CI_ASSERT( mRecording );
+}
+
+InputReplayer::~InputReplayer()
+{
+	stop();
+}
+
+void InputReplayer::start()
+{
+	mTime = 0;
+	mNextEvent = 0;
+	mFrameStats.clear();
+	mRunning = true;
+
+	mGraph->setTimeSource( [this] { return mTime; } );
+}
+
+bool InputReplayer::stepFrame()
+{
+	if( ! mRunning ) {
+		start();
+	}
+
+	mTime += mFrameDuration;
+
+	FrameStats stats;
+	stats.mTime = mTime;
+
+	Timer timer( true );
+
+	// dispatch all events that happened up until the end of this frame, as they would have arrived between updates
+	const auto &events = mRecording->getEvents();
+	while( mNextEvent < events.size() && events[mNextEvent].mTime <= mTime ) {
+		dispatchEvent( events[mNextEvent] );
+		mNextEvent++;
+		stats.mNumEvents++;
+	}
+
+	stats.mEventMillis = timer.getSeconds() * 1000.0;
+
+	timer.start();
+	mGraph->propagateUpdate();
+	stats.mUpdateMillis = timer.getSeconds() * 1000.0;
+
+	if( mDrawEnabled ) {
+		timer.start();
+		mGraph->propagateDraw();
+		stats.mDrawMillis = timer.getSeconds() * 1000.0;
+	}
+
+	mFrameStats.push_back( stats );
+	return ! isFinished();
+}
+
+void InputReplayer::run()
+{
+	start();
+	while( stepFrame() )
+		;
+
+	stop();
+}
+
+void InputReplayer::stop()
+{
+	if( mRunning ) {
+		mGraph->setTimeSource( nullptr );
+		mRunning = false;
+	}
+}
+
+void InputReplayer::dispatchEvent( const InputRecording::Event &event )
+{
+	const auto &window = mGraph->getWindow();
+
+	if( isTouchEvent( event.mType ) ) {
+		mDispatchTouches.clear();
+		const auto &touches = mRecording->getTouches();
+		for( uint32_t i = 0; i < event.mNumTouches; i++ ) {
+			const auto &touch = touches[event.mFirstTouch + i];
+			mDispatchTouches.emplace_back( touch.mPos, touch.mPrevPos, touch.mId, event.mTime, nullptr );
+		}
+
+		app::TouchEvent touchEvent( window, mDispatchTouches );
+		if( mGraph->isTouchCoalescingEnabled() ) {
+			if( event.mType == InputRecording::EventType::TOUCHES_BEGAN )
+				mGraph->queueTouchesBegan( touchEvent );
+			else if( event.mType == InputRecording::EventType::TOUCHES_MOVED )
+				mGraph->queueTouchesMoved( touchEvent );
+			else
+				mGraph->queueTouchesEnded( touchEvent );
+		}
+		else {
+			if( event.mType == InputRecording::EventType::TOUCHES_BEGAN )
+				mGraph->propagateTouchesBegan( touchEvent );
+			else if( event.mType == InputRecording::EventType::TOUCHES_MOVED )
+				mGraph->propagateTouchesMoved( touchEvent );
+			else
+				mGraph->propagateTouchesEnded( touchEvent );
+		}
+	}
+	else {
+		app::KeyEvent keyEvent( window, event.mKeyCode, event.mKeyCharUtf32, event.mKeyChar, event.mKeyModifiers, 0 );
+		if( event.mType == InputRecording::EventType::KEY_DOWN )
+			mGraph->propagateKeyDown( keyEvent );
+		else
+			mGraph->propagateKeyUp( keyEvent );
+	}
+}
+
+InputReplayer::FrameStats InputReplayer::calcMeanFrameStats() const
+{
+	FrameStats result;
+	if( mFrameStats.empty() )
+		return result;
+
+	for( const auto &stats : mFrameStats ) {
+		result.mNumEvents += stats.mNumEvents;
+		result.mEventMillis += stats.mEventMillis;
+		result.mUpdateMillis += stats.mUpdateMillis;
+		result.mDrawMillis += stats.mDrawMillis;
+	}
+
+	const double n = (double)mFrameStats.size();
+	result.mTime = mFrameStats.back().mTime;
+	result.mNumEvents = (size_t)( result.mNumEvents / n + 0.5 );
+	result.mEventMillis /= n;
+	result.mUpdateMillis /= n;
+	result.mDrawMillis /= n;
+	return result;
+}
+
+InputReplayer::FrameStats InputReplayer::calcMaxFrameStats() const
+{
+	FrameStats result;
+	for( const auto &stats : mFrameStats ) {
+		result.mTime = std::max( result.mTime, stats.mTime );
+		result.mNumEvents = std::max( result.mNumEvents, stats.mNumEvents );
+		result.mEventMillis = std::max( result.mEventMillis, stats.mEventMillis );
+		result.mUpdateMillis = std::max( result.mUpdateMillis, stats.mUpdateMillis );
+		result.mDrawMillis = std::max( result.mDrawMillis, stats.mDrawMillis );
+	}
+
+	return result;
+}
+
+} // namespace vu
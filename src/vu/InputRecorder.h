@@ -0,0 +1,167 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Export.h"
+
+#include "cinder/app/KeyEvent.h"
+#include "cinder/app/TouchEvent.h"
+#include "cinder/app/Window.h"
+#include "cinder/Exception.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Signals.h"
+
+#include <vector>
+
+namespace vu {
+
+typedef std::shared_ptr<class Graph>			GraphRef;
+typedef std::shared_ptr<class InputRecording>	InputRecordingRef;
+
+//! A timestamped stream of touch and key events, stored flat so that recording doesn't allocate per event. Mouse events are stored as touches with id 0, the same as Graph::connectEvents().
+class CI_UI_API InputRecording {
+  public:
+	enum class EventType : uint8_t { TOUCHES_BEGAN, TOUCHES_MOVED, TOUCHES_ENDED, KEY_DOWN, KEY_UP };
+
+	struct Touch {
+		uint32_t	mId;
+		ci::vec2	mPos;
+		ci::vec2	mPrevPos;
+	};
+
+	struct Event {
+		EventType	mType;
+		double		mTime;				//! Seconds since recording started.
+		uint32_t	mFirstTouch = 0;	//! Index into getTouches() of this event's first touch.
+		uint32_t	mNumTouches = 0;
+		int32_t		mKeyCode = 0;
+		uint32_t	mKeyCharUtf32 = 0;
+		char		mKeyChar = 0;
+		uint8_t		mKeyModifiers = 0;	//! Bitmask of ci::app::KeyEvent's modifier flags (SHIFT_DOWN, ALT_DOWN, CTRL_DOWN, META_DOWN)
+	};
+
+	void	addTouches( EventType type, double time, const std::vector<ci::app::TouchEvent::Touch> &touches );
+	void	addKey( EventType type, double time, const ci::app::KeyEvent &event );
+	void	clear();
+
+	const std::vector<Event>&	getEvents() const	{ return mEvents; }
+	const std::vector<Touch>&	getTouches() const	{ return mTouches; }
+	//! Returns the time of the last event.
+	double	getDuration() const		{ return mEvents.empty() ? 0 : mEvents.back().mTime; }
+
+	//! Writes the recording to \a filePath in a compact little-endian binary format. Throws InputRecordingExc on failure.
+	void						write( const ci::fs::path &filePath ) const;
+	//! Reads a recording written with write(). Throws InputRecordingExc on failure.
+	static InputRecordingRef	read( const ci::fs::path &filePath );
+
+  private:
+	std::vector<Event>	mEvents;
+	std::vector<Touch>	mTouches;
+};
+
+//! Records the mouse, touch and key events of a Window into an InputRecording.
+class CI_UI_API InputRecorder {
+  public:
+	InputRecorder();
+
+	//! Starts a new recording of \a window's events. Signals are connected with a high priority (ahead of Graph::connectEvents() by default), so events are recorded before anything can handle them.
+	void	start( const ci::app::WindowRef &window, bool mouse = true, bool touches = true, bool keyboard = true );
+	//! Stops recording, the recording is kept until the next start().
+	void	stop();
+	bool	isRecording() const		{ return mRecording; }
+
+	const InputRecordingRef&	getRecording() const	{ return mRecordingData; }
+
+  private:
+	double	getTime() const;
+
+	InputRecordingRef				mRecordingData;
+	ci::signals::ConnectionList		mConnections;
+	double							mStartTime = 0;
+	ci::vec2						mPrevMousePos;
+	bool							mRecording = false;
+	std::vector<ci::app::TouchEvent::Touch>	mMouseTouches; // reused for converting mouse events
+};
+
+//! Feeds an InputRecording into a Graph on a virtual clock, measuring how long each frame takes. Frames are stepped as fast as possible,
+//! so a recording can be replayed faster than real time (ex. as a performance regression test).
+class CI_UI_API InputReplayer {
+  public:
+	//! Per-frame timing, in milliseconds.
+	struct FrameStats {
+		double	mTime			= 0;	//! Virtual time of the frame, in seconds.
+		size_t	mNumEvents		= 0;	//! Number of recorded events dispatched before the frame's update.
+		double	mEventMillis	= 0;
+		double	mUpdateMillis	= 0;
+		double	mDrawMillis		= 0;
+	};
+
+	InputReplayer( Graph *graph, const InputRecordingRef &recording );
+	~InputReplayer();
+
+	//! Sets the virtual duration of each frame. Default is 1 / 60.
+	void	setFrameDuration( double seconds )	{ mFrameDuration = seconds; }
+	double	getFrameDuration() const			{ return mFrameDuration; }
+	//! Sets whether each frame is also drawn with Graph::propagateDraw(), which requires the Graph's GL context to be current. Default is false.
+	void	setDrawEnabled( bool enable = true )	{ mDrawEnabled = enable; }
+	bool	isDrawEnabled() const					{ return mDrawEnabled; }
+
+	//! Rewinds to the start of the recording and switches the Graph to the virtual clock.
+	void	start();
+	//! Advances the virtual clock by one frame, dispatching the events that are due and updating (and optionally drawing) the Graph. Returns false once the recording is finished.
+	bool	stepFrame();
+	//! Steps frames until the recording is finished, then restores the Graph's clock.
+	void	run();
+	//! Restores the Graph's clock.
+	void	stop();
+	bool	isFinished() const		{ return mNextEvent >= mRecording->getEvents().size(); }
+
+	const std::vector<FrameStats>&	getFrameStats() const	{ return mFrameStats; }
+	//! Returns the mean of getFrameStats().
+	FrameStats	calcMeanFrameStats() const;
+	//! Returns the maximum of each field of getFrameStats().
+	FrameStats	calcMaxFrameStats() const;
+
+  private:
+	void	dispatchEvent( const InputRecording::Event &event );
+
+	Graph*					mGraph;
+	InputRecordingRef		mRecording;
+	double					mFrameDuration = 1.0 / 60.0;
+	bool					mDrawEnabled = false;
+	bool					mRunning = false;
+	double					mTime = 0;
+	size_t					mNextEvent = 0;
+	std::vector<FrameStats>	mFrameStats;
+	std::vector<ci::app::TouchEvent::Touch>	mDispatchTouches; // reused for dispatching
+};
+
+class CI_UI_API InputRecordingExc : public ci::Exception {
+  public:
+	InputRecordingExc( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+} // namespace vu
@@ -0,0 +1,209 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/InteractionRegion.h"
+#include "vu/Graph.h"
+#include "vu/Debug.h"
+
+#include <algorithm>
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+namespace {
+
+thread_local InteractionRegion *sCurrentParallelRegion = nullptr;
+
+} // anonymous namespace
+
+InteractionRegion::InteractionRegion( Graph *graph, View *rootView )
+	: mGraph( graph ), mRootView( rootView )
+{
+}
+
+// static
+InteractionRegion* InteractionRegion::getCurrentParallelRegion()
+{
+	return sCurrentParallelRegion;
+}
+
+// static
+void InteractionRegion::setCurrentParallelRegion( InteractionRegion *region )
+{
+	sCurrentParallelRegion = region;
+}
+
+void InteractionRegion::addTouchId( uint32_t id )
+{
+	if( find( mTouchIds.begin(), mTouchIds.end(), id ) == mTouchIds.end() ) {
+		mTouchIds.push_back( id );
+	}
+}
+
+void InteractionRegion::removeTouchId( uint32_t id )
+{
+	mTouchIds.erase( remove( mTouchIds.begin(), mTouchIds.end(), id ), mTouchIds.end() );
+}
+
+void InteractionRegion::defer( const function<void ()> &fn )
+{
+	// same as Graph::defer(), there is nothing to wait for outside of dispatch
+	if( mGraph->mTouchDispatchDepth == 0 ) {
+		fn();
+		return;
+	}
+
+	mDeferred.push_back( fn );
+}
+
+void InteractionRegion::callDeferred()
+{
+	// swapped out first, deferred functions may dispatch touches that defer more
+	while( ! mDeferred.empty() ) {
+		auto deferred = move( mDeferred );
+		mDeferred.clear();
+		for( const auto &fn : deferred ) {
+			fn();
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Responder
+// ----------------------------------------------------------------------------------------------------
+
+void InteractionRegion::setFirstResponder( const ViewRef &view )
+{
+	UI_LOG_RESPONDER( "view: " << view->getName() << ", current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) );
+	if( view->willBecomeFirstResponder() ) {
+		if( mFirstResponder && mFirstResponder != view ) {
+			UI_LOG_RESPONDER( "\t\t- resigning first responder." );
+			mFirstResponder->willResignFirstResponder(); // TODO: should this return false here if mFirstResponder returns false?
+		}
+
+		auto previousFirstResponder = mFirstResponder;
+		mFirstResponder = view;
+		mPreviousFirstResponder = previousFirstResponder;
+
+		// keyboard events follow the most recently set responder, which is decided after parallel dispatch so it doesn't depend on thread timing
+		if( sCurrentParallelRegion )
+			mBecameKeyRegion = true;
+		else
+			mGraph->mKeyRegion = this;
+	}
+	else {
+		// if view declines to become first responder, try the next in the chain (which may be in another region).
+		CI_LOG_I( "\t- view declined first responder: " << view->getName() );
+		auto nextResponder = view->getNextResponder();
+		if( nextResponder ) {
+			Graph *graph = mGraph;
+			if( sCurrentParallelRegion )
+				sCurrentParallelRegion->defer( [graph, nextResponder] { graph->setFirstResponder( nextResponder ); } );
+			else
+				mGraph->setFirstResponder( nextResponder );
+		}
+	}
+}
+
+void InteractionRegion::moveToNextResponder()
+{
+	UI_LOG_RESPONDER( "current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) );
+	if( ! mFirstResponder )
+		return;
+
+	// find the next responder willing to accept responder status
+	auto nextResponder = mFirstResponder->getNextResponder();
+	while( nextResponder ) {
+		UI_LOG_RESPONDER( "\t- next responder: " << nextResponder->getName() << ", accepts first responder: " << nextResponder->getAcceptsFirstResponder() );
+
+		if( nextResponder->getAcceptsFirstResponder() )
+			break;
+
+		nextResponder = nextResponder->getNextResponder();
+	}
+
+	if( nextResponder ) {
+		setFirstResponder( nextResponder );
+	}
+	else {
+		UI_LOG_RESPONDER( "\t- no next responder, resigning current." );
+		resignFirstResponder();
+	}
+}
+
+void InteractionRegion::moveToPreviousResponder()
+{
+	UI_LOG_RESPONDER( "current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) << ", previous first responder: " <<  ( mPreviousFirstResponder ? mPreviousFirstResponder->getName() : "(none)" ) );
+	
+	// FIXME: this isn't good enough, only goes back one level
+	// - this also needs to resign the current responder
+	auto previousFirstResponder = mPreviousFirstResponder.lock();
+	if( previousFirstResponder ) {
+		setFirstResponder( previousFirstResponder );
+	}
+}
+
+void InteractionRegion::resignFirstResponder()
+{
+	UI_LOG_RESPONDER( "current first responder: " << ( mFirstResponder ? mFirstResponder->getName() : "(none)" ) );
+	if( ! mFirstResponder )
+		return;
+
+	UI_LOG_RESPONDER( "\t- resigning current responder." );
+	if( mFirstResponder->getParent() ) {
+		mPreviousFirstResponder = mFirstResponder;
+	}
+	mFirstResponder->willResignFirstResponder();
+	mFirstResponder = nullptr;
+}
+
+void InteractionRegion::propagateKeyDown( app::KeyEvent &event )
+{
+	if( mFirstResponder ) {
+		// tab / shift-tab to navigate next and previous responders
+		if( event.getCode() == app::KeyEvent::KEY_TAB ) {
+			if( event.isShiftDown() ) {
+				moveToPreviousResponder();
+			}
+			else {
+				moveToNextResponder();
+			}
+		}
+		else {
+			if( mFirstResponder->keyDown( event ) )
+				event.setHandled();
+		}
+	}
+}
+
+void InteractionRegion::propagateKeyUp( app::KeyEvent &event )
+{
+	if( mFirstResponder ) {
+		if( mFirstResponder->keyUp( event ) )
+			event.setHandled();
+	}
+}
+
+} // namespace vu
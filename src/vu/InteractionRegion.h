@@ -0,0 +1,112 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/View.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace vu {
+
+typedef std::shared_ptr<class InteractionRegion>	InteractionRegionRef;
+
+class Graph;
+
+//! A part of the Graph that users interact with independently of each other, ex. one per seat at a multi-user table.
+//! Each region has its own first responder and set of touches. A touch belongs to the region it began in until it ends, and is only seen by Views within it.
+//! The Graph always has a region for everything outside of those added with Graph::addInteractionRegion().
+class CI_UI_API InteractionRegion {
+  public:
+	//! Returns the View that this region starts at, or null if it has been destroyed.
+	View*	getRootView() const		{ return mRootView; }
+	//! Returns the Graph this region belongs to.
+	Graph*	getGraph() const		{ return mGraph; }
+
+	//! Sets the View in this region that receives Responder events (ex. keys).
+	void	setFirstResponder( const ViewRef &view );
+	//! Moves to the next responder in the responder chain if there is one, resigning any current responder.
+	void	moveToNextResponder();
+	//! Moves to the previous responder in the responder chain if there is one, resigning any current responder.
+	void	moveToPreviousResponder();
+	//! Resigns the View in this region that receives Responder events.
+	void	resignFirstResponder();
+	//! Returns the View in this region that currently has first responder status.
+	const ViewRef&	getFirstResponder() const	{ return mFirstResponder; }
+
+	//! Sends a key down event to this region's first responder, ex. from an on-screen keyboard within the region. Tab moves between responders.
+	void	propagateKeyDown( ci::app::KeyEvent &event );
+	//! Sends a key up event to this region's first responder.
+	void	propagateKeyUp( ci::app::KeyEvent &event );
+
+	//! Returns the ids of touches that currently belong to this region.
+	const std::vector<uint32_t>&	getTouchIds() const			{ return mTouchIds; }
+	//! Returns all Views in this region that currently have active touches.
+	const std::list<ViewRef>&		getViewsWithTouches() const	{ return mViewsWithTouches; }
+	//! Returns the part of the current TouchEvent that belongs to this region, if one is currently being processed.
+	const ci::app::TouchEvent&		getCurrentTouchEvent() const	{ return mCurrentTouchEvent; }
+
+	//! Queues \a fn to be called on the main thread once the current touch dispatch is complete, or calls it right away if touches aren't being dispatched.
+	//! Functions are called in the order that regions were added, then in the order they were queued, so the result doesn't depend on which threads dispatched the touches.
+	//! Anything that affects Views or state outside of this region should go through here while parallel dispatch is enabled (see Graph::setParallelTouchDispatchEnabled()).
+	void	defer( const std::function<void ()> &fn );
+
+	//! Returns the time in milliseconds spent in touchesMoved() handlers of this region during the most recent dispatch.
+	double	getLastMovedMillis() const		{ return mLastMovedMillis; }
+
+	//! Returns the region that the calling thread is currently dispatching touches for in parallel, or null.
+	static InteractionRegion*	getCurrentParallelRegion();
+
+  private:
+	InteractionRegion( Graph *graph, View *rootView );
+
+	InteractionRegion( const InteractionRegion& )				= delete;
+	InteractionRegion& operator=( const InteractionRegion& )	= delete;
+
+	void	addTouchId( uint32_t id );
+	void	removeTouchId( uint32_t id );
+	void	callDeferred();
+
+	static void	setCurrentParallelRegion( InteractionRegion *region );
+
+	Graph*								mGraph;
+	View*								mRootView;
+	std::vector<uint32_t>				mTouchIds;
+	std::list<ViewRef>					mViewsWithTouches;
+	ci::app::TouchEvent					mCurrentTouchEvent;
+	ViewRef								mFirstResponder;
+	std::weak_ptr<View>					mPreviousFirstResponder;	// weak so that it isn't retained (mFirstResponder will get unset when it is removed from the view hierarchy)
+	std::vector<std::function<void ()>>	mDeferred;
+	std::vector<View *>					mDeferredLayouts;		// Views that needed layout during parallel dispatch, merged into the Graph's queue afterwards
+	bool								mBecameKeyRegion = false;
+	double								mLastMovedMillis = 0;
+
+	friend class Graph;
+	friend class View;
+};
+
+} // namespace vu
@@ -23,6 +23,7 @@
 
 
 #include "vu/Label.h"
+#include "vu/Graph.h"
 
 #include "cinder/Log.h"
 #include "cinder/CinderAssert.h"
@@ -53,6 +54,7 @@ void Label::setFont( const std::string &systemName, float fontSize )
 
 	mText = TextManager::loadText( systemName, fontSize );
 	markTextLayoutDirty();
+	invalidateIntrinsicSize();
 }
 
 void Label::setFontFile( const ci::fs::path &filePath, float fontSize )
@@ -62,6 +64,7 @@ void Label::setFontFile( const ci::fs::path &filePath, float fontSize )
 
 	mText = TextManager::loadTextFromFile( filePath, fontSize );
 	markTextLayoutDirty();
+	invalidateIntrinsicSize();
 }
 
 void Label::setText( const std::string &text )
@@ -70,13 +73,18 @@ void Label::setText( const std::string &text )
 		return;
 
 	mTextStr = text;
+	setNeedsDisplay();
 	markTextLayoutDirty();
+	invalidateIntrinsicSize();
 }
 
 void Label::setSize( const ci::vec2 &size )
 {
 	View::setSize( size );
-	markTextLayoutDirty();
+
+	// only wrapped text depends on the size it is given
+	if( mWrapEnabled )
+		markTextLayoutDirty();
 }
 
 void Label::setAlignment( TextAlignment alignment )
@@ -95,6 +103,7 @@ void Label::setPadding( const ci::Rectf &padding )
 {
 	mPadding = padding;
 	markTextLayoutDirty();
+	invalidateIntrinsicSize();
 }
 
 void Label::setShrinkToFitEnabled( bool enable )
@@ -104,6 +113,7 @@ void Label::setShrinkToFitEnabled( bool enable )
 
 	mShrinkToFit = enable;
 	markTextLayoutDirty();
+	invalidateIntrinsicSize();
 }
 
 void Label::setWrapEnabled( bool enable )
@@ -113,11 +123,39 @@ void Label::setWrapEnabled( bool enable )
 
 	mWrapEnabled = enable;
 	markTextLayoutDirty();
+	invalidateIntrinsicSize();
+}
+
+vec2 Label::calcIntrinsicSize()
+{
+	// Without shrink to fit, the size is set explicitly and doesn't depend on the text
+	if( ! mShrinkToFit )
+		return View::calcIntrinsicSize();
+
+	bool useMetrics = shouldMeasureWithMetrics();
+	if( useMetrics )
+		mText->buildMetrics();
+
+	vec2 result = calcTextSize( useMetrics ) + mPadding.getUpperLeft() + mPadding.getLowerRight();
+
+	// wrapped text depends on the width it is given, so only the height is intrinsic
+	if( mWrapEnabled )
+		result.x = -1;
+
+	return result;
+}
+
+void Label::measure()
+{
+	// When shrinking to fit, our size only depends on the text so it can be measured before the parent is laid out.
+	if( mTextLayoutDirty && mShrinkToFit && ! isTextLayoutDeferred() ) {
+		layoutForText();
+	}
 }
 
 void Label::layout()
 {
-	if( mTextLayoutDirty ) {
+	if( mTextLayoutDirty && ! isTextLayoutDeferred() ) {
 		layoutForText();
 	}
 }
@@ -180,6 +218,16 @@ void Label::markTextLayoutDirty()
 
 	mTextLayoutDirty = true;
 	setNeedsLayout();
+
+	// let the Graph know there is text to measure before the next layout pass
+	if( mGraph && mGraph->isParallelTextLayoutEnabled() )
+		mGraph->queueTextLayout( this );
+}
+
+bool Label::isTextLayoutDeferred() const
+{
+	// wrapped text is measured by the Graph once the layout pass has given it a width
+	return mTextLayoutQueued && mWrapEnabled;
 }
 
 void Label::layoutForText()
@@ -187,36 +235,55 @@ void Label::layoutForText()
 	vec2 sizeBefore = getSize();
 
 	measureTextSize();
-	if( mShrinkToFit ) {
-		vec2 size = mTextSize;
-		size += mPadding.getUpperLeft() + mPadding.getLowerRight();
-		View::setSize( size ); // avoid cyclical Label::setSize() call
-	}
+	applyTextSize( mTextSize );
 
 	//CI_LOG_I( "this: " << getLabel() << ", wrap: " << mWrapEnabled << ", shrink: " << mShrinkToFit
 	//	<< ", size before: " << sizeBefore << ", size: " << getSize() << ", mTextSize: " << mTextSize );
-
-	mTextLayoutDirty = false;
 }
 
 void Label::measureTextSize()
 {
-	if( mTextStr.empty() ) {
-		mTextSize = vec2( 0 );
-		return;
-	}
+	bool useMetrics = shouldMeasureWithMetrics();
+	if( useMetrics )
+		mText->buildMetrics();
+
+	mTextSize = calcTextSize( useMetrics );
+
+	//CI_LOG_I( "this: " << getLabel() << ", size: " << getSize() << ",  mTextSize: " << mTextSize );
+}
+
+bool Label::shouldMeasureWithMetrics() const
+{
+	// Once parallel text layout is enabled, always measure with the same method so results don't depend on which path was taken.
+	return mGraph && mGraph->isParallelTextLayoutEnabled();
+}
+
+vec2 Label::calcTextSize( bool useMetrics ) const
+{
+	if( mTextStr.empty() )
+		return vec2( 0 );
 
 	if( mWrapEnabled ) {
 		auto fitRect = getBoundsLocal();
 		fitRect.x1 += mPadding.x1;
 		fitRect.x2 -= mPadding.x2;
-		mTextSize = mText->measureStringWrapped( mTextStr, fitRect );		
+		return useMetrics ? mText->measureStringWrappedWithMetrics( mTextStr, fitRect ) : mText->measureStringWrapped( mTextStr, fitRect );
 	}
 	else {
-		mTextSize = mText->measureString( mTextStr );
+		return useMetrics ? mText->measureStringWithMetrics( mTextStr ) : mText->measureString( mTextStr );
 	}
+}
 
-	//CI_LOG_I( "this: " << getLabel() << ", size: " << getSize() << ",  mTextSize: " << mTextSize );
+void Label::applyTextSize( const vec2 &textSize )
+{
+	mTextSize = textSize;
+	if( mShrinkToFit ) {
+		vec2 size = mTextSize;
+		size += mPadding.getUpperLeft() + mPadding.getLowerRight();
+		View::setSize( size ); // avoid cyclical Label::setSize() call
+	}
+
+	mTextLayoutDirty = false;
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -227,82 +294,210 @@ LabelGrid::LabelGrid( const Rectf &bounds )
 	: View( bounds )
 {
 	setInteractive( false );
+	setClipEnabled();
+	setBlendMode( BlendMode::PREMULT_ALPHA );
+
+	mDefaultText = TextManager::loadText();
+	mDefaultStyle = make_shared<LabelGridStyle>();
+	mFirstColumnStyle = make_shared<LabelGridStyle>();
+	mFirstColumnStyle->mAlignment = TextAlignment::RIGHT;
 }
 
 void LabelGrid::setCell( const ci::ivec2 &location, const string &text )
 {
-	auto label = makeOrFindCell( location );
-	label->setText( text );
+	auto &cell = makeOrFindCell( location );
+	if( cell.mText == text )
+		return;
+
+	cell.mText = text;
+	cell.mMeasuredText = nullptr;
+	setNeedsDisplay();
+}
+
+const string& LabelGrid::getCell( const ci::ivec2 &location ) const
+{
+	static const string sEmpty;
+	if( location.x < 0 || location.y < 0 || location.x >= mNumColumns || location.y >= mNumRows )
+		return sEmpty;
+
+	return mCells[location.y * mNumColumns + location.x].mText;
 }
 
 void LabelGrid::setRow( size_t yloc, const std::vector<std::string> &textColumns )
 {
+	if( textColumns.empty() )
+		return;
+
+	// grow once up front so each setCell() is a direct lookup
+	resize( std::max<int>( mNumColumns, (int)textColumns.size() ), std::max<int>( mNumRows, (int)yloc + 1 ) );
+
 	for( size_t i = 0; i < textColumns.size(); i++ )
 		setCell( ivec2( i, yloc ), textColumns[i] );
 }
 
-LabelRef LabelGrid::makeOrFindCell( const ci::ivec2 &location )
+void LabelGrid::setCellHeight( float height )
 {
-	CI_ASSERT( location.x >= 0 && location.y >= 0 );
+	mCellHeight = height;
+	setNeedsDisplay();
+}
 
-	for( const auto &cell : mCells ) {
-		if( cell.mLocation == location )
-			return cell.mLabel;
-	}
+void LabelGrid::setTextColor( const ci::ColorA &color )
+{
+	mDefaultStyle->mTextColor = color;
+	mFirstColumnStyle->mTextColor = color;
+	setNeedsDisplay();
+}
 
-	mCells.push_back( Cell() );
+void LabelGrid::setFont( const std::string &systemName, float fontSize )
+{
+	mDefaultText = TextManager::loadText( systemName, fontSize );
+	setNeedsDisplay();
+}
 
-	Cell &cell= mCells.back();
-	cell.mLocation = location;
-	cell.mLabel = make_shared<vu::Label>();
-	cell.mLabel->setClipEnabled();
+LabelGrid::Cell& LabelGrid::makeOrFindCell( const ci::ivec2 &location )
+{
+	CI_ASSERT( location.x >= 0 && location.y >= 0 );
 
-	// TODO: make settable per row / column / cell
-	cell.mLabel->setTextColor( mTextColor );
+	if( location.x >= mNumColumns || location.y >= mNumRows ) {
+		resize( std::max( mNumColumns, location.x + 1 ), std::max( mNumRows, location.y + 1 ) );
+	}
 
-	// TODO: make settable per row / column / cell
-	if( location.x == 0 )
-		cell.mLabel->setAlignment( TextAlignment::RIGHT );
+	return mCells[location.y * mNumColumns + location.x];
+}
 
-	addSubview( cell.mLabel );
+void LabelGrid::resize( int numColumns, int numRows )
+{
+	if( numColumns == mNumColumns && numRows == mNumRows )
+		return;
 
-	if( mGridExtents.x < location.x )
-		mGridExtents.x = location.x;
-	if( mGridExtents.y < location.y )
-		mGridExtents.y = location.y;
+	if( numColumns == mNumColumns ) {
+		// adding rows to the end doesn't change the existing indices
+		mCells.resize( numColumns * numRows );
+	}
+	else {
+		// column count changed, cells need to be restrided
+		vector<Cell> cells( numColumns * numRows );
+		for( int y = 0; y < std::min( mNumRows, numRows ); y++ ) {
+			for( int x = 0; x < std::min( mNumColumns, numColumns ); x++ ) {
+				cells[y * numColumns + x] = move( mCells[y * mNumColumns + x] );
+			}
+		}
+
+		mCells.swap( cells );
+	}
 
-	return cell.mLabel;
+	mNumColumns = numColumns;
+	mNumRows = numRows;
 }
 
 int LabelGrid::getNumRows() const
 {
-	if( mCells.empty() )
-		return 0;
+	return mNumRows;
+}
 
-	return mGridExtents.y + 1;
+int LabelGrid::getNumColumns() const
+{
+	return mNumColumns;
 }
 
 void LabelGrid::clearCells()
 {
 	mCells.clear();
-	removeAllSubviews();
-	mGridExtents = { 0, 0 };
+	mNumColumns = 0;
+	mNumRows = 0;
+	setNeedsDisplay();
 }
 
-void LabelGrid::layout()
+void LabelGrid::setColumnStyle( size_t xloc, const LabelGridStyleRef &style )
 {
-	vec2 dims = mGridExtents + ivec2( 1 );
-	vec2 cellSize = vec2( getWidth() / dims.x, mCellHeight );
+	if( mColumnStyles.size() <= xloc )
+		mColumnStyles.resize( xloc + 1 );
+
+	mColumnStyles[xloc] = style;
+	setNeedsDisplay();
+}
 
-//	CI_LOG_V( "view size: " << getSize() << ", cellSize: " << cellSize << ", dims: " << dims );
+void LabelGrid::setRowStyle( size_t yloc, const LabelGridStyleRef &style )
+{
+	if( mRowStyles.size() <= yloc )
+		mRowStyles.resize( yloc + 1 );
 
-	for( const auto &cell : mCells ) {
-		vec2 pos = cellSize * vec2( cell.mLocation );
+	mRowStyles[yloc] = style;
+	setNeedsDisplay();
+}
 
-		Rectf bounds = { pos, pos + cellSize };
-		cell.mLabel->setBounds( bounds );
+void LabelGrid::setCellStyle( const ci::ivec2 &location, const LabelGridStyleRef &style )
+{
+	auto &cell = makeOrFindCell( location );
+	cell.mStyle = style;
+	cell.mMeasuredText = nullptr;
+	setNeedsDisplay();
+}
+
+const LabelGridStyleRef& LabelGrid::getStyle( const ci::ivec2 &location, const Cell &cell ) const
+{
+	if( cell.mStyle )
+		return cell.mStyle;
+	if( location.y < (int)mRowStyles.size() && mRowStyles[location.y] )
+		return mRowStyles[location.y];
+	if( location.x < (int)mColumnStyles.size() && mColumnStyles[location.x] )
+		return mColumnStyles[location.x];
+	if( location.x == 0 )
+		return mFirstColumnStyle;
+
+	return mDefaultStyle;
+}
+
+void LabelGrid::draw( Renderer *ren )
+{
+	mNumCellsDrawn = 0;
+	if( mCells.empty() || mCellHeight <= 0 )
+		return;
+
+	const vec2 cellSize = vec2( getWidth() / mNumColumns, mCellHeight );
+	const Rectf visibleBounds = calcVisibleBoundsLocal();
+	if( visibleBounds.getWidth() <= 0 || visibleBounds.getHeight() <= 0 || cellSize.x <= 0 )
+		return;
 
-//		cout << "location: " << cell.mLocation << ", bounds: " << bounds << endl;
+	const int rowBegin = glm::clamp( (int)floor( visibleBounds.y1 / cellSize.y ), 0, mNumRows );
+	const int rowEnd = glm::clamp( (int)ceil( visibleBounds.y2 / cellSize.y ), 0, mNumRows );
+	const int columnBegin = glm::clamp( (int)floor( visibleBounds.x1 / cellSize.x ), 0, mNumColumns );
+	const int columnEnd = glm::clamp( (int)ceil( visibleBounds.x2 / cellSize.x ), 0, mNumColumns );
+
+	for( int y = rowBegin; y < rowEnd; y++ ) {
+		for( int x = columnBegin; x < columnEnd; x++ ) {
+			auto &cell = mCells[y * mNumColumns + x];
+			if( cell.mText.empty() )
+				continue;
+
+			const ivec2 location = { x, y };
+			const auto &style = getStyle( location, cell );
+			Text *text = style->mText ? style->mText.get() : mDefaultText.get();
+
+			// only re-measure when the text or font has changed since the last draw
+			if( cell.mMeasuredText != text ) {
+				cell.mTextWidth = text->measureString( cell.mText ).x;
+				cell.mMeasuredText = text;
+			}
+
+			const vec2 cellPos = cellSize * vec2( location );
+			vec2 baseline;
+			switch( style->mAlignment ) {
+				case TextAlignment::CENTER:
+					baseline.x = cellPos.x + ( cellSize.x - cell.mTextWidth ) / 2;
+				break;
+				case TextAlignment::RIGHT:
+					baseline.x = cellPos.x + cellSize.x - cell.mTextWidth - style->mPadding.x2;
+				break;
+				default:
+					baseline.x = cellPos.x + style->mPadding.x1;
+			}
+			baseline.y = cellPos.y + text->getAscent() + style->mPadding.y1;
+
+			ren->setColor( style->mTextColor );
+			text->drawString( cell.mText, baseline );
+			mNumCellsDrawn++;
+		}
 	}
 }
 
@@ -37,7 +37,7 @@ public:
 	void				setText( const std::string &text );
 	const std::string&	getText() const						{ return mTextStr; }
 
-	void					setTextColor( const ci::ColorA &color )	{ mTextColor = color; }
+	void					setTextColor( const ci::ColorA &color )	{ mTextColor = color; setNeedsDisplay(); }
 	const ci::ColorA&		getTextColor() const					{ return mTextColor; }
 	ci::Anim<ci::ColorA>*	animTextColor() { return &mTextColor; }
 
@@ -64,14 +64,24 @@ public:
 
 	//! Called automatically from View::layout() as needed, can be called earlier to adjust size properties before then.
 	void				layoutForText();
+	//! Returns true if the text size needs to be re-measured before the next draw.
+	bool				isTextLayoutDirty() const	{ return mTextLayoutDirty; }
 protected:
+	ci::vec2 calcIntrinsicSize() override;
+	void measure() override;
 	void layout() override;
 	void draw( Renderer *ren ) override;
 
 private:
 	ci::vec2	getBaseLine() const;
 	void		markTextLayoutDirty();
+	bool		isTextLayoutDeferred() const;
 	void		measureTextSize();
+	//! Returns the size of the text with the current settings without modifying any state. If \a useMetrics is true, this is safe to call from any thread.
+	ci::vec2	calcTextSize( bool useMetrics ) const;
+	//! Stores the measured \a textSize and updates the View's size if shrink to fit is enabled.
+	void		applyTextSize( const ci::vec2 &textSize );
+	bool		shouldMeasureWithMetrics() const;
 
 	TextRef			mText;
 	std::string		mTextStr;
@@ -86,40 +96,86 @@ private:
 	bool			mWrapEnabled = false;
 	bool			mShrinkToFit = false;
 	bool			mTextLayoutDirty = false;
+	bool			mTextLayoutQueued = false; // true while in the Graph's queue of Labels to measure in parallel
+
+	friend class Graph;
+};
+
+//! Text styling that can be shared between many LabelGrid rows, columns or cells. Modifying a style affects every cell that uses it.
+struct CI_UI_API LabelGridStyle {
+	TextRef			mText;			//! Font used for drawing, if null the LabelGrid's default Text is used.
+	ci::ColorA		mTextColor		= ci::ColorA::black();
+	TextAlignment	mAlignment		= TextAlignment::LEFT;
+	ci::Rectf		mPadding		= ci::Rectf( 4, 4, 4, 4 );
 };
 
+typedef std::shared_ptr<LabelGridStyle>	LabelGridStyleRef;
+
 //! Manages a grid of text entries, useful for building things like info panels. Non-interactive by default.
+//! Cells are stored densely and drawn directly, only the rows and columns that are visible within clipping ancestors (ex. a ScrollView) are drawn.
 class CI_UI_API LabelGrid : public View {
 public:
 	LabelGrid( const ci::Rectf &bounds = ci::Rectf::zero() );
 
 	void setCell( const ci::ivec2 &location, const std::string &text );
 	void setCell( size_t xloc, size_t yloc, const std::string &text )	{ setCell( ci::ivec2( xloc, yloc ), text ); }
+	//! Returns the text at \a location, or an empty string if the cell hasn't been set.
+	const std::string& getCell( const ci::ivec2 &location ) const;
 
 	void setRow( size_t yloc, const std::vector<std::string> &textColumns );
 
-	void setCellHeight( float height )	            { mCellHeight = height; }
+	void	setCellHeight( float height );
+	float	getCellHeight() const					{ return mCellHeight; }
 	//! Sets the default color for all cells
-	void setTextColor( const ci::ColorA &color )	{ mTextColor = color; }
+	void setTextColor( const ci::ColorA &color );
+	//! Sets the default font for all cells
+	void setFont( const std::string &systemName, float fontSize = -1 );
 	//! Returns the number of rows currently set.
 	int getNumRows() const;
+	//! Returns the number of columns currently set.
+	int getNumColumns() const;
 	//! Removes all cells.
 	void clearCells();
-	
+
+	//! Returns the style used for cells that have no row, column or cell style.
+	const LabelGridStyleRef&	getDefaultStyle() const		{ return mDefaultStyle; }
+	//! Returns the style used for column 0 if no other column style has been set, which is right aligned.
+	const LabelGridStyleRef&	getFirstColumnStyle() const	{ return mFirstColumnStyle; }
+	//! Sets the style used for all cells in column \a xloc. Pass in null to reset to the default style.
+	void setColumnStyle( size_t xloc, const LabelGridStyleRef &style );
+	//! Sets the style used for all cells in row \a yloc, which takes precedence over column styles. Pass in null to reset.
+	void setRowStyle( size_t yloc, const LabelGridStyleRef &style );
+	//! Sets the style used for the cell at \a location, which takes precedence over row and column styles. Pass in null to reset.
+	void setCellStyle( const ci::ivec2 &location, const LabelGridStyleRef &style );
+
+	//! Returns the number of cells that were drawn last frame.
+	size_t getNumCellsDrawn() const		{ return mNumCellsDrawn; }
+
 protected:
-	void layout() override;
+	void draw( Renderer *ren ) override;
+
 private:
 	struct Cell {
-		ci::ivec2	mLocation;
-		LabelRef	mLabel;
+		std::string			mText;
+		LabelGridStyleRef	mStyle;
+		float				mTextWidth = 0;
+		const Text*			mMeasuredText = nullptr; // Text used to calculate mTextWidth, null if it needs to be re-measured
 	};
 
-	LabelRef	makeOrFindCell( const ci::ivec2 &location );
-
-	std::vector<Cell>	mCells;
-	ci::ivec2			mGridExtents = { 0, 0 }; // TODO: use uvec2 once it is added to cinder/Vector.h
-	float				mCellHeight = 20;
-	ci::ColorA			mTextColor = ci::ColorA::black();
+	Cell&						makeOrFindCell( const ci::ivec2 &location );
+	void						resize( int numColumns, int numRows );
+	const LabelGridStyleRef&	getStyle( const ci::ivec2 &location, const Cell &cell ) const;
+
+	std::vector<Cell>				mCells; // row-major, mNumColumns * mNumRows
+	int								mNumColumns = 0;
+	int								mNumRows = 0;
+	float							mCellHeight = 20;
+	LabelGridStyleRef				mDefaultStyle;
+	LabelGridStyleRef				mFirstColumnStyle;
+	std::vector<LabelGridStyleRef>	mColumnStyles;
+	std::vector<LabelGridStyleRef>	mRowStyles;
+	TextRef							mDefaultText;
+	size_t							mNumCellsDrawn = 0;
 };
 
 } // namespace vu
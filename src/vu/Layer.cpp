@@ -42,6 +42,40 @@ Rectf ceil( const Rectf &r )
 	return Rectf( ceilf( r.x1 ), ceilf( r.y1 ), ceilf( r.x2 ), ceilf( r.y2 ) );
 }
 
+// note: members are set directly as the Rectf constructor would reorder the corners of an empty result
+Rectf intersection( const Rectf &a, const Rectf &b )
+{
+	Rectf result;
+	result.x1 = std::max( a.x1, b.x1 );
+	result.y1 = std::max( a.y1, b.y1 );
+	result.x2 = std::min( a.x2, b.x2 );
+	result.y2 = std::min( a.y2, b.y2 );
+	return result;
+}
+
+bool isEmpty( const Rectf &r )
+{
+	return r.x1 >= r.x2 || r.y1 >= r.y2;
+}
+
+// Applies the View's position, followed by its scale and rotation around the transform origin (see View::calcLocalTransform()).
+void applyLocalTransform( const vu::View *view )
+{
+	gl::translate( view->getPos() );
+	if( view->hasTransform() ) {
+		const vec2 origin = view->getTransformOrigin();
+		gl::translate( origin );
+		gl::rotate( view->getRotation() );
+		gl::scale( view->getScale() );
+		gl::translate( - origin );
+	}
+}
+
+bool contains( const Rectf &outer, const Rectf &inner )
+{
+	return outer.x1 <= inner.x1 && outer.y1 <= inner.y1 && outer.x2 >= inner.x2 && outer.y2 >= inner.y2;
+}
+
 } // anonymous namespace
 
 namespace vu {
@@ -114,6 +148,14 @@ void Layer::updateView( View *view )
 
 	view->updateImpl();
 
+	// cache the world transform top-down, so it is a lookup for the rest of the frame (ex. in touch dispatch and drawing)
+	view->validateWorldTransform();
+
+	// Independent subtrees are collected and updated in parallel once the rest of the subviews are done.
+	// Not done when rendering to a FrameBuffer, since every subview contributes to this Layer's render bounds.
+	const bool updateInParallel = ! mRootView->mRendersToFrameBuffer && mGraph->canUpdateInParallel();
+	vector<View *> independentSubviews;
+
 	view->mIsIteratingSubviews = true;
 	for( auto &subview : view->getSubviews() ) {
 		if( subview->mMarkedForRemoval )
@@ -122,8 +164,17 @@ void Layer::updateView( View *view )
 		if( ! subview->mGraph )
 			subview->mGraph = mGraph;
 
+		if( updateInParallel && subview->mIndependentUpdate ) {
+			independentSubviews.push_back( subview.get() );
+			continue;
+		}
+
 		updateView( subview.get() );
 	}
+
+	if( ! independentSubviews.empty() ) {
+		mGraph->updateInParallel( view, independentSubviews, [this]( View *subview ) { updateView( subview ); } );
+	}
 	view->mIsIteratingSubviews = false;
 	view->clearViewsMarkedForRemoval();
 
@@ -192,11 +243,18 @@ void Layer::draw( Renderer *ren )
 		gl::clear( ColorA::zero() );
 	}
 
-	// draw the subtree of Views that this Layer is responsible for
-	drawView( mRootView, ren );
+	// draw the subtree of Views that this Layer is responsible for, culling those outside of the FrameBuffer or window
+	Rectf cullBounds;
+	if( mRootView->mRendersToFrameBuffer )
+		cullBounds = mRootView->toWorld( mRenderBounds );
+	else
+		cullBounds = Rectf( vec2( 0 ), vec2( mRootView->getGraph()->getClippingSize() ) );
+
+	drawView( mRootView, ren, cullBounds );
 
 	// Do any necessary Filter processing and compositing
 	if( mRootView->mRendersToFrameBuffer ) {
+		ren->flush();
 		gl::popMatrices();
 
 		if( ren->mScissorStack.size() > 1 ) {
@@ -220,20 +278,34 @@ void Layer::draw( Renderer *ren )
 		ren->pushBlendMode( BlendMode::PREMULT_ALPHA );
 		ren->pushColor( ColorA::gray( 1, getAlpha() ) );
 
+		// the FrameBuffer holds the root View in local coordinates, so it is composited with the root's transform
+		gl::ScopedModelMatrix modelScope;
+		applyLocalTransform( mRootView );
+
 		auto sourceArea = Area( ivec2( 0 ), ivec2( mRenderBounds.getSize() ) );
-		auto destRect = mRenderBounds + mRootView->getPos();
-		ren->draw( frameBuffer, sourceArea, destRect );
+		ren->draw( frameBuffer, sourceArea, mRenderBounds );
 		ren->popColor();
 		ren->popBlendMode();
 	}
 }
 
-void Layer::drawView( View *view, Renderer *ren )
+void Layer::drawView( View *view, Renderer *ren, const Rectf &cullBounds )
 {
 	if( view->isHidden() )
 		return;
 
+	const bool cullingEnabled = mGraph->isCullingEnabled();
+	Rectf subviewCullBounds = cullBounds;
 	if( view->isClipEnabled() ) {
+		if( cullingEnabled ) {
+			// nothing in the subtree can be seen if the clip is outside of the visible area
+			subviewCullBounds = intersection( cullBounds, view->getClipWorldBounds() );
+			if( isEmpty( subviewCullBounds ) ) {
+				mGraph->mDrawStats.mNumViewsCulled++;
+				return;
+			}
+		}
+
 		//CI_LOG_I( "beginClip: " << view->getName() );
 		pushClip( view, ren );
 	}
@@ -241,18 +313,61 @@ void Layer::drawView( View *view, Renderer *ren )
 	gl::ScopedModelMatrix modelScope;
 
 	if( view != mRootView || ! mRootView->mRendersToFrameBuffer )
-		gl::translate( view->getPos() );
+		applyLocalTransform( view );
+
+	// subviews aren't culled along with their parent, as they may draw outside of its bounds
+	const bool culled = cullingEnabled && ! cullBounds.intersects( view->toWorld( view->getBoundsForFrameBuffer() ) );
+	if( culled )
+		mGraph->mDrawStats.mNumViewsCulled++;
+
+	// the root of drawToFrameBuffer() is the one rendering the raster, so it draws normally
+	if( view->mShouldRasterize && ! ( mDrawingToFrameBuffer && view == mRootView ) ) {
+		// the raster includes the whole subtree but nothing outside of getBoundsForFrameBuffer()
+		if( ! culled ) {
+			drawRasterized( view, ren );
+			mGraph->mDrawStats.mNumViewsDrawn++;
+		}
+	}
+	else {
+		if( ! culled ) {
+			// Views that draw with gl directly need any batched Renderer draws to be completed first
+			if( ! view->canBatchDraw() )
+				ren->flush();
+
+			view->drawImpl( ren );
+			mGraph->mDrawStats.mNumViewsDrawn++;
+		}
 
-	view->drawImpl( ren );
+		const auto &subviews = view->getSubviews();
 
-	for( auto &subview : view->getSubviews() ) {
-		auto subviewLayer = subview->getLayer();
-		if( subviewLayer ) {
-			subviewLayer->draw( ren );
+		// collect opaque subviews, Views beneath them that they fully cover can be skipped
+		const size_t occludersBegin = mOccluders.size();
+		if( cullingEnabled ) {
+			for( size_t i = 0; i < subviews.size(); i++ ) {
+				const auto &subview = subviews[i];
+				// a rotated View doesn't cover its bounding box, so it can't be used as an occluder
+				if( subview->isOpaque() && ! subview->isHidden() && ! subview->isTransparent() && subview->getFilters().empty() && subview->getRotation() == 0 )
+					mOccluders.push_back( { i, subview->toParent( subview->getBoundsLocal() ) } );
+			}
 		}
-		else {
-			drawView( subview.get(), ren );
+
+		for( size_t i = 0; i < subviews.size(); i++ ) {
+			const auto &subview = subviews[i];
+			if( mOccluders.size() > occludersBegin && isOccluded( subview.get(), i, occludersBegin ) ) {
+				mGraph->mDrawStats.mNumViewsOccluded++;
+				continue;
+			}
+
+			auto subviewLayer = subview->getLayer();
+			if( subviewLayer ) {
+				subviewLayer->draw( ren );
+			}
+			else {
+				drawView( subview.get(), ren, subviewCullBounds );
+			}
 		}
+
+		mOccluders.resize( occludersBegin );
 	}
 
 	if( view->isClipEnabled() ) {
@@ -261,6 +376,102 @@ void Layer::drawView( View *view, Renderer *ren )
 	}
 }
 
+bool Layer::isOccluded( View *view, size_t index, size_t occludersBegin ) const
+{
+	// without clipping, subviews could draw outside of the covered area
+	if( ! view->getSubviews().empty() && ! view->isClipEnabled() )
+		return false;
+
+	const Rectf bounds = view->toParent( view->getBoundsForFrameBuffer() );
+	for( size_t i = occludersBegin; i < mOccluders.size(); i++ ) {
+		const auto &occluder = mOccluders[i];
+		if( occluder.mIndex > index && contains( occluder.mBounds, bounds ) )
+			return true;
+	}
+
+	return false;
+}
+
+void Layer::drawToFrameBuffer( Renderer *ren, const FrameBufferRef &frameBuffer, const Rectf &bounds, float scale )
+{
+	ren->pushFrameBuffer( frameBuffer );
+
+	// start without any of the current draw's clipping, which is in window coordinates
+	auto scissorStack = move( ren->mScissorStack );
+	ren->mScissorStack.clear();
+	gl::context()->pushBoolState( GL_SCISSOR_TEST, GL_FALSE );
+
+	mDrawingToFrameBuffer = true;
+
+	// draw as if the root View renders to mFrameBuffer, so that it isn't offset by its position and clipping is relative to the FrameBuffer
+	const bool rendersToFrameBuffer = mRootView->mRendersToFrameBuffer;
+	mRootView->mRendersToFrameBuffer = true;
+	mFrameBuffer = frameBuffer;
+	mRenderBounds = bounds;
+	mRenderScale = scale;
+
+	{
+		gl::ScopedViewport viewportScope( ivec2( 0 ), frameBuffer->getSize() );
+		gl::ScopedMatrices matricesScope;
+		gl::setMatricesWindow( frameBuffer->getSize() );
+		gl::scale( vec2( scale ) );
+		gl::translate( - bounds.getUpperLeft() );
+
+		gl::clear( ColorA::zero() );
+		drawView( mRootView, ren, mRootView->toWorld( bounds ) );
+		ren->flush();
+	}
+
+	mRootView->mRendersToFrameBuffer = rendersToFrameBuffer;
+	mDrawingToFrameBuffer = false;
+	gl::context()->popBoolState( GL_SCISSOR_TEST );
+	ren->mScissorStack = move( scissorStack );
+
+	ren->popFrameBuffer( frameBuffer );
+}
+
+void Layer::drawRasterized( View *view, Renderer *ren )
+{
+	const Rectf bounds = view->getBoundsForFrameBuffer();
+	const ivec2 size = ivec2( glm::ceil( bounds.getSize() * view->mRasterizationScale ) );
+	if( size.x <= 0 || size.y <= 0 )
+		return;
+
+	// Descendants draw with their combined alpha, so the raster also needs redrawing when an ancestor's alpha changes.
+	const float alpha = view->getAlphaCombined();
+	auto &frameBuffer = view->mRasterFrameBuffer;
+	if( ! frameBuffer || frameBuffer->getWidth() < size.x || frameBuffer->getHeight() < size.y ) {
+		if( frameBuffer )
+			frameBuffer->setInUse( false );
+
+		frameBuffer = ren->getFrameBuffer( size );
+		view->mRasterDirty = true;
+	}
+
+	if( view->mRasterDirty || view->mRasterAlpha != alpha ) {
+		LOG_LAYER( "rasterizing view '" << view->getName() << "', size: " << size );
+		// the Layer is kept along with the raster, so that re-rasterizing doesn't allocate one each time
+		auto &layer = view->mRasterLayer;
+		if( ! layer )
+			layer = make_shared<Layer>( view );
+
+		layer->mGraph = mGraph;
+		layer->drawToFrameBuffer( ren, frameBuffer, bounds, view->mRasterizationScale );
+
+		view->mRasterDirty = false;
+		view->mRasterAlpha = alpha;
+	}
+
+	// keep the FrameBuffer from being handed out by the Renderer while the raster is held
+	frameBuffer->setInUse( true );
+
+	ren->pushBlendMode( BlendMode::PREMULT_ALPHA );
+	ren->pushColor( ColorA::white() );
+	ren->draw( frameBuffer, Area( ivec2( 0 ), size ), bounds );
+	ren->popColor();
+	ren->popBlendMode();
+}
+
 void Layer::processFilters( Renderer *ren, const FrameBufferRef &renderFrameBuffer )
 {
 	// mark the main FrameBuffer as in use while processing Filters, so it doesn't seem available when configuring
@@ -322,15 +533,16 @@ void Layer::pushClip( View *view, Renderer *ren )
 	vec2 clipLowerLeft = viewWorldBounds.getLowerLeft();
 	vec2 clipSize = viewWorldBounds.getSize();
 	if( mRootView->mRendersToFrameBuffer ) {
-		// get bounds of view relative to framebuffer. // TODO: need a method like convertPointToView( view, point );
- 		Rectf viewBoundsInFrameBuffer = viewWorldBounds - mRootView->getWorldPos();
+		// get bounds of view relative to framebuffer, which is in the root View's local coordinates
+		Rectf viewBoundsInFrameBuffer = mRootView->toLocal( viewWorldBounds ).scaled( mRenderScale );
 
 		// Take lower left relative to FrameBuffer, which might actually be larger than mRenderBounds
 		clipLowerLeft = viewBoundsInFrameBuffer.getLowerLeft();
 		clipLowerLeft.y = mFrameBuffer->getHeight() - clipLowerLeft.y;
 
 		// - needed to add it when rendering to virtual canvas but stroked rect went beyond borders
-		clipLowerLeft.y += mRenderBounds.y1;
+		clipLowerLeft.y += mRenderBounds.y1 * mRenderScale;
+		clipSize = viewBoundsInFrameBuffer.getSize();
 	}
 	else {
 		// rendering to window, flip y relative to Graph's bottom left using its clipping size
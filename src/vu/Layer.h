@@ -25,6 +25,7 @@
 #include "vu/Filter.h"
 
 #include <memory>
+#include <vector>
 
 namespace vu {
 
@@ -60,7 +61,14 @@ class CI_UI_API Layer : public std::enable_shared_from_this<Layer> {
 	void markForRemoval()               { mShouldRemove = true; }
 	void init();
 	void updateView( View *view );
-	void drawView( View *view, Renderer *ren );
+	//! Draws \a view and its subviews, skipping those that are outside of \a cullBounds (in world coordinates).
+	void drawView( View *view, Renderer *ren, const ci::Rectf &cullBounds );
+	//! Returns true if \a view, at \a index in its parent's subviews, is completely covered by an opaque sibling above it.
+	bool isOccluded( View *view, size_t index, size_t occludersBegin ) const;
+	//! Draws \a view from its rasterized FrameBuffer, first rendering it if the subtree changed. See View::setShouldRasterize().
+	void drawRasterized( View *view, Renderer *ren );
+	//! Draws the subtree into \a frameBuffer without compositing, with \a bounds (in the root View's coordinates) scaled by \a scale to fill it. Used by Graph::renderToImage().
+	void drawToFrameBuffer( Renderer *ren, const FrameBufferRef &frameBuffer, const ci::Rectf &bounds, float scale );
 	void processFilters( Renderer *ren, const FrameBufferRef &renderFrameBuffer );
 	void pushClip( View *view, Renderer *ren );
 
@@ -68,6 +76,15 @@ class CI_UI_API Layer : public std::enable_shared_from_this<Layer> {
 	Graph*          mGraph;
 	FrameBufferRef	mFrameBuffer;
 	ci::Rectf       mRenderBounds = ci::Rectf::zero();
+	float			mRenderScale = 1;
+	bool			mDrawingToFrameBuffer = false;
+
+	struct Occluder {
+		size_t		mIndex;		// index within the parent's subviews
+		ci::Rectf	mBounds;	// in the parent's coordinates
+	};
+
+	std::vector<Occluder>	mOccluders; // opaque subviews for each level of drawView(), reused between frames
 
 	bool			mFiltersNeedConfiguration = false;
 	bool            mShouldRemove = false;
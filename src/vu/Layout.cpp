@@ -24,7 +24,11 @@
 #include "vu/Layout.h"
 #include "vu/View.h"
 
+#include "cinder/CinderAssert.h"
+#include "glm/gtc/epsilon.hpp"
+
 #include <functional>
+#include <limits>
 #include <numeric>
 
 using namespace ci;
@@ -32,16 +36,44 @@ using namespace std;
 
 namespace vu {
 
-namespace {
+// ----------------------------------------------------------------------------------------------------
+// Layout
+// ----------------------------------------------------------------------------------------------------
 
-void updateAxisPos( const ViewRef &view, float position, int axis )
+void Layout::loadSubviewBounds( View *view )
 {
-	auto current = view->getPos();
-	current[axis] = position;
-	view->setPos( current );
+	const auto &subviews = view->getSubviews();
+	mSubviewBounds.resize( subviews.size() );
+	for( size_t i = 0; i < subviews.size(); i++ ) {
+		mSubviewBounds[i].mPos = subviews[i]->getPos();
+		mSubviewBounds[i].mSize = subviews[i]->getSize();
+	}
 }
 
-} // anonymous namespace
+void Layout::commitSubviewBounds( View *view )
+{
+	const auto &subviews = view->getSubviews();
+	CI_ASSERT( subviews.size() == mSubviewBounds.size() );
+
+	for( size_t i = 0; i < subviews.size(); i++ ) {
+		const auto &bounds = mSubviewBounds[i];
+		const auto &subview = subviews[i];
+		if( subview->getPos() != bounds.mPos || subview->getSize() != bounds.mSize ) {
+			subview->setBounds( Rectf( bounds.mPos, bounds.mPos + bounds.mSize ) );
+		}
+	}
+}
+
+void Layout::invalidateViews()
+{
+	for( View *view : mViews ) {
+		view->invalidateIntrinsicSize();
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// LinearLayout
+// ----------------------------------------------------------------------------------------------------
 
 LinearLayout::LinearLayout( Orientation orientation, Mode mode, Alignment alignment )
 	: mOrientation( orientation ), mMode( mode ), mAlignment( alignment )
@@ -53,59 +85,57 @@ void LinearLayout::layout( View *view )
 {
 	int axis = (int)mOrientation;
 	int axis2 = ( axis + 1 ) % 2;
-	const auto subviews = view->getSubviews();
+
+	loadSubviewBounds( view );
+	const size_t numSubviews = mSubviewBounds.size();
 
 	vec2 containerSize = view->getSize();
 	float containerSizeMinusMargins = containerSize[axis] - mMargin.getUpperLeft()[axis] - mMargin.getLowerRight()[axis];
-	float paddingTotal = glm::max( 0.0f, float( subviews.size() ) - 1.0f ) * mPadding;
-	float subviewsTotal = std::accumulate( subviews.begin(), subviews.end(), 0.0f, [&] ( float sum, const ViewRef &view ) {
-		return sum + view->getSize()[axis];
-	} );
+	float paddingTotal = glm::max( 0.0f, float( numSubviews ) - 1.0f ) * mPadding;
+	float subviewsTotal = 0;
+	for( const auto &bounds : mSubviewBounds ) {
+		subviewsTotal += bounds.mSize[axis];
+	}
 
 	// Update layout based on selected mode and primary axis.
 	float offset = mMargin.getUpperLeft()[axis];
-	for( auto &subview : subviews ) {
+	for( auto &bounds : mSubviewBounds ) {
 		if( mMode == Mode::DISTRIBUTE ) {
-			offset += ( containerSizeMinusMargins - subviewsTotal ) / float( subviews.size() + 1 );
-			updateAxisPos( subview, offset, axis );
-			offset += subview->getSize()[axis];
+			offset += ( containerSizeMinusMargins - subviewsTotal ) / float( numSubviews + 1 );
+			bounds.mPos[axis] = offset;
+			offset += bounds.mSize[axis];
 		}
 		else if( mMode == Mode::FILL ) {
-			vec2 size = subview->getSize();
-			size[axis] = ( containerSizeMinusMargins - paddingTotal ) / float( subviews.size() );
-			subview->setSize( size );
-			updateAxisPos( subview, offset, axis );
-			offset += subview->getSize()[axis] + mPadding;
+			bounds.mSize[axis] = glm::max( 0.0f, ( containerSizeMinusMargins - paddingTotal ) / float( numSubviews ) );
+			bounds.mPos[axis] = offset;
+			offset += bounds.mSize[axis] + mPadding;
 		}
 		else {
-			updateAxisPos( subview, offset, axis );
-			offset += subview->getSize()[axis] + mPadding;
+			bounds.mPos[axis] = offset;
+			offset += bounds.mSize[axis] + mPadding;
 		}
 	}
 
 	// Update alignment of all subviews on secondary axis.
 	offset = mMargin.getUpperLeft()[axis2];
 	containerSizeMinusMargins = containerSize[axis2] - mMargin.getUpperLeft()[axis2] - mMargin.getLowerRight()[axis2];
-	for( auto &subview : subviews ) {
+	for( auto &bounds : mSubviewBounds ) {
 		if( mAlignment == Alignment::MINIMUM ) {
-			updateAxisPos( subview, offset, axis2 );
+			bounds.mPos[axis2] = offset;
 		}
 		else if( mAlignment == Alignment::MIDDLE ) {
-			float center = 0.5f * ( containerSize[axis2] - subview->getSize()[axis2] );
-			updateAxisPos( subview, center, axis2 );
+			bounds.mPos[axis2] = 0.5f * ( containerSize[axis2] - bounds.mSize[axis2] );
 		}
 		else if( mAlignment == Alignment::MAXIMUM ) {
-			float pos = containerSize[axis2] - mMargin.getLowerRight()[axis2] - subview->getSize()[axis2];
-			updateAxisPos( subview, pos, axis2 );
+			bounds.mPos[axis2] = containerSize[axis2] - mMargin.getLowerRight()[axis2] - bounds.mSize[axis2];
 		}
 		else if( mAlignment == Alignment::FILL ) {
-			updateAxisPos( subview, offset, axis2 );
-
-			auto currentSize = subview->getSize();
-			currentSize[axis2] = containerSizeMinusMargins;
-			subview->setSize( currentSize );
+			bounds.mPos[axis2] = offset;
+			bounds.mSize[axis2] = glm::max( 0.0f, containerSizeMinusMargins );
 		}
 	}
+
+	commitSubviewBounds( view );
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -119,21 +149,22 @@ GridLayout::GridLayout()
 void GridLayout::setResolution( size_t resolution )
 { 
 	mResolution = std::max<size_t>( resolution, 1 );
+	invalidateViews();
 }
 
 void GridLayout::layout( View *view )
 {
 	vec2 containerSize = view->getSize();
-	const auto subviews = view->getSubviews();
+	loadSubviewBounds( view );
 
 	float totalPadding = mResolution > 1 ? mPadding * ( mResolution - 1 ) : 0;
-	const float cellWidth = ( containerSize.x - mMargin.x1 - mMargin.x2 ) / (float)mResolution - totalPadding;
+	const float cellWidth = glm::max( 0.0f, ( containerSize.x - mMargin.x1 - mMargin.x2 ) / (float)mResolution - totalPadding );
 
 	vec2 pos = mMargin.getUpperLeft();
 	ivec2 currentCell = ivec2( 0 );
-	for( auto &subview : subviews ) {
-		subview->setPos( pos );
-		subview->setSize( vec2( cellWidth, subview->getHeight() ) ); 
+	for( auto &bounds : mSubviewBounds ) {
+		bounds.mPos = pos;
+		bounds.mSize.x = cellWidth;
 
 		currentCell.x += 1;
 		pos.x += cellWidth + mPadding;
@@ -142,9 +173,218 @@ void GridLayout::layout( View *view )
 			currentCell.y += 1;
 
 			pos.x = mMargin.x1;
-			pos.y += subview->getHeight() + mPadding;
+			pos.y += bounds.mSize.y + mPadding;
 		}
 	}
+
+	commitSubviewBounds( view );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// FlexLayout
+// ----------------------------------------------------------------------------------------------------
+
+FlexLayout::FlexLayout( Direction direction )
+	: mDirection( direction )
+{
+}
+
+vec2 FlexLayout::calcLines( View *view, float availableMain )
+{
+	const int axis = getMainAxis();
+	const int crossAxis = ( axis + 1 ) % 2;
+	const auto &subviews = view->getSubviews();
+
+	// Resolve intrinsic sizes first, they are cached on each View. This needs to happen before using mItems,
+	// since subviews may use this same FlexLayout and recurse back in here.
+	for( const auto &subview : subviews ) {
+		subview->getIntrinsicSize();
+	}
+
+	mItems.clear();
+	mLines.clear();
+
+	for( const auto &subview : subviews ) {
+		View *v = subview.get();
+
+		// Track the size the View had before we flexed it, so that our own output isn't used as the next basis.
+		if( ! v->mFlexLaidOut || glm::any( glm::epsilonNotEqual( v->getSize(), v->mFlexLayoutSize, 0.01f ) ) ) {
+			v->mFlexBaseSize = v->getSize();
+		}
+
+		vec2 base = v->mFlexBaseSize;
+		const vec2 &intrinsicSize = v->mIntrinsicSize;
+		for( int i = 0; i < 2; i++ ) {
+			if( intrinsicSize[i] >= 0 )
+				base[i] = intrinsicSize[i];
+		}
+
+		const auto &flex = v->getFlexItem();
+		if( flex.mBasis >= 0 )
+			base[axis] = flex.mBasis;
+
+		Item item;
+		item.mView = v;
+		item.mBaseMain = item.mMain = base[axis];
+		item.mBaseCross = item.mCross = base[crossAxis];
+		item.mGrow = std::max( 0.0f, flex.mGrow );
+		item.mShrink = std::max( 0.0f, flex.mShrink );
+		mItems.push_back( item );
+	}
+
+	// Break items into lines
+	size_t lineBegin = 0;
+	float lineMain = 0;
+	float lineCross = 0;
+	vec2 contentSize = vec2( 0 ); // main, cross
+	for( size_t i = 0; i <= mItems.size(); i++ ) {
+		const bool lastItem = i == mItems.size();
+		const bool breakLine = ! lastItem && mWrap && i > lineBegin && lineMain + mPadding + mItems[i].mBaseMain > availableMain;
+		if( ( lastItem && i > lineBegin ) || breakLine ) {
+			mLines.push_back( { lineBegin, i, lineCross } );
+			contentSize.x = std::max( contentSize.x, lineMain );
+			contentSize.y += lineCross;
+			lineBegin = i;
+			lineMain = 0;
+			lineCross = 0;
+		}
+
+		if( lastItem )
+			break;
+
+		lineMain += ( i > lineBegin ? mPadding : 0 ) + mItems[i].mBaseMain;
+		lineCross = std::max( lineCross, mItems[i].mBaseCross );
+	}
+
+	if( mLines.size() > 1 )
+		contentSize.y += mPadding * float( mLines.size() - 1 );
+
+	return contentSize;
+}
+
+vec2 FlexLayout::calcContentSize( View *view )
+{
+	const int axis = getMainAxis();
+	const int crossAxis = ( axis + 1 ) % 2;
+	const vec2 marginMin = mMargin.getUpperLeft();
+	const vec2 marginMax = mMargin.getLowerRight();
+
+	// When wrapping, the main size is constrained by the View and content grows along the cross axis.
+	float availableMain = mWrap ? view->getSize()[axis] - marginMin[axis] - marginMax[axis] : numeric_limits<float>::max();
+	vec2 contentSize = calcLines( view, availableMain );
+
+	vec2 result;
+	result[axis] = contentSize.x + marginMin[axis] + marginMax[axis];
+	result[crossAxis] = contentSize.y + marginMin[crossAxis] + marginMax[crossAxis];
+	return result;
+}
+
+void FlexLayout::layout( View *view )
+{
+	const int axis = getMainAxis();
+	const int crossAxis = ( axis + 1 ) % 2;
+	const vec2 containerSize = view->getSize();
+	const vec2 marginMin = mMargin.getUpperLeft();
+	const vec2 marginMax = mMargin.getLowerRight();
+	const float availableMain = containerSize[axis] - marginMin[axis] - marginMax[axis];
+	const float availableCross = containerSize[crossAxis] - marginMin[crossAxis] - marginMax[crossAxis];
+
+	calcLines( view, availableMain );
+
+	// A single line container's line fills the cross axis
+	if( ! mWrap && mLines.size() == 1 ) {
+		mLines[0].mCross = availableCross;
+	}
+
+	float crossOffset = marginMin[crossAxis];
+	for( const auto &line : mLines ) {
+		const size_t numItems = line.mEnd - line.mBegin;
+		const float gaps = mPadding * float( numItems - 1 );
+
+		// Resolve flexible lengths
+		float baseTotal = gaps;
+		float growTotal = 0;
+		float scaledShrinkTotal = 0;
+		for( size_t i = line.mBegin; i < line.mEnd; i++ ) {
+			const auto &item = mItems[i];
+			baseTotal += item.mBaseMain;
+			growTotal += item.mGrow;
+			scaledShrinkTotal += item.mShrink * item.mBaseMain;
+		}
+
+		const float freeSpace = availableMain - baseTotal;
+		float usedTotal = gaps;
+		for( size_t i = line.mBegin; i < line.mEnd; i++ ) {
+			auto &item = mItems[i];
+			if( freeSpace > 0 && growTotal > 0 )
+				item.mMain = item.mBaseMain + freeSpace * item.mGrow / growTotal;
+			else if( freeSpace < 0 && scaledShrinkTotal > 0 )
+				item.mMain = std::max( 0.0f, item.mBaseMain + freeSpace * item.mShrink * item.mBaseMain / scaledShrinkTotal );
+
+			usedTotal += item.mMain;
+		}
+
+		// Justify remaining space along the main axis. Distributed modes fall back to START when overflowing.
+		const float remaining = availableMain - usedTotal;
+		float leading = 0;
+		float between = mPadding;
+		switch( mJustify ) {
+			case Justify::END:
+				leading = remaining;
+			break;
+			case Justify::CENTER:
+				leading = remaining / 2;
+			break;
+			case Justify::SPACE_BETWEEN:
+				if( remaining > 0 && numItems > 1 )
+					between += remaining / float( numItems - 1 );
+			break;
+			case Justify::SPACE_AROUND:
+				if( remaining > 0 ) {
+					leading = remaining / float( numItems ) / 2;
+					between += remaining / float( numItems );
+				}
+			break;
+			case Justify::SPACE_EVENLY:
+				if( remaining > 0 ) {
+					leading = remaining / float( numItems + 1 );
+					between += leading;
+				}
+			break;
+			default:
+			break;
+		}
+
+		// Align along the cross axis and commit
+		float mainPos = leading;
+		for( size_t i = line.mBegin; i < line.mEnd; i++ ) {
+			auto &item = mItems[i];
+			const auto &flex = item.mView->getFlexItem();
+			const Alignment alignment = flex.mOverrideAlignment ? flex.mAlignSelf : mAlignItems;
+
+			float crossPos = 0;
+			if( alignment == Alignment::MIDDLE )
+				crossPos = ( line.mCross - item.mCross ) / 2;
+			else if( alignment == Alignment::MAXIMUM )
+				crossPos = line.mCross - item.mCross;
+			else if( alignment == Alignment::FILL )
+				item.mCross = line.mCross;
+
+			vec2 pos, size;
+			pos[axis] = marginMin[axis] + ( isReversed() ? availableMain - mainPos - item.mMain : mainPos );
+			pos[crossAxis] = crossOffset + crossPos;
+			size[axis] = item.mMain;
+			size[crossAxis] = item.mCross;
+
+			item.mView->setBounds( Rectf( pos, pos + size ) );
+			item.mView->mFlexLayoutSize = item.mView->getSize();
+			item.mView->mFlexLaidOut = true;
+
+			mainPos += item.mMain + between;
+		}
+
+		crossOffset += line.mCross + mPadding;
+	}
 }
 
 } // namespace vu
@@ -26,6 +26,7 @@
 #include "vu/Export.h"
 #include "cinder/Rect.h"
 #include <memory>
+#include <vector>
 
 namespace vu {
 
@@ -36,25 +37,49 @@ typedef std::shared_ptr<class BoxLayout>			BoxLayoutRef;
 typedef std::shared_ptr<class LinearLayout>			LinearLayoutRef;
 typedef std::shared_ptr<class VerticalLayout>		VerticalLayoutRef;
 typedef std::shared_ptr<class HorizontalLayout>		HorizontalLayoutRef;
+typedef std::shared_ptr<class FlexLayout>			FlexLayoutRef;
 
 class CI_UI_API Layout {
   public:
 
 	virtual void layout( View *view )	{}
+	//! Returns the size that \a view needs in order to fit all of its subviews without shrinking them, or a negative size if the Layout doesn't size based on content.
+	virtual ci::vec2 calcContentSize( View *view )	{ return ci::vec2( -1 ); }
+	//! Returns true if calcContentSize() depends on the size of the View being laid out, in which case resizing the View invalidates its intrinsic size.
+	virtual bool isContentSizeDependentOnSize() const	{ return false; }
 
 	//! Sets the margin around the bounds of the Layout object
-	void			setMargin( const ci::Rectf &margin ) { mMargin = margin; }
+	void			setMargin( const ci::Rectf &margin ) { mMargin = margin; invalidateViews(); }
 	//! Sets the margin around the bounds of the Layout object (all sides are the same)
 	void			setMargin( float margin )	{ setMargin( ci::Rectf( margin, margin, margin, margin ) ); }
 	//! Returns the margin around the bounds of the Layout object
 	const ci::Rectf&	getMargin() const	{ return mMargin; }
 
 	//! Sets the padding between successive Views.
-	void			setPadding( float padding ) { mPadding = padding; }
+	void			setPadding( float padding ) { mPadding = padding; invalidateViews(); }
 
   protected:
+	struct SubviewBounds {
+		ci::vec2	mPos;
+		ci::vec2	mSize;
+	};
+
+	//! Fills mSubviewBounds with the current bounds of \a view's subviews. The buffer is reused so this doesn't allocate after the first layout.
+	void	loadSubviewBounds( View *view );
+	//! Applies mSubviewBounds to \a view's subviews, only touching those whose pos or size actually changed.
+	void	commitSubviewBounds( View *view );
+	//! Invalidates the intrinsic size and layout of every View that uses this Layout. Called when a property that affects them changes.
+	void	invalidateViews();
+
 	ci::Rectf	mMargin = ci::Rectf( 0, 0, 0, 0 );
 	float		mPadding = 0;
+
+	std::vector<SubviewBounds>	mSubviewBounds;
+
+  private:
+	std::vector<View *>			mViews; // Views that use this Layout, maintained by View::setLayout()
+
+	friend class View;
 };
 
 /// The direction of data flow for a layout.
@@ -83,13 +108,13 @@ public:
 	explicit LinearLayout( Orientation orientation, Mode mode = Mode::INCREMENT, Alignment alignment = Alignment::MINIMUM );
 
 	Orientation		getOrientation() const { return mOrientation; }
-	void			setOrientation( Orientation orientation ) { mOrientation = orientation; }
+	void			setOrientation( Orientation orientation ) { mOrientation = orientation; invalidateViews(); }
 
 	Alignment		getAlignment() const { return mAlignment; }
-	void			setAlignment( Alignment alignment ) { mAlignment = alignment; }
+	void			setAlignment( Alignment alignment ) { mAlignment = alignment; invalidateViews(); }
 
 	//! Sets the mode used for laying out views
-	void			setMode( Mode mode )	{ mMode = mode; }
+	void			setMode( Mode mode )	{ mMode = mode; invalidateViews(); }
 	//! Returns the mode used for laying out views
 	Mode			getMode() const		{ return mMode; }
 
@@ -123,7 +148,7 @@ public:
 	//void setCellSize( const ci::vec2 &size )	{ mCellSize = size; }
 
 	Orientation		getOrientation() const { return mOrientation; }
-	void			setOrientation( Orientation orientation ) { mOrientation = orientation; }
+	void			setOrientation( Orientation orientation ) { mOrientation = orientation; invalidateViews(); }
 
 	void			setResolution( size_t resolution );
 
@@ -135,5 +160,87 @@ private:
 	Orientation	mOrientation = Orientation::VERTICAL;
 };
 
+// ----------------------------------------------------------------------------------------------------
+// FlexLayout
+// ----------------------------------------------------------------------------------------------------
+
+//! Per-View properties used by FlexLayout, set with View::setFlexItem().
+struct CI_UI_API FlexItem {
+	//! How much of the remaining space along the main axis this View takes, relative to its siblings.
+	float		mGrow = 0;
+	//! How much this View shrinks relative to its siblings when there isn't enough space along the main axis.
+	float		mShrink = 1;
+	//! The starting size along the main axis. If < 0, the View's intrinsic size is used if it has one, otherwise the size it was given before being laid out.
+	float		mBasis = -1;
+	//! If true, mAlignSelf is used instead of the FlexLayout's cross axis alignment.
+	bool		mOverrideAlignment = false;
+	Alignment	mAlignSelf = Alignment::MINIMUM;
+};
+
+//! Lays out subviews using the CSS flexbox algorithm. Layout::setPadding() is used as the gap between items and between lines.
+class CI_UI_API FlexLayout : public Layout {
+  public:
+	enum class Direction : uint8_t {
+		ROW = 0,
+		ROW_REVERSE,
+		COLUMN,
+		COLUMN_REVERSE
+	};
+
+	enum class Justify : uint8_t {
+		START = 0,
+		END,
+		CENTER,
+		SPACE_BETWEEN,
+		SPACE_AROUND,
+		SPACE_EVENLY
+	};
+
+	explicit FlexLayout( Direction direction = Direction::ROW );
+
+	void		setDirection( Direction direction )		{ mDirection = direction; invalidateViews(); }
+	Direction	getDirection() const					{ return mDirection; }
+	//! Sets whether subviews wrap onto multiple lines when they don't fit along the main axis. Default is false.
+	void		setWrapEnabled( bool enable = true )	{ mWrap = enable; invalidateViews(); }
+	bool		isWrapEnabled() const					{ return mWrap; }
+	//! Sets how remaining space is distributed along the main axis.
+	void		setJustify( Justify justify )			{ mJustify = justify; invalidateViews(); }
+	Justify		getJustify() const						{ return mJustify; }
+	//! Sets how subviews are aligned along the cross axis within each line. Alignment::FILL stretches them.
+	void		setAlignItems( Alignment alignment )	{ mAlignItems = alignment; invalidateViews(); }
+	Alignment	getAlignItems() const					{ return mAlignItems; }
+
+	void		layout( View *view ) override;
+	ci::vec2	calcContentSize( View *view ) override;
+	//! When wrapping, lines are broken at the View's size along the main axis.
+	bool		isContentSizeDependentOnSize() const override	{ return mWrap; }
+
+  private:
+	struct Item {
+		View*	mView;
+		float	mBaseMain, mBaseCross;	// hypothetical sizes before flexing
+		float	mMain, mCross;			// final sizes
+		float	mGrow, mShrink;
+	};
+
+	struct Line {
+		size_t	mBegin, mEnd;	// range in mItems
+		float	mCross;			// cross size of the line
+	};
+
+	//! Fills mItems and mLines for \a view, using \a availableMain to break lines. Returns the size of the content, not including margins.
+	ci::vec2	calcLines( View *view, float availableMain );
+	int			getMainAxis() const		{ return mDirection == Direction::ROW || mDirection == Direction::ROW_REVERSE ? 0 : 1; }
+	bool		isReversed() const		{ return mDirection == Direction::ROW_REVERSE || mDirection == Direction::COLUMN_REVERSE; }
+
+	Direction	mDirection;
+	Justify		mJustify = Justify::START;
+	Alignment	mAlignItems = Alignment::MINIMUM;
+	bool		mWrap = false;
+
+	// scratch buffers that are reused between calls to layout()
+	std::vector<Item>	mItems;
+	std::vector<Line>	mLines;
+};
 
 } // namespace vu
@@ -27,6 +27,7 @@
 #include "cinder/gl/draw.h"
 #include "cinder/gl/scoped.h"
 #include "cinder/gl/Fbo.h"
+#include "cinder/gl/VboMesh.h"
 #include "cinder/Log.h"
 
 //#define LOG_FRAMEBUFFER( stream )	CI_LOG_I( stream )
@@ -192,6 +193,12 @@ void Renderer::popColor()
 }
 
 void Renderer::setBlendMode( BlendMode mode )
+{
+	flush();
+	applyBlendMode( mode );
+}
+
+void Renderer::applyBlendMode( BlendMode mode )
 {
 #if 0
 	switch( mode ) {
@@ -222,16 +229,23 @@ void Renderer::setBlendMode( BlendMode mode )
 
 void Renderer::pushBlendMode( BlendMode mode )
 {
+	if( mode != mBlendModeStack.back() )
+		flush();
+
 	mBlendModeStack.push_back( mode );
-	setBlendMode( mode );
+	applyBlendMode( mode );
 }
 
 void Renderer::popBlendMode()
 {
+	BlendMode poppedMode = mBlendModeStack.back();
 	mBlendModeStack.pop_back();
 	CI_ASSERT_MSG( ! mBlendModeStack.empty(), "BlendMode stack underflow" );
 
-	setBlendMode( mBlendModeStack.back() );
+	if( poppedMode != mBlendModeStack.back() )
+		flush();
+
+	applyBlendMode( mBlendModeStack.back() );
 }
 
 FrameBufferRef Renderer::getFrameBuffer( const ci::ivec2 &size )
@@ -305,18 +319,21 @@ void Renderer::clearUnusedFrameBuffers()
 
 void Renderer::pushFrameBuffer( const FrameBufferRef &frameBuffer )
 {
+	flush();
 	frameBuffer->setInUse( true );
 	gl::context()->pushFramebuffer( frameBuffer->mFbo );
 }
 
 void Renderer::popFrameBuffer( const FrameBufferRef &frameBuffer )
 {
+	flush();
 	frameBuffer->setInUse( false );
 	gl::context()->popFramebuffer();
 }
 
 void Renderer::pushClip( const ci::ivec2 &lowerLeft, const ci::ivec2 &size )
 {
+	flush();
 	gl::context()->pushBoolState( GL_SCISSOR_TEST, GL_TRUE );	
 	gl::context()->pushScissor( { lowerLeft, size } );
 
@@ -325,6 +342,7 @@ void Renderer::pushClip( const ci::ivec2 &lowerLeft, const ci::ivec2 &size )
 
 void Renderer::popClip()
 {
+	flush();
 	gl::context()->popBoolState( GL_SCISSOR_TEST );
 	gl::context()->popScissor();
 
@@ -351,6 +369,8 @@ std::string Renderer::printCurrentFrameBuffersToString() const
 
 void Renderer::draw( const FrameBufferRef &frameBuffer, const Rectf &destRect )
 {
+	flush();
+
 	if( ! mGlslFrameBuffer ) {
 		try {
 			// TODO: add support for drawing partial textures
@@ -371,11 +391,17 @@ void Renderer::draw( const FrameBufferRef &frameBuffer, const Rectf &destRect )
 
 void Renderer::draw( const FrameBufferRef &frameBuffer, const ci::Area &sourceArea, const ci::Rectf &destRect )
 {
+	flush();
 	gl::draw( frameBuffer->mFbo->getColorTexture(), sourceArea, destRect );
 }
 
 void Renderer::draw( const ImageRef &image, const ci::Rectf &destRect )
 {
+	if( image->isTextureRegion() ) {
+		drawBatchedImage( image, destRect );
+		return;
+	}
+
 	if( ! mBatchImage ) {
 		mBatchImage = gl::Batch::create( geom::Rect( Rectf( 0, 0, 1, 1 ) ), gl::getStockShader( gl::ShaderDef().color().texture() ) );
 	}
@@ -385,6 +411,8 @@ void Renderer::draw( const ImageRef &image, const ci::Rectf &destRect )
 
 void Renderer::draw( const ImageRef &image, const ci::Rectf &destRect, const ci::gl::BatchRef &batch )
 {
+	flush();
+
 	gl::ScopedTextureBind texScope( image->mTexture );
 
 	gl::ScopedModelMatrix modelScope;
@@ -393,8 +421,78 @@ void Renderer::draw( const ImageRef &image, const ci::Rectf &destRect, const ci:
 	batch->draw();
 }
 
+void Renderer::drawBatchedImage( const ImageRef &image, const ci::Rectf &destRect )
+{
+	if( mBatchTexture != image->mTexture ) {
+		flush();
+		mBatchTexture = image->mTexture;
+	}
+
+	// Vertices are transformed on the CPU, so that Images drawn by different Views can share a single draw call.
+	const mat4 &modelMatrix = gl::getModelMatrix();
+	const ColorA color = gl::context()->getCurrentColor();
+	const Rectf &tc = image->mTexCoords;
+
+	auto vert = [&]( float x, float y, float u, float v ) {
+		vec4 pos = modelMatrix * vec4( x, y, 0, 1 );
+		mBatchVertices.push_back( { vec2( pos ), vec2( u, v ), color } );
+	};
+
+	vert( destRect.x1, destRect.y1, tc.x1, tc.y1 );
+	vert( destRect.x2, destRect.y1, tc.x2, tc.y1 );
+	vert( destRect.x2, destRect.y2, tc.x2, tc.y2 );
+
+	vert( destRect.x1, destRect.y1, tc.x1, tc.y1 );
+	vert( destRect.x2, destRect.y2, tc.x2, tc.y2 );
+	vert( destRect.x1, destRect.y2, tc.x1, tc.y2 );
+
+	mNumBatchedImagesDrawn++;
+}
+
+void Renderer::flush()
+{
+	if( mBatchVertices.empty() )
+		return;
+
+	// grow the vertex buffer as needed, recreating the Batch that references it
+	if( mBatchVertices.size() > mBatchCapacity ) {
+		mBatchCapacity = std::max<size_t>( mBatchVertices.size(), mBatchCapacity * 2 );
+		mBatchVbo = gl::Vbo::create( GL_ARRAY_BUFFER, mBatchCapacity * sizeof( BatchVertex ), nullptr, GL_STREAM_DRAW );
+
+		const size_t stride = sizeof( BatchVertex );
+		geom::BufferLayout layout;
+		layout.append( geom::Attrib::POSITION, 2, stride, offsetof( BatchVertex, mPos ) );
+		layout.append( geom::Attrib::TEX_COORD_0, 2, stride, offsetof( BatchVertex, mTexCoord ) );
+		layout.append( geom::Attrib::COLOR, 4, stride, offsetof( BatchVertex, mColor ) );
+
+		auto mesh = gl::VboMesh::create( (uint32_t)mBatchCapacity, GL_TRIANGLES, { { layout, mBatchVbo } } );
+		mBatchImageRegions = gl::Batch::create( mesh, gl::getStockShader( gl::ShaderDef().color().texture() ) );
+	}
+
+	mBatchVbo->bufferSubData( 0, mBatchVertices.size() * sizeof( BatchVertex ), mBatchVertices.data() );
+
+	{
+		gl::ScopedTextureBind texScope( mBatchTexture );
+		gl::ScopedModelMatrix modelScope;
+		gl::setModelMatrix( mat4() );
+		mBatchImageRegions->draw( 0, (GLsizei)mBatchVertices.size() );
+	}
+
+	mNumImageBatchesDrawn++;
+	mBatchVertices.clear();
+	mBatchTexture = nullptr;
+}
+
+void Renderer::resetBatchStats()
+{
+	mNumImageBatchesDrawn = 0;
+	mNumBatchedImagesDrawn = 0;
+}
+
 void Renderer::drawSolidRect( const Rectf &rect )
 {
+	flush();
+
 	if( ! mBatchSolidRect ) {
 		mBatchSolidRect = gl::Batch::create( geom::Rect( Rectf( 0, 0, 1, 1 ) ), gl::getStockShader( gl::ShaderDef().color() ) );
 	}
@@ -407,11 +505,13 @@ void Renderer::drawSolidRect( const Rectf &rect )
 
 void Renderer::drawStrokedRect( const Rectf &rect )
 {
+	flush();
 	gl::drawStrokedRect( rect );
 }
 
 void Renderer::drawStrokedRect( const Rectf &rect, float lineWidth )
 {
+	flush();
 	gl::drawStrokedRect( rect, lineWidth );
 }
 
@@ -39,6 +39,7 @@ namespace gl {
 typedef std::shared_ptr<class Batch>		BatchRef;
 typedef std::shared_ptr<class Fbo>          FboRef;
 typedef std::shared_ptr<class GlslProg>     GlslProgRef;
+typedef std::shared_ptr<class Vbo>			VboRef;
 
 } } // namespace cinder::gl
 
@@ -76,6 +77,7 @@ class CI_UI_API FrameBuffer {
 	bool        isInUse() const { return mInUse; }
 	void		setInUse( bool inUse );
 
+	//! Reads the contents into an ImageSource. \note This waits for the GPU to finish rendering, use FrameBufferReader for reading back without stalling.
 	ci::ImageSourceRef  createImageSource() const;
 
 	// TODO: don't expose gl, but as Renderer doesn't support passing in shaders for drawing this is the only way to custom draw a FrameBuffer's contents
@@ -148,10 +150,18 @@ class CI_UI_API Renderer {
 	void draw( const FrameBufferRef &frameBuffer, const ci::Rectf &destRect );
 	//!
 	void draw( const FrameBufferRef &frameBuffer, const ci::Area &sourceArea, const ci::Rectf &destRect );
-	//!
+	//! Draws \a image into \a destRect. Images that are a texture region (ex. from an ImageAtlas) are batched with others that share the same texture until flush().
 	void draw( const ImageRef &image, const ci::Rectf &destRect );
 	//!
 	void draw( const ImageRef &image, const ci::Rectf &destRect, const ci::gl::BatchRef &batch );
+	//! Draws any batched Images. Called automatically before any other draw or state change that can't be batched.
+	void flush();
+	//! Returns the number of draw calls used for batched Images since the last resetBatchStats().
+	size_t getNumImageBatchesDrawn() const		{ return mNumImageBatchesDrawn; }
+	//! Returns the number of batched Images drawn since the last resetBatchStats().
+	size_t getNumBatchedImagesDrawn() const		{ return mNumBatchedImagesDrawn; }
+	//! Resets the batched Image counters, Graph does this at the start of each frame.
+	void resetBatchStats();
 
 	//! Draws a solid rectangle with dimensions \a rect.
 	void drawSolidRect( const ci::Rectf &rect );
@@ -166,9 +176,26 @@ class CI_UI_API Renderer {
 	std::vector<std::pair<ci::ivec2, ci::ivec2>> mScissorStack;
 
   private:
+	void applyBlendMode( BlendMode mode );
+	void drawBatchedImage( const ImageRef &image, const ci::Rectf &destRect );
+
+	struct BatchVertex {
+		ci::vec2	mPos;
+		ci::vec2	mTexCoord;
+		ci::ColorA	mColor;
+	};
+
 	std::vector<ci::ColorA>		mColorStack;
 	std::vector<BlendMode>		mBlendModeStack;
 
+	std::vector<BatchVertex>	mBatchVertices;
+	ci::gl::TextureRef			mBatchTexture;
+	ci::gl::VboRef				mBatchVbo;
+	ci::gl::BatchRef			mBatchImageRegions;
+	size_t						mBatchCapacity = 0; // in vertices
+	size_t						mNumImageBatchesDrawn = 0;
+	size_t						mNumBatchedImagesDrawn = 0;
+
 	std::vector<FrameBufferRef>	mFrameBufferCache;
 
 	ci::gl::GlslProgRef         mGlslFrameBuffer;
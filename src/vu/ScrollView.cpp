@@ -127,9 +127,8 @@ size_t ScrollView::getNumContentViews() const
 
 ci::vec2 ScrollView::convertPointToParent( const ViewRef &contentView ) const
 {
-	vec2 offset = mContentView->getPos();
-
-	return contentView->getPos() + offset;
+	// the content container is offset and zoomed, but never rotated
+	return mContentView->toParent( contentView->getBounds() ).getUpperLeft();
 }
 
 void ScrollView::setContentOffset( const ci::vec2 &offset, bool animated )
@@ -159,6 +158,8 @@ void ScrollView::calcContentSize()
 	mContentView->setSize( getSize() );
 	if( mContentView->getLayout() ) {
 		LOG_SCROLL_CONTENT( "(using Layout)" );
+		// Grow to the Layout's content size first (ex. FlexLayout), so that subviews aren't shrunk to fit within the ScrollView.
+		mContentView->setSize( glm::max( getSize(), mContentView->getIntrinsicSize() ) );
 		mContentView->getLayout()->layout( mContentView.get() );
 	}
 
@@ -177,6 +178,7 @@ void ScrollView::calcContentSize()
 
 	mContentView->setSize( size ); // TODO: should this trigger layout or not?
 
+	size *= getZoom();
 	if( mDisableScrollingWhenContentFits && size.x <= getWidth() && size.y <= getHeight() ) {
 		setScrollingEnabled( false );
 	}
@@ -186,7 +188,7 @@ void ScrollView::calcContentSize()
 
 void ScrollView::calcOffsetBoundaries()
 {
-	const auto &contentSize = mContentView->getSize();
+	const vec2 contentSize = mContentView->getSize() * getZoom();
 	mOffsetBoundaries = Rectf( 0, 0, contentSize.x - getWidth(), contentSize.y - getHeight() );
 	LOG_SCROLL_CONTENT( "mOffsetBoundaries (before): " << mOffsetBoundaries );
 
@@ -307,6 +309,101 @@ const Rectf& ScrollView::getDeceleratingBoundaries() const
 	return mOffsetBoundaries;
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Zooming
+// ----------------------------------------------------------------------------------------------------
+
+void ScrollView::setZoomEnabled( bool enable )
+{
+	if( enable == isZoomEnabled() )
+		return;
+
+	if( enable ) {
+		mPinchRecognizer = make_shared<PinchGestureRecognizer>();
+		mPinchRecognizer->getSignalGesture().connect( [this]( GestureRecognizer *recognizer ) {
+			handlePinch();
+		} );
+		addGestureRecognizer( mPinchRecognizer );
+	}
+	else {
+		removeGestureRecognizer( mPinchRecognizer );
+		mPinchRecognizer.reset();
+		mZooming = false;
+	}
+}
+
+void ScrollView::setZoomRange( float minZoom, float maxZoom )
+{
+	CI_ASSERT_MSG( minZoom > 0 && minZoom <= maxZoom, "invalid zoom range" );
+
+	mMinZoom = minZoom;
+	mMaxZoom = maxZoom;
+
+	float zoom = getZoom();
+	if( zoom < mMinZoom || zoom > mMaxZoom )
+		setZoom( zoom );
+}
+
+float ScrollView::getZoom() const
+{
+	return mContentView->getScale().x;
+}
+
+void ScrollView::setZoom( float zoom, const vec2 &focus )
+{
+	zoom = glm::clamp( zoom, mMinZoom, mMaxZoom );
+
+	const vec2 contentPos = ( mContentOffset() + focus ) / getZoom();
+	applyZoom( zoom, contentPos, focus );
+
+	// unlike while pinching, the content isn't allowed to stretch outside of its boundaries
+	if( ! mZooming ) {
+		updateContentViewOffset( mTargetOffset );
+		mContentOffsetAnimating = false;
+	}
+}
+
+// Scales the content and then offsets it so that contentPos (in unscaled content coordinates) is at focus.
+void ScrollView::applyZoom( float zoom, const vec2 &contentPos, const vec2 &focus )
+{
+	mContentView->setScale( zoom );
+	calcOffsetBoundaries();
+
+	updateContentViewOffset( contentPos * zoom - focus );
+	mTargetOffset = mOffsetBoundaries.closestPoint( mContentOffset );
+
+	mSignalDidZoom.emit();
+	mSignalDidScroll.emit();
+}
+
+void ScrollView::handlePinch()
+{
+	const auto state = mPinchRecognizer->getState();
+	const vec2 focus = mPinchRecognizer->getLocationInView();
+
+	if( state == GestureState::BEGAN ) {
+		// the pinch has already moved past its threshold, so back out the initial scale
+		mPinchBeganZoom = getZoom() / mPinchRecognizer->getScale();
+		mPinchContentPos = ( mContentOffset() + focus ) / getZoom();
+		mZooming = true;
+		mZoomedDuringTouch = true;
+		mDecelerating = false;
+		mContentOffsetAnimating = false;
+	}
+
+	if( state == GestureState::BEGAN || state == GestureState::CHANGED ) {
+		// the content under the pinch center stays there, which also pans the content as the center moves
+		float zoom = glm::clamp( mPinchBeganZoom * mPinchRecognizer->getScale(), mMinZoom, mMaxZoom );
+		applyZoom( zoom, mPinchContentPos, focus );
+	}
+	else if( mZooming ) {
+		// settle back within the offset boundaries
+		mZooming = false;
+		mScrollVelocity = vec2( 0 );
+		mDecelerating = true;
+	}
+}
+
 void ScrollView::setLabel( const std::string &label )
 {
 	View::setLabel( label );
@@ -333,6 +430,7 @@ bool ScrollView::touchesBegan( app::TouchEvent &event )
 	mScrollVelocity = vec2( 0 );
 
 	mDragging = false; // will set to true once touchesMoved() is fired
+	mZoomedDuringTouch = false;
 	calcOffsetBoundaries(); // reset offset boundaries, which may have been modified if content offset is animating
 
 	firstTouch.setHandled();
@@ -342,6 +440,12 @@ bool ScrollView::touchesBegan( app::TouchEvent &event )
 bool ScrollView::touchesMoved( app::TouchEvent &event )
 {
 	vec2 pos = toLocal( event.getTouches().front().getPos() );
+	if( mZooming ) {
+		// the pinch moves the content, keep tracking so that dragging continues without a jump if one touch remains
+		mSwipeTracker->storeTouchPos( pos, getGraph()->getCurrentTime() );
+		return true;
+	}
+
 	vec2 lastPos = mSwipeTracker->getLastTouchPos();
 	updateOffset( pos, lastPos );
 	mSwipeTracker->storeTouchPos( pos, getGraph()->getCurrentTime() );
@@ -366,10 +470,16 @@ bool ScrollView::touchesEnded( app::TouchEvent &event )
 	vec2 pos = toLocal( event.getTouches().front().getPos() );
 	vec2 lastPos = mSwipeTracker->getLastTouchPos();
 
-	updateOffset( pos, lastPos );
-	mSwipeTracker->storeTouchPos( pos, getGraph()->getCurrentTime() );
+	if( mZoomedDuringTouch ) {
+		// the tracked positions include movement from the pinch, so don't fling
+		mSwipeVelocity = vec2( 0 );
+	}
+	else {
+		updateOffset( pos, lastPos );
+		mSwipeTracker->storeTouchPos( pos, getGraph()->getCurrentTime() );
+		mSwipeVelocity = mSwipeTracker->calcSwipeVelocity();
+	}
 
-	mSwipeVelocity = mSwipeTracker->calcSwipeVelocity();
 	mScrollVelocity = mSwipeVelocity;
 
 	LOG_SCROLL_TRACKING( "intercepting touches: " << getInterceptingTouches().size() << ",  pos: " << pos << ", swipe velocity: " << mSwipeVelocity );
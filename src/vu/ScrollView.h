@@ -22,6 +22,7 @@
 #pragma once
 
 #include "vu/View.h"
+#include "vu/GestureRecognizer.h"
 #include "vu/GestureTracker.h"
 
 namespace vu {
@@ -122,12 +123,30 @@ class CI_UI_API ScrollView : public View {
 	void setDisableScrollingWhenContentFits( bool enable = true )	{ mDisableScrollingWhenContentFits = enable; }
 	bool isDisableScrollingWhenContentFitsEnabled() const			{ return mDisableScrollingWhenContentFits; }
 
+	//! Sets whether the content can be zoomed with a two-finger pinch, which also pans the content with the touches. Default is false.
+	void	setZoomEnabled( bool enable = true );
+	bool	isZoomEnabled() const						{ return (bool)mPinchRecognizer; }
+	//! Sets the range that the zoom is clamped to. Default: [1, 4]
+	void	setZoomRange( float minZoom, float maxZoom );
+	float	getMinZoom() const							{ return mMinZoom; }
+	float	getMaxZoom() const							{ return mMaxZoom; }
+	//! Sets the scale of the content, keeping the content under \a focus (in local coordinates) in place.
+	void	setZoom( float zoom, const ci::vec2 &focus );
+	//! Sets the scale of the content, keeping the content at the center of the ScrollView in place.
+	void	setZoom( float zoom )						{ setZoom( zoom, getCenterLocal() ); }
+	//! Returns the current scale of the content.
+	float	getZoom() const;
+	//! Returns whether the user is currently zooming with a pinch.
+	bool	isZooming() const							{ return mZooming; }
+
 	//! Signal emitted whenever the content scrolls (both by dragging and when decelerating).
 	ci::signals::Signal<void ()>& getSignalDidScroll()		{ return mSignalDidScroll; }
 	//! Signal emitted when dragging begins.
 	ci::signals::Signal<void ()>& getSignalDragBegin()		{ return mSignalDragBegin; }
 	//! Signal emitted when dragging ends.
 	ci::signals::Signal<void ()>& getSignalDragEnd()		{ return mSignalDragEnd; }
+	//! Signal emitted whenever the zoom changes.
+	ci::signals::Signal<void ()>& getSignalDidZoom()		{ return mSignalDidZoom; }
 
   protected:
 	void layout()	override;
@@ -158,6 +177,8 @@ class CI_UI_API ScrollView : public View {
 
   private:
 	void updateContentViewOffset( const ci::vec2 &offset );
+	void applyZoom( float zoom, const ci::vec2 &contentPos, const ci::vec2 &focus );
+	void handlePinch();
 
 	class ContentView;
 	std::shared_ptr<ContentView>	mContentView;
@@ -182,7 +203,15 @@ class CI_UI_API ScrollView : public View {
 	bool							mHorizontalScrollingEnabled = true;
 	bool							mDisableScrollingWhenContentFits = false;
 
-	ci::signals::Signal<void ()>	mSignalDidScroll, mSignalDragBegin, mSignalDragEnd;
+	PinchGestureRecognizerRef		mPinchRecognizer;
+	float							mMinZoom = 1;
+	float							mMaxZoom = 4;
+	float							mPinchBeganZoom = 1;
+	ci::vec2						mPinchContentPos;		// content position (unscaled) that stays under the pinch center
+	bool							mZooming = false;
+	bool							mZoomedDuringTouch = false;
+
+	ci::signals::Signal<void ()>	mSignalDidScroll, mSignalDragBegin, mSignalDragEnd, mSignalDidZoom;
 };
 
 class CI_UI_API PagingScrollView : public ScrollView {
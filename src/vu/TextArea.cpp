@@ -0,0 +1,497 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/TextArea.h"
+#include "vu/Graph.h"
+#include "vu/Debug.h"
+
+#include "cinder/Unicode.h"
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+TextArea::TextArea( const Rectf &bounds )
+	: Control( bounds )
+{
+	setAcceptsFirstResponder( true );
+	setClipEnabled( true );
+
+	mText = TextManager::loadText();
+	mBuffer.setFont( mText );
+	mParagraphs.resize( mBuffer.getNumLines() );
+}
+
+void TextArea::setText( const std::string &text )
+{
+	mBuffer.setText( text );
+	mParagraphs.assign( mBuffer.getNumLines(), Paragraph() );
+	mParagraphsDirty = true;
+	mLineIndicesDirty = true;
+	mCursorPos = std::min( mCursorPos, mBuffer.size() );
+
+	updateFitHeight();
+	setNeedsDisplay();
+}
+
+void TextArea::setFont( const std::string &systemName, float fontSize )
+{
+	mText = TextManager::loadText( systemName, fontSize );
+	mBuffer.setFont( mText );
+	for( auto &paragraph : mParagraphs )
+		paragraph.mValid = false;
+
+	mParagraphsDirty = true;
+	mLineIndicesDirty = true;
+
+	updateFitHeight();
+	setNeedsDisplay();
+}
+
+void TextArea::setPadding( const Rectf &padding )
+{
+	mPadding = padding;
+	mWrapWidth = -1; // re-wrap at the next layout
+	setNeedsLayout();
+}
+
+void TextArea::setFitHeightEnabled( bool enable )
+{
+	mFitHeight = enable;
+	updateFitHeight();
+}
+
+void TextArea::setCursorPos( size_t pos )
+{
+	mCursorPos = std::min( pos, mBuffer.size() );
+	mCursorPreferredOffset = -1;
+	setNeedsDisplay();
+}
+
+size_t TextArea::getNumLines()
+{
+	layoutParagraphs();
+	return mFirstLineIndices.back();
+}
+
+float TextArea::getContentHeight()
+{
+	return getNumLines() * getLineHeight() + mPadding.y1 + mPadding.y2;
+}
+
+float TextArea::getLineHeight() const
+{
+	return mText->getLineHeight();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Layout
+// ----------------------------------------------------------------------------------------------------
+
+void TextArea::insertText( size_t pos, const std::string &str )
+{
+	const size_t paragraph = mBuffer.getLineForPos( pos );
+	const size_t numParagraphsBefore = mBuffer.getNumLines();
+
+	mBuffer.insert( pos, str );
+
+	// only the paragraph containing pos and any split off from it need to be wrapped again
+	const size_t numAdded = mBuffer.getNumLines() - numParagraphsBefore;
+	mParagraphs[paragraph].mValid = false;
+	mParagraphs.insert( mParagraphs.begin() + paragraph + 1, numAdded, Paragraph() );
+	mParagraphsDirty = true;
+	if( numAdded > 0 )
+		mLineIndicesDirty = true;
+
+	getSignalValueChanged().emit();
+}
+
+void TextArea::eraseText( size_t pos, size_t length )
+{
+	const size_t paragraph = mBuffer.getLineForPos( pos );
+	const size_t numParagraphsBefore = mBuffer.getNumLines();
+
+	mBuffer.erase( pos, length );
+
+	// paragraphs joined with the one containing pos are removed
+	const size_t numRemoved = numParagraphsBefore - mBuffer.getNumLines();
+	mParagraphs[paragraph].mValid = false;
+	mParagraphs.erase( mParagraphs.begin() + paragraph + 1, mParagraphs.begin() + paragraph + 1 + numRemoved );
+	mParagraphsDirty = true;
+	if( numRemoved > 0 )
+		mLineIndicesDirty = true;
+
+	getSignalValueChanged().emit();
+}
+
+void TextArea::layout()
+{
+	const float wrapWidth = getWidth() - mPadding.x1 - mPadding.x2;
+	if( mWrapWidth != wrapWidth ) {
+		mWrapWidth = wrapWidth;
+		for( auto &paragraph : mParagraphs )
+			paragraph.mValid = false;
+
+		mParagraphsDirty = true;
+		mLineIndicesDirty = true;
+	}
+
+	updateFitHeight();
+}
+
+void TextArea::layoutParagraphs()
+{
+	if( mParagraphsDirty ) {
+		mText->buildMetrics();
+
+		for( size_t i = 0; i < mParagraphs.size(); i++ ) {
+			if( mParagraphs[i].mValid )
+				continue;
+
+			const size_t numLinesBefore = mParagraphs[i].mLineStarts.size();
+			wrapParagraph( i );
+			if( mParagraphs[i].mLineStarts.size() != numLinesBefore )
+				mLineIndicesDirty = true;
+		}
+
+		mParagraphsDirty = false;
+	}
+
+	if( mLineIndicesDirty ) {
+		mFirstLineIndices.resize( mParagraphs.size() + 1 );
+		size_t numLines = 0;
+		for( size_t i = 0; i < mParagraphs.size(); i++ ) {
+			mFirstLineIndices[i] = numLines;
+			numLines += mParagraphs[i].mLineStarts.size();
+		}
+
+		mFirstLineIndices.back() = numLines;
+		mLineIndicesDirty = false;
+	}
+}
+
+void TextArea::wrapParagraph( size_t paragraph )
+{
+	auto &lineStarts = mParagraphs[paragraph].mLineStarts;
+	lineStarts.assign( 1, 0 );
+
+	const size_t begin = mBuffer.getLineStart( paragraph );
+	const size_t end = mBuffer.getLineEnd( paragraph );
+
+	// Greedy word wrap: spaces hang past the right edge, a line breaks after its last space or within a word that is wider than the line.
+	if( mWrapWidth > 0 ) {
+		size_t lineBegin = begin;
+		float lineBeginOffset = 0;
+		size_t breakPos = begin;
+		size_t pos = begin;
+		while( pos < end ) {
+			const size_t next = std::min( mBuffer.nextCharPos( pos ), end );
+			if( mBuffer.at( pos ) == ' ' ) {
+				breakPos = next;
+			}
+			else if( pos > lineBegin && mBuffer.getOffsetForPos( next ) - lineBeginOffset > mWrapWidth ) {
+				lineBegin = breakPos > lineBegin ? breakPos : pos;
+				lineBeginOffset = mBuffer.getOffsetForPos( lineBegin );
+				lineStarts.push_back( lineBegin - begin );
+			}
+
+			pos = next;
+		}
+	}
+
+	mParagraphs[paragraph].mValid = true;
+	mNumParagraphsWrapped++;
+}
+
+void TextArea::updateFitHeight()
+{
+	if( ! mFitHeight )
+		return;
+
+	const float height = getContentHeight();
+	if( height != getHeight() )
+		setSize( vec2( getWidth(), height ) );
+}
+
+size_t TextArea::getParagraphForLine( size_t line ) const
+{
+	auto it = upper_bound( mFirstLineIndices.begin(), mFirstLineIndices.end(), line );
+	size_t result = ( it - mFirstLineIndices.begin() ) - 1;
+	return std::min( result, mParagraphs.size() - 1 );
+}
+
+size_t TextArea::getLineForPos( size_t pos ) const
+{
+	const size_t paragraph = mBuffer.getLineForPos( pos );
+	const auto &lineStarts = mParagraphs[paragraph].mLineStarts;
+
+	auto it = upper_bound( lineStarts.begin(), lineStarts.end(), pos - mBuffer.getLineStart( paragraph ) );
+	return mFirstLineIndices[paragraph] + ( it - lineStarts.begin() ) - 1;
+}
+
+void TextArea::getLineRange( size_t paragraph, size_t line, size_t *begin, size_t *end ) const
+{
+	const auto &lineStarts = mParagraphs[paragraph].mLineStarts;
+	const size_t paragraphBegin = mBuffer.getLineStart( paragraph );
+	const size_t index = line - mFirstLineIndices[paragraph];
+
+	*begin = paragraphBegin + lineStarts[index];
+	*end = index + 1 < lineStarts.size() ? paragraphBegin + lineStarts[index + 1] : mBuffer.getLineEnd( paragraph );
+}
+
+size_t TextArea::getPosForLineOffset( size_t line, float offset ) const
+{
+	const size_t paragraph = getParagraphForLine( line );
+	size_t begin, end;
+	getLineRange( paragraph, line, &begin, &end );
+
+	size_t result = mBuffer.getPosForOffset( paragraph, mBuffer.getOffsetForPos( begin ) + offset );
+	if( result < begin )
+		result = begin;
+	else if( result >= end && end < mBuffer.getLineEnd( paragraph ) )
+		result = mBuffer.prevCharPos( end ); // the end of a wrapped line is the start of the next one
+	else if( result > end )
+		result = end;
+
+	return result;
+}
+
+vec2 TextArea::getCursorLocal() const
+{
+	const size_t line = getLineForPos( mCursorPos );
+	size_t begin, end;
+	getLineRange( getParagraphForLine( line ), line, &begin, &end );
+
+	const float offset = mBuffer.getOffsetForPos( mCursorPos ) - mBuffer.getOffsetForPos( begin );
+	return vec2( mPadding.x1 + offset, mPadding.y1 + line * getLineHeight() );
+}
+
+void TextArea::moveCursorToLine( size_t line )
+{
+	if( mCursorPreferredOffset < 0 )
+		mCursorPreferredOffset = getCursorLocal().x - mPadding.x1;
+
+	mCursorPos = getPosForLineOffset( line, mCursorPreferredOffset );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Update / Draw
+// ----------------------------------------------------------------------------------------------------
+
+void TextArea::update()
+{
+	// wrapping measures text, which is only safe on the main thread, so within an independent subtree it waits until the parallel update is complete
+	if( mParagraphsDirty ) {
+		auto textArea = static_pointer_cast<TextArea>( shared_from_this() );
+		getGraph()->defer( [textArea] {
+			textArea->layoutParagraphs();
+			textArea->updateFitHeight();
+		} );
+		return;
+	}
+
+	layoutParagraphs();
+	updateFitHeight();
+}
+
+void TextArea::draw( Renderer *ren )
+{
+	layoutParagraphs();
+
+	mNumLinesDrawn = 0;
+	const float lineHeight = getLineHeight();
+	if( lineHeight <= 0 )
+		return;
+
+	// only lines within the visible bounds are drawn
+	const Rectf visibleBounds = calcVisibleBoundsLocal();
+	const size_t numLines = mFirstLineIndices.back();
+	const size_t lineBegin = (size_t)std::max( 0.0f, floor( ( visibleBounds.y1 - mPadding.y1 ) / lineHeight ) );
+	const size_t lineEnd = std::min( numLines, (size_t)std::max( 0.0f, ceil( ( visibleBounds.y2 - mPadding.y1 ) / lineHeight ) ) );
+
+	if( lineBegin < lineEnd && visibleBounds.getWidth() > 0 ) {
+		ren->setColor( mTextColor );
+
+		size_t paragraph = getParagraphForLine( lineBegin );
+		for( size_t line = lineBegin; line < lineEnd; line++ ) {
+			while( line >= mFirstLineIndices[paragraph + 1] )
+				paragraph++;
+
+			size_t begin, end;
+			getLineRange( paragraph, line, &begin, &end );
+			if( end > begin ) {
+				mBuffer.getRange( begin, end - begin, &mLineString );
+				mText->drawString( mLineString, vec2( mPadding.x1, mPadding.y1 + line * lineHeight + mText->getAscent() ) );
+			}
+
+			mNumLinesDrawn++;
+		}
+	}
+
+	// draw cursor bar
+	if( isFirstResponder() ) {
+		const float cursorThickness = 1;
+		const vec2 cursorPos = getCursorLocal();
+		Rectf cursorRect = { cursorPos.x - cursorThickness / 2, cursorPos.y, cursorPos.x + cursorThickness / 2, cursorPos.y + lineHeight };
+
+		ColorA cursorColor = mCursorColor;
+		cursorColor.a *= (float)( 1.0 - glm::pow( cos( getGraph()->getCurrentTime() * 2 ), 4 ) );
+
+		ren->pushBlendMode( vu::BlendMode::PREMULT_ALPHA );
+		ren->setColor( cursorColor );
+		ren->drawSolidRect( cursorRect );
+		ren->popBlendMode();
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Events
+// ----------------------------------------------------------------------------------------------------
+
+bool TextArea::willBecomeFirstResponder()
+{
+	UI_LOG_TEXT( getName() );
+
+	// store the text, in case input is canceled and we need to revert.
+	mTextBeforeInput = getText();
+	return true;
+}
+
+bool TextArea::willResignFirstResponder()
+{
+	UI_LOG_TEXT( getName() );
+	setNeedsDisplay(); // hide the cursor
+	return true;
+}
+
+bool TextArea::touchesBegan( app::TouchEvent &event )
+{
+	auto &firstTouch = event.getTouches().front();
+	const vec2 pos = toLocal( firstTouch.getPos() );
+
+	// place the cursor at the closest character to the touch
+	layoutParagraphs();
+	const float lineHeight = getLineHeight();
+	if( lineHeight > 0 ) {
+		const int line = glm::clamp( (int)floor( ( pos.y - mPadding.y1 ) / lineHeight ), 0, (int)mFirstLineIndices.back() - 1 );
+		mCursorPos = getPosForLineOffset( line, pos.x - mPadding.x1 );
+		mCursorPreferredOffset = -1;
+		setNeedsDisplay();
+	}
+
+	firstTouch.setHandled();
+	return true;
+}
+
+bool TextArea::keyDown( app::KeyEvent &event )
+{
+	layoutParagraphs();
+
+	bool handled = true;
+	const int code = event.getCode();
+	if( code == app::KeyEvent::KEY_ESCAPE ) {
+		// cancel input text, reverting it to what it was when we became first responder
+		UI_LOG_TEXT( "(escape) text canceled." );
+		setText( mTextBeforeInput );
+		getSignalValueChanged().emit();
+		resignFirstResponder();
+	}
+	else if( code == app::KeyEvent::KEY_RETURN ) {
+		insertText( mCursorPos, "\n" );
+		mCursorPos += 1;
+		mCursorPreferredOffset = -1;
+	}
+	else if( code == app::KeyEvent::KEY_BACKSPACE ) {
+		if( mCursorPos > 0 ) {
+			const size_t prevPos = mBuffer.prevCharPos( mCursorPos );
+			eraseText( prevPos, mCursorPos - prevPos );
+			mCursorPos = prevPos;
+		}
+		mCursorPreferredOffset = -1;
+	}
+	else if( code == app::KeyEvent::KEY_DELETE ) {
+		if( mCursorPos < mBuffer.size() )
+			eraseText( mCursorPos, mBuffer.nextCharPos( mCursorPos ) - mCursorPos );
+
+		mCursorPreferredOffset = -1;
+	}
+	else if( code == app::KeyEvent::KEY_LEFT ) {
+		mCursorPos = mBuffer.prevCharPos( mCursorPos );
+		mCursorPreferredOffset = -1;
+	}
+	else if( code == app::KeyEvent::KEY_RIGHT ) {
+		mCursorPos = mBuffer.nextCharPos( mCursorPos );
+		mCursorPreferredOffset = -1;
+	}
+	else if( code == app::KeyEvent::KEY_UP ) {
+		const size_t line = getLineForPos( mCursorPos );
+		if( line > 0 )
+			moveCursorToLine( line - 1 );
+		else
+			mCursorPos = 0;
+	}
+	else if( code == app::KeyEvent::KEY_DOWN ) {
+		const size_t line = getLineForPos( mCursorPos );
+		if( line + 1 < mFirstLineIndices.back() )
+			moveCursorToLine( line + 1 );
+		else
+			mCursorPos = mBuffer.size();
+	}
+	else if( code == app::KeyEvent::KEY_HOME || code == app::KeyEvent::KEY_END ) {
+		// move to the start or end of the wrapped line
+		const size_t line = getLineForPos( mCursorPos );
+		const size_t paragraph = getParagraphForLine( line );
+		size_t begin, end;
+		getLineRange( paragraph, line, &begin, &end );
+		if( code == app::KeyEvent::KEY_HOME )
+			mCursorPos = begin;
+		else
+			mCursorPos = end < mBuffer.getLineEnd( paragraph ) ? mBuffer.prevCharPos( end ) : end;
+
+		mCursorPreferredOffset = -1;
+	}
+	else if( event.getCharUtf32() > 0x7F ) {
+		// non-ASCII chars are inserted as their UTF-8 sequence
+		const string str = toUtf8( u32string( 1, (char32_t)event.getCharUtf32() ) );
+		insertText( mCursorPos, str );
+		mCursorPos += str.size();
+		mCursorPreferredOffset = -1;
+	}
+	else if( event.getChar() ) {
+		insertText( mCursorPos, string( 1, event.getChar() ) );
+		mCursorPos += 1;
+		mCursorPreferredOffset = -1;
+	}
+	else
+		handled = false;
+
+	if( handled ) {
+		UI_LOG_TEXT( "text size: " << mBuffer.size() << ", paragraphs: " << mBuffer.getNumLines() << ", cursor pos: " << mCursorPos );
+		setNeedsDisplay();
+	}
+
+	return handled;
+}
+
+} // namespace vu
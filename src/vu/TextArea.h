@@ -0,0 +1,125 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Control.h"
+#include "vu/TextBuffer.h"
+
+namespace vu {
+
+typedef std::shared_ptr<class TextArea>	TextAreaRef;
+
+//! Multi-line editable text, word wrapped to this View's width. Each paragraph (text between newlines) caches its wrapped line breaks,
+//! and an edit only re-wraps the paragraph it touches. Only the lines within the visible bounds (ex. inside a ScrollView) are drawn.
+class CI_UI_API TextArea : public Control {
+  public:
+	TextArea( const ci::Rectf &bounds = ci::Rectf::zero() );
+
+	void				setText( const std::string &text );
+	const std::string&	getText() const		{ return mBuffer.getText(); }
+
+	void	setFont( const std::string &systemName, float fontSize );
+	void	setTextColor( const ci::ColorA &color )		{ mTextColor = color; setNeedsDisplay(); }
+	const ci::ColorA&	getTextColor() const			{ return mTextColor; }
+	void	setCursorColor( const ci::ColorA &color )	{ mCursorColor = color; }
+	void	setPadding( const ci::Rectf &padding );
+
+	//! Sets whether this View's height follows the height of its wrapped text, for example when it is the content of a ScrollView. Default is false.
+	void	setFitHeightEnabled( bool enable = true );
+	bool	isFitHeightEnabled() const		{ return mFitHeight; }
+
+	//! Sets the byte position where the next character will be inserted.
+	void	setCursorPos( size_t pos );
+	size_t	getCursorPos() const			{ return mCursorPos; }
+
+	//! Returns the number of paragraphs, which is the number of newlines plus one.
+	size_t	getNumParagraphs() const		{ return mBuffer.getNumLines(); }
+	//! Returns the number of wrapped lines.
+	size_t	getNumLines();
+	//! Returns the height of the wrapped text, including padding.
+	float	getContentHeight();
+	//! Returns the number of lines drawn last frame.
+	size_t	getNumLinesDrawn() const		{ return mNumLinesDrawn; }
+	//! Returns the total number of times a paragraph has been wrapped, useful for verifying that edits only re-wrap the paragraph being edited.
+	size_t	getNumParagraphsWrapped() const	{ return mNumParagraphsWrapped; }
+
+  protected:
+	void layout() override;
+	void update() override;
+	void draw( Renderer *ren ) override;
+
+	bool willBecomeFirstResponder() override;
+	bool willResignFirstResponder() override;
+
+	bool touchesBegan( ci::app::TouchEvent &event ) override;
+	bool keyDown( ci::app::KeyEvent &event ) override;
+
+  private:
+	struct Paragraph {
+		std::vector<size_t>	mLineStarts;	// byte offsets from the paragraph start of each wrapped line, the first is always 0
+		bool				mValid = false;
+	};
+
+	void	insertText( size_t pos, const std::string &str );
+	void	eraseText( size_t pos, size_t length );
+	//! Re-wraps any paragraphs that were edited and updates the line index, if needed.
+	void	layoutParagraphs();
+	void	wrapParagraph( size_t paragraph );
+	void	updateFitHeight();
+
+	float	getLineHeight() const;
+	//! Returns the paragraph containing wrapped \a line, from a binary search of the line index.
+	size_t	getParagraphForLine( size_t line ) const;
+	//! Returns the wrapped line containing \a pos.
+	size_t	getLineForPos( size_t pos ) const;
+	//! Returns the [begin, end) byte range of wrapped \a line within \a paragraph.
+	void	getLineRange( size_t paragraph, size_t line, size_t *begin, size_t *end ) const;
+	//! Returns the position in wrapped \a line closest to \a offset from its left edge.
+	size_t	getPosForLineOffset( size_t line, float offset ) const;
+	ci::vec2	getCursorLocal() const;
+	void	moveCursorToLine( size_t line );
+
+	TextRef					mText;
+	TextBuffer				mBuffer;
+	std::vector<Paragraph>	mParagraphs;		// parallel to mBuffer's lines
+	std::vector<size_t>		mFirstLineIndices;	// index of each paragraph's first wrapped line, with the total number of lines at the end
+	bool					mParagraphsDirty = true;
+	bool					mLineIndicesDirty = true;
+	float					mWrapWidth = -1;
+
+	size_t					mCursorPos = 0;
+	float					mCursorPreferredOffset = -1; // kept while moving up and down lines, so that the cursor returns to the same column
+	std::string				mTextBeforeInput;
+	std::string				mLineString;
+
+	ci::ColorA				mTextColor = ci::ColorA::gray( 1, 0.8f );
+	ci::ColorA				mCursorColor = ci::ColorA::gray( 1, 0.6f );
+	ci::Rectf				mPadding = ci::Rectf( 6, 6, 6, 6 );
+	bool					mFitHeight = false;
+
+	size_t					mNumLinesDrawn = 0;
+	size_t					mNumParagraphsWrapped = 0;
+};
+
+} // namespace vu
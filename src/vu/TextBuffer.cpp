@@ -0,0 +1,334 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/TextBuffer.h"
+
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace vu {
+
+namespace {
+
+const size_t MIN_GAP_SIZE = 64;
+
+bool isContinuationByte( char c )
+{
+	return ( c & 0xC0 ) == 0x80;
+}
+
+//! Decodes the UTF-8 code point starting at \a pos, stopping at \a end. Malformed sequences decode to the replacement character.
+uint32_t decodeCodePoint( const TextBuffer &buffer, size_t pos, size_t end )
+{
+	const uint8_t lead = (uint8_t)buffer.at( pos );
+	if( lead < 0x80 )
+		return lead;
+
+	uint32_t result;
+	size_t numBytes;
+	if( ( lead & 0xE0 ) == 0xC0 ) {
+		result = lead & 0x1F;
+		numBytes = 2;
+	}
+	else if( ( lead & 0xF0 ) == 0xE0 ) {
+		result = lead & 0x0F;
+		numBytes = 3;
+	}
+	else if( ( lead & 0xF8 ) == 0xF0 ) {
+		result = lead & 0x07;
+		numBytes = 4;
+	}
+	else
+		return 0xFFFD;
+
+	for( size_t i = 1; i < numBytes; i++ ) {
+		if( pos + i >= end || ! isContinuationByte( buffer.at( pos + i ) ) )
+			return 0xFFFD;
+
+		result = ( result << 6 ) | ( buffer.at( pos + i ) & 0x3F );
+	}
+
+	return result;
+}
+
+} // anonymous namespace
+
+TextBuffer::TextBuffer()
+	: mLineStarts( 1, 0 ), mLineMetrics( 1 )
+{
+}
+
+void TextBuffer::setText( const std::string &str )
+{
+	mBuffer.assign( str.begin(), str.end() );
+	mGapBegin = mGapEnd = mBuffer.size();
+	mString = str;
+	mStringDirty = false;
+
+	mLineStarts.assign( 1, 0 );
+	for( size_t i = 0; i < str.size(); i++ ) {
+		if( str[i] == '\n' )
+			mLineStarts.push_back( i + 1 );
+	}
+
+	mLineMetrics.assign( mLineStarts.size(), LineMetrics() );
+}
+
+const std::string& TextBuffer::getText() const
+{
+	if( mStringDirty ) {
+		mString.assign( mBuffer.data(), mGapBegin );
+		mString.append( mBuffer.data() + mGapEnd, mBuffer.size() - mGapEnd );
+		mStringDirty = false;
+	}
+
+	return mString;
+}
+
+void TextBuffer::insert( size_t pos, const std::string &str )
+{
+	CI_ASSERT( pos <= size() );
+	if( str.empty() )
+		return;
+
+	// update lines first, while pos still refers to the text before the edit
+	const size_t line = getLineForPos( pos );
+	for( size_t i = line + 1; i < mLineStarts.size(); i++ )
+		mLineStarts[i] += str.size();
+
+	vector<size_t> newLineStarts;
+	for( size_t i = 0; i < str.size(); i++ ) {
+		if( str[i] == '\n' )
+			newLineStarts.push_back( pos + i + 1 );
+	}
+
+	mLineStarts.insert( mLineStarts.begin() + line + 1, newLineStarts.begin(), newLineStarts.end() );
+	mLineMetrics.insert( mLineMetrics.begin() + line + 1, newLineStarts.size(), LineMetrics() );
+	mLineMetrics[line].mValid = false;
+
+	moveGap( pos );
+	reserveGap( str.size() );
+	copy( str.begin(), str.end(), mBuffer.begin() + mGapBegin );
+	mGapBegin += str.size();
+	mStringDirty = true;
+}
+
+void TextBuffer::erase( size_t pos, size_t length )
+{
+	CI_ASSERT( pos <= size() );
+	length = std::min( length, size() - pos );
+	if( length == 0 )
+		return;
+
+	// lines that start within the erased range are joined with the line containing pos
+	const size_t line = getLineForPos( pos );
+	auto removedBegin = mLineStarts.begin() + line + 1;
+	auto removedEnd = upper_bound( removedBegin, mLineStarts.end(), pos + length );
+	for( auto it = removedEnd; it != mLineStarts.end(); ++it )
+		*it -= length;
+
+	const auto numRemoved = removedEnd - removedBegin;
+	mLineStarts.erase( removedBegin, removedEnd );
+	mLineMetrics.erase( mLineMetrics.begin() + line + 1, mLineMetrics.begin() + line + 1 + numRemoved );
+	mLineMetrics[line].mValid = false;
+
+	moveGap( pos );
+	mGapEnd += length;
+	mStringDirty = true;
+}
+
+void TextBuffer::clear()
+{
+	setText( string() );
+}
+
+void TextBuffer::moveGap( size_t pos )
+{
+	if( pos < mGapBegin ) {
+		const size_t length = mGapBegin - pos;
+		copy_backward( mBuffer.begin() + pos, mBuffer.begin() + mGapBegin, mBuffer.begin() + mGapEnd );
+		mGapBegin -= length;
+		mGapEnd -= length;
+	}
+	else if( pos > mGapBegin ) {
+		const size_t length = pos - mGapBegin;
+		copy( mBuffer.begin() + mGapEnd, mBuffer.begin() + mGapEnd + length, mBuffer.begin() + mGapBegin );
+		mGapBegin += length;
+		mGapEnd += length;
+	}
+}
+
+void TextBuffer::reserveGap( size_t length )
+{
+	if( getGapSize() >= length )
+		return;
+
+	// grow geometrically so that a long run of inserts is amortized
+	const size_t growBy = std::max( length - getGapSize(), std::max( mBuffer.size(), MIN_GAP_SIZE ) );
+	mBuffer.insert( mBuffer.begin() + mGapEnd, growBy, 0 );
+	mGapEnd += growBy;
+}
+
+size_t TextBuffer::nextCharPos( size_t pos ) const
+{
+	const size_t length = size();
+	if( pos >= length )
+		return length;
+
+	pos++;
+	while( pos < length && isContinuationByte( at( pos ) ) )
+		pos++;
+
+	return pos;
+}
+
+size_t TextBuffer::prevCharPos( size_t pos ) const
+{
+	if( pos == 0 )
+		return 0;
+
+	pos = std::min( pos, size() ) - 1;
+	while( pos > 0 && isContinuationByte( at( pos ) ) )
+		pos--;
+
+	return pos;
+}
+
+size_t TextBuffer::getLineEnd( size_t line ) const
+{
+	return line + 1 < mLineStarts.size() ? mLineStarts[line + 1] - 1 : size();
+}
+
+size_t TextBuffer::getLineForPos( size_t pos ) const
+{
+	auto it = upper_bound( mLineStarts.begin(), mLineStarts.end(), pos );
+	return ( it - mLineStarts.begin() ) - 1;
+}
+
+void TextBuffer::getLine( size_t line, std::string *result ) const
+{
+	const size_t begin = getLineStart( line );
+	getRange( begin, getLineEnd( line ) - begin, result );
+}
+
+void TextBuffer::getRange( size_t pos, size_t length, std::string *result ) const
+{
+	CI_ASSERT( pos + length <= size() );
+
+	// copy the parts before and after the gap separately
+	result->clear();
+	if( pos < mGapBegin )
+		result->append( mBuffer.data() + pos, std::min( length, mGapBegin - pos ) );
+
+	const size_t end = pos + length;
+	if( end > mGapBegin ) {
+		const size_t afterBegin = std::max( pos, mGapBegin );
+		result->append( mBuffer.data() + afterBegin + getGapSize(), end - afterBegin );
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Metrics
+// ----------------------------------------------------------------------------------------------------
+
+void TextBuffer::setFont( const TextRef &text )
+{
+	mText = text;
+	for( auto &metrics : mLineMetrics )
+		metrics.mValid = false;
+}
+
+const TextBuffer::LineMetrics& TextBuffer::getLineMetrics( size_t line ) const
+{
+	auto &metrics = mLineMetrics[line];
+	if( metrics.mValid )
+		return metrics;
+
+	if( mText && ! mText->hasMetrics() )
+		mText->buildMetrics();
+
+	const size_t begin = getLineStart( line );
+	const size_t end = getLineEnd( line );
+
+	metrics.mCharOffsets.clear();
+	metrics.mAdvances.clear();
+
+	float offset = 0;
+	size_t pos = begin;
+	while( pos < end ) {
+		metrics.mCharOffsets.push_back( pos - begin );
+		metrics.mAdvances.push_back( offset );
+
+		if( mText )
+			offset += mText->getAdvance( decodeCodePoint( *this, pos, end ) );
+
+		pos = std::min( nextCharPos( pos ), end );
+	}
+
+	metrics.mCharOffsets.push_back( end - begin );
+	metrics.mAdvances.push_back( offset );
+
+	// If the Text isn't ready yet, measure again next time.
+	metrics.mValid = ! mText || mText->hasMetrics();
+	mNumLinesMeasured++;
+
+	return metrics;
+}
+
+float TextBuffer::getOffsetForPos( size_t pos ) const
+{
+	pos = std::min( pos, size() );
+	const size_t line = getLineForPos( pos );
+	const auto &metrics = getLineMetrics( line );
+
+	const size_t offset = pos - getLineStart( line );
+	auto it = lower_bound( metrics.mCharOffsets.begin(), metrics.mCharOffsets.end(), offset );
+	if( it == metrics.mCharOffsets.end() )
+		return metrics.mAdvances.back();
+
+	return metrics.mAdvances[it - metrics.mCharOffsets.begin()];
+}
+
+float TextBuffer::getLineWidth( size_t line ) const
+{
+	return getLineMetrics( line ).mAdvances.back();
+}
+
+size_t TextBuffer::getPosForOffset( size_t line, float offset ) const
+{
+	const auto &metrics = getLineMetrics( line );
+
+	auto it = lower_bound( metrics.mAdvances.begin(), metrics.mAdvances.end(), offset );
+	size_t index = it - metrics.mAdvances.begin();
+	if( index == metrics.mAdvances.size() )
+		index--;
+	else if( index > 0 && offset - metrics.mAdvances[index - 1] < metrics.mAdvances[index] - offset )
+		index--;
+
+	return getLineStart( line ) + metrics.mCharOffsets[index];
+}
+
+} // namespace vu
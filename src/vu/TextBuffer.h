@@ -0,0 +1,113 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/TextManager.h"
+
+#include <string>
+#include <vector>
+
+namespace vu {
+
+//! Editable UTF-8 text stored in a gap buffer, so that inserting or erasing at the cursor costs the size of the edit rather than the size of the text.
+//! All positions are byte offsets. Line start positions are kept up to date with each edit, and when a Text is set the glyph advances of each line
+//! are measured once and cached as prefix sums, so placing a cursor is a binary search until that line is edited again.
+class CI_UI_API TextBuffer {
+  public:
+	TextBuffer();
+
+	//! Replaces the entire contents with \a str.
+	void	setText( const std::string &str );
+	//! Returns the contents as a contiguous string, which is only rebuilt when it has been edited since the last call.
+	const std::string&	getText() const;
+
+	size_t	size() const		{ return mBuffer.size() - getGapSize(); }
+	bool	empty() const		{ return size() == 0; }
+	//! Returns the byte at \a pos.
+	char	at( size_t pos ) const	{ return pos < mGapBegin ? mBuffer[pos] : mBuffer[pos + getGapSize()]; }
+
+	//! Inserts \a str at \a pos.
+	void	insert( size_t pos, const std::string &str );
+	//! Erases \a length bytes starting at \a pos.
+	void	erase( size_t pos, size_t length );
+	//! Removes all text.
+	void	clear();
+
+	//! Returns the position of the character after the one at \a pos, skipping UTF-8 continuation bytes.
+	size_t	nextCharPos( size_t pos ) const;
+	//! Returns the position of the character before \a pos, skipping UTF-8 continuation bytes.
+	size_t	prevCharPos( size_t pos ) const;
+
+	//! Returns the number of lines, which is always at least one.
+	size_t	getNumLines() const		{ return mLineStarts.size(); }
+	//! Returns the position of the first character of \a line.
+	size_t	getLineStart( size_t line ) const	{ return mLineStarts[line]; }
+	//! Returns the position of the newline that ends \a line, or size() for the last line.
+	size_t	getLineEnd( size_t line ) const;
+	//! Returns the line that \a pos is in, found with a binary search over the line starts.
+	size_t	getLineForPos( size_t pos ) const;
+	//! Copies the text of \a line into \a result, not including the newline. \a result's capacity is reused.
+	void	getLine( size_t line, std::string *result ) const;
+	//! Copies \a length bytes starting at \a pos into \a result. \a result's capacity is reused.
+	void	getRange( size_t pos, size_t length, std::string *result ) const;
+
+	//! Sets the Text used for measuring, which invalidates all cached line metrics.
+	void			setFont( const TextRef &text );
+	const TextRef&	getFont() const		{ return mText; }
+	//! Returns the horizontal offset of \a pos from the start of its line.
+	float	getOffsetForPos( size_t pos ) const;
+	//! Returns the sum of the glyph advances in \a line.
+	float	getLineWidth( size_t line ) const;
+	//! Returns the position in \a line whose offset is closest to \a offset, ex. when moving the cursor up or down a line.
+	size_t	getPosForOffset( size_t line, float offset ) const;
+	//! Returns the number of times a line has been measured, useful for verifying that only edited lines are re-measured.
+	size_t	getNumLinesMeasured() const	{ return mNumLinesMeasured; }
+
+  private:
+	struct LineMetrics {
+		std::vector<size_t>	mCharOffsets;	// byte offset of each character from the line start, plus one for the line end
+		std::vector<float>	mAdvances;		// prefix sums of the glyph advances, parallel to mCharOffsets
+		bool				mValid = false;
+	};
+
+	size_t	getGapSize() const	{ return mGapEnd - mGapBegin; }
+	void	moveGap( size_t pos );
+	void	reserveGap( size_t length );
+
+	const LineMetrics&	getLineMetrics( size_t line ) const;
+
+	std::vector<char>	mBuffer;
+	size_t				mGapBegin = 0;
+	size_t				mGapEnd = 0;
+
+	mutable std::string	mString;
+	mutable bool		mStringDirty = false;
+
+	std::vector<size_t>					mLineStarts;
+	mutable std::vector<LineMetrics>	mLineMetrics;	// parallel to mLineStarts
+	TextRef								mText;
+	mutable size_t						mNumLinesMeasured = 0;
+};
+
+} // namespace vu
@@ -25,6 +25,8 @@
 #include "vu/Debug.h"
 
 #include "cinder/Cinder.h"
+#include "cinder/Text.h"
+#include "cinder/Unicode.h"
 #include "cinder/gl/TextureFont.h"
 #include "cinder/CinderAssert.h"
 #include "cinder/Log.h"
@@ -194,4 +196,135 @@ void Text::drawStringWrapped( const std::string &str, const ci::Rectf &fitRect )
 	mTextureFont->drawStringWrapped( str, fitRect );
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Text - CPU-side metrics
+// ----------------------------------------------------------------------------------------------------
+// The gl::TextureFont and ci::Font measuring methods go through platform text APIs that aren't safe to
+// use off of the main thread, so we cache per-glyph advances here once and measure with those instead.
+
+void Text::buildMetrics()
+{
+	if( mHasMetrics || ! mIsReady )
+		return;
+
+	const Font &font = mTextureFont->getFont();
+
+	// Always include a space so that word wrapping has something to measure.
+	u32string codePoints = toUtf32( TextManager::instance()->getSupportedChars() );
+	codePoints.push_back( U' ' );
+
+	for( char32_t c : codePoints ) {
+		if( mGlyphMetrics.count( c ) )
+			continue;
+
+		// The advance is the offset of the second glyph when two of the same are placed next to each other.
+		string pair = toUtf8( u32string( 2, c ) );
+		auto placements = TextBox().font( font ).text( pair ).size( TextBox::GROW, TextBox::GROW ).measureGlyphs();
+
+		GlyphMetrics metrics;
+		metrics.mAdvance = placements.size() == 2 ? placements[1].second.x - placements[0].second.x : 0;
+		metrics.mExtent = c == U' ' ? 0 : mTextureFont->measureString( toUtf8( u32string( 1, c ) ) ).x;
+		mGlyphMetrics[c] = metrics;
+	}
+
+	// Unknown glyphs are drawn as nothing by gl::TextureFont, but reserve some space for them anyway.
+	mFallbackGlyphMetrics = mGlyphMetrics[U' '];
+
+	mLineHeight = font.getAscent() + font.getDescent();
+	mLeading = font.getLeading();
+	mHasMetrics = true;
+
+	UI_LOG_TEXT( "built metrics for " << mGlyphMetrics.size() << " glyphs, line height: " << mLineHeight );
+}
+
+const Text::GlyphMetrics& Text::getGlyphMetrics( uint32_t codePoint ) const
+{
+	auto it = mGlyphMetrics.find( codePoint );
+	if( it == mGlyphMetrics.end() )
+		return mFallbackGlyphMetrics;
+
+	return it->second;
+}
+
+float Text::measureLineWidth( const u32string &str, size_t begin, size_t end ) const
+{
+	// trailing spaces don't contribute to the measured width
+	while( end > begin && str[end - 1] == U' ' )
+		end--;
+
+	if( end == begin )
+		return 0;
+
+	float result = 0;
+	for( size_t i = begin; i < end - 1; i++ )
+		result += getGlyphMetrics( str[i] ).mAdvance;
+
+	const auto &last = getGlyphMetrics( str[end - 1] );
+	return result + std::max( last.mExtent, last.mAdvance );
+}
+
+vec2 Text::measureStringWithMetrics( const std::string &str ) const
+{
+	if( ! mHasMetrics || str.empty() )
+		return vec2( 0 );
+
+	u32string codePoints = toUtf32( str );
+	return vec2( measureLineWidth( codePoints, 0, codePoints.size() ), mLineHeight );
+}
+
+vec2 Text::measureStringWrappedWithMetrics( const std::string &str, const ci::Rectf &fitRect ) const
+{
+	if( ! mHasMetrics || str.empty() )
+		return vec2( 0 );
+
+	const u32string codePoints = toUtf32( str );
+	const size_t numCodePoints = codePoints.size();
+	const float maxWidth = fitRect.getWidth();
+
+	float resultWidth = 0;
+	size_t numLines = 0;
+
+	auto addLine = [&]( size_t begin, size_t end ) {
+		resultWidth = std::max( resultWidth, measureLineWidth( codePoints, begin, end ) );
+		numLines++;
+	};
+
+	// Greedy word wrap: a word moves to the next line if it doesn't fit and the current line isn't empty.
+	size_t lineBegin = 0;
+	while( lineBegin <= numCodePoints ) {
+		size_t paragraphEnd = codePoints.find( U'\n', lineBegin );
+		if( paragraphEnd == u32string::npos )
+			paragraphEnd = numCodePoints;
+
+		size_t lineEnd = lineBegin;
+		size_t pos = lineBegin;
+		while( pos < paragraphEnd ) {
+			// find the end of the next word, including leading spaces
+			size_t wordEnd = pos;
+			while( wordEnd < paragraphEnd && codePoints[wordEnd] == U' ' )
+				wordEnd++;
+			while( wordEnd < paragraphEnd && codePoints[wordEnd] != U' ' )
+				wordEnd++;
+
+			if( lineEnd > lineBegin && measureLineWidth( codePoints, lineBegin, wordEnd ) > maxWidth ) {
+				addLine( lineBegin, lineEnd );
+
+				// skip the spaces that caused the break
+				lineBegin = lineEnd;
+				while( lineBegin < paragraphEnd && codePoints[lineBegin] == U' ' )
+					lineBegin++;
+			}
+
+			lineEnd = wordEnd;
+			pos = wordEnd;
+		}
+
+		addLine( lineBegin, paragraphEnd );
+		lineBegin = paragraphEnd + 1;
+	}
+
+	float height = numLines * mLineHeight + ( numLines - 1 ) * mLeading;
+	return vec2( resultWidth, height );
+}
+
 } // namespace vu
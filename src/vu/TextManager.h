@@ -30,6 +30,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace cinder {
@@ -75,16 +76,43 @@ public:
 	void		drawString( const std::string &str, const ci::vec2 &baseline );
 	void		drawStringWrapped( const std::string &str, const ci::Rectf &fitRect );
 
+	//! Builds the CPU-side glyph metrics used by the measure*WithMetrics() methods. Must be called on the main thread.
+	void		buildMetrics();
+	//! Returns true if buildMetrics() has completed.
+	bool		hasMetrics() const	{ return mHasMetrics; }
+	//! Returns the distance to the next glyph's origin for \a codePoint, from the cached glyph metrics. Returns 0 if buildMetrics() hasn't completed.
+	float		getAdvance( uint32_t codePoint ) const	{ return mHasMetrics ? getGlyphMetrics( codePoint ).mAdvance : 0; }
+	//! Returns the height of a line of text, from the cached glyph metrics.
+	float		getLineHeight() const	{ return mLineHeight; }
+	//! Measures \a str using the cached glyph metrics, which can be done on any thread. Kerning is not taken into account.
+	ci::vec2	measureStringWithMetrics( const std::string &str ) const;
+	//! Measures \a str wrapped to the width of \a fitRect using the cached glyph metrics, which can be done on any thread.
+	ci::vec2	measureStringWrappedWithMetrics( const std::string &str, const ci::Rectf &fitRect ) const;
+
 private:
 	Text();
 	Text( const ci::Font &font, float fontSize );
 
+	struct GlyphMetrics {
+		float	mAdvance;	// distance to the next glyph's origin
+		float	mExtent;	// distance from the origin to the right edge of the glyph's texture
+	};
+
+	const GlyphMetrics&	getGlyphMetrics( uint32_t codePoint ) const;
+	float				measureLineWidth( const std::u32string &str, size_t begin, size_t end ) const;
+
 	ci::gl::TextureFontRef	mTextureFont;
 	std::string				mSystemName;
 	ci::fs::path			mFilePath;
 	float					mFontSize; //! note: this might be different to the ci::Font size, due to content scaling
 	std::atomic<bool>		mIsReady;
 
+	std::unordered_map<uint32_t, GlyphMetrics>	mGlyphMetrics;
+	GlyphMetrics								mFallbackGlyphMetrics = { 0, 0 };
+	float										mLineHeight = 0;
+	float										mLeading = 0;
+	std::atomic<bool>							mHasMetrics = { false };
+
 	friend class TextManager;
 };
 
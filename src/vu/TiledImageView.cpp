@@ -0,0 +1,356 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/TiledImageView.h"
+#include "vu/Graph.h"
+
+#include "cinder/ImageIo.h"
+#include "cinder/Log.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+using namespace ci;
+using namespace std;
+
+namespace vu {
+
+// ----------------------------------------------------------------------------------------------------
+// TiledImageSource
+// ----------------------------------------------------------------------------------------------------
+
+TiledImageSource::TiledImageSource( const ivec2 &size, const ivec2 &tileSize )
+	: mSize( size ), mTileSize( tileSize ), mNumLevels( 1 )
+{
+	CI_ASSERT( mTileSize.x > 0 && mTileSize.y > 0 );
+
+	while( true ) {
+		ivec2 levelSize = getLevelSize( mNumLevels - 1 );
+		if( levelSize.x <= mTileSize.x && levelSize.y <= mTileSize.y )
+			break;
+
+		mNumLevels++;
+	}
+}
+
+ivec2 TiledImageSource::getLevelSize( int level ) const
+{
+	const int div = 1 << level;
+	return glm::max( ivec2( 1 ), ( mSize + ivec2( div - 1 ) ) / div );
+}
+
+ivec2 TiledImageSource::getNumTiles( int level ) const
+{
+	return ( getLevelSize( level ) + mTileSize - ivec2( 1 ) ) / mTileSize;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// TiledImageSourceDirectory
+// ----------------------------------------------------------------------------------------------------
+
+TiledImageSourceDirectory::TiledImageSourceDirectory( const fs::path &directory, const ivec2 &size, const ivec2 &tileSize, const string &extension )
+	: TiledImageSource( size, tileSize ), mDirectory( directory ), mExtension( extension )
+{
+}
+
+Surface8u TiledImageSourceDirectory::loadTile( int level, const ivec2 &tile )
+{
+	auto filePath = mDirectory / to_string( level ) / ( to_string( tile.x ) + "_" + to_string( tile.y ) + "." + mExtension );
+	return Surface8u( loadImage( loadFile( filePath ) ) );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// TiledImageView
+// ----------------------------------------------------------------------------------------------------
+
+TiledImageView::TiledImageView( const Rectf &bounds )
+	: View( bounds )
+{
+	setInteractive( false );
+}
+
+TiledImageView::~TiledImageView()
+{
+	cancelLoads();
+}
+
+void TiledImageView::setSource( const TiledImageSourceRef &source )
+{
+	cancelLoads();
+	mTiles.clear();
+	mSource = source;
+}
+
+bool TiledImageView::canBatchDraw() const
+{
+	// subclasses may draw with gl directly, so they need to opt in themselves
+	return typeid( *this ) == typeid( TiledImageView );
+}
+
+void TiledImageView::didLeaveHierarchy()
+{
+	cancelLoads();
+}
+
+void TiledImageView::cancelLoads()
+{
+	for( auto it = mTiles.begin(); it != mTiles.end(); /* */ ) {
+		if( it->second.mRequest ) {
+			it->second.mRequest->cancel();
+			it = mTiles.erase( it );
+		}
+		else
+			++it;
+	}
+
+	mNumTilesLoading = 0;
+}
+
+// static
+uint64_t TiledImageView::makeKey( int level, const ivec2 &tile )
+{
+	return ( uint64_t( level ) << 48 ) | ( uint64_t( tile.y ) << 24 ) | uint64_t( tile.x );
+}
+
+int TiledImageView::calcLevel() const
+{
+	const ivec2 &size = mSource->getSize();
+	float scale = std::min( getWidth() / (float)size.x, getHeight() / (float)size.y );
+	if( scale <= 0 )
+		return mSource->getNumLevels() - 1;
+
+	// Use the smallest level that is at least as large as the size we're drawn at
+	int level = (int)floor( log2( 1.0f / scale ) );
+	return glm::clamp( level, 0, mSource->getNumLevels() - 1 );
+}
+
+Area TiledImageView::calcTileRange( int level, const Rectf &boundsLocal ) const
+{
+	const vec2 levelScale = vec2( mSource->getLevelSize( level ) ) / getSize();
+	const vec2 tileSize = mSource->getTileSize();
+	const ivec2 numTiles = mSource->getNumTiles( level );
+
+	ivec2 begin = glm::clamp( ivec2( glm::floor( boundsLocal.getUpperLeft() * levelScale / tileSize ) ), ivec2( 0 ), numTiles );
+	ivec2 end = glm::clamp( ivec2( glm::ceil( boundsLocal.getLowerRight() * levelScale / tileSize ) ), ivec2( 0 ), numTiles );
+
+	Area result;
+	result.x1 = begin.x;
+	result.y1 = begin.y;
+	result.x2 = end.x;
+	result.y2 = end.y;
+	return result;
+}
+
+Rectf TiledImageView::calcTileBoundsLocal( int level, const ivec2 &tile ) const
+{
+	const ivec2 levelSize = mSource->getLevelSize( level );
+	const vec2 localScale = getSize() / vec2( levelSize );
+
+	ivec2 ul = tile * mSource->getTileSize();
+	ivec2 lr = glm::min( ul + mSource->getTileSize(), levelSize );
+	return Rectf( vec2( ul ) * localScale, vec2( lr ) * localScale );
+}
+
+void TiledImageView::requestTile( int level, const ivec2 &tile )
+{
+	const uint64_t key = makeKey( level, tile );
+	auto it = mTiles.find( key );
+	if( it != mTiles.end() ) {
+		it->second.mLastUsedFrame = mFrame;
+		return;
+	}
+
+	auto source = mSource;
+	Tile &t = mTiles[key];
+	t.mLastUsedFrame = mFrame;
+	t.mRequest = getGraph()->getImageLoader()->load( [source, level, tile] {
+		return source->loadTile( level, tile );
+	} );
+}
+
+void TiledImageView::update()
+{
+	if( ! mSource || getWidth() <= 0 || getHeight() <= 0 )
+		return;
+
+	mFrame++;
+	mCurrentLevel = calcLevel();
+
+	// Always keep the coarsest level loaded, so there is something to draw while finer tiles stream in
+	const int coarsestLevel = mSource->getNumLevels() - 1;
+	const ivec2 numCoarsestTiles = mSource->getNumTiles( coarsestLevel );
+	for( int y = 0; y < numCoarsestTiles.y; y++ ) {
+		for( int x = 0; x < numCoarsestTiles.x; x++ ) {
+			requestTile( coarsestLevel, ivec2( x, y ) );
+		}
+	}
+
+	const Rectf visibleBounds = calcVisibleBoundsLocal();
+	if( visibleBounds.getWidth() > 0 && visibleBounds.getHeight() > 0 ) {
+		// request visible tiles first, so that they are decoded before the prefetch ring
+		const Area visibleRange = calcTileRange( mCurrentLevel, visibleBounds );
+		for( int y = visibleRange.y1; y < visibleRange.y2; y++ ) {
+			for( int x = visibleRange.x1; x < visibleRange.x2; x++ ) {
+				requestTile( mCurrentLevel, ivec2( x, y ) );
+			}
+		}
+
+		const ivec2 numTiles = mSource->getNumTiles( mCurrentLevel );
+		const int ring = std::max( 0, mPrefetchRing );
+		const ivec2 prefetchBegin = glm::max( ivec2( visibleRange.x1, visibleRange.y1 ) - ivec2( ring ), ivec2( 0 ) );
+		const ivec2 prefetchEnd = glm::min( ivec2( visibleRange.x2, visibleRange.y2 ) + ivec2( ring ), numTiles );
+		for( int y = prefetchBegin.y; y < prefetchEnd.y; y++ ) {
+			for( int x = prefetchBegin.x; x < prefetchEnd.x; x++ ) {
+				requestTile( mCurrentLevel, ivec2( x, y ) );
+			}
+		}
+	}
+
+	// Collect finished loads and cancel any that are no longer needed
+	mNumTilesLoading = 0;
+	mNumTilesResident = 0;
+	for( auto it = mTiles.begin(); it != mTiles.end(); /* */ ) {
+		Tile &tile = it->second;
+		if( tile.mRequest ) {
+			auto state = tile.mRequest->getState();
+			if( state == ImageLoadRequest::State::READY ) {
+				tile.mImage = tile.mRequest->getImage();
+				tile.mRequest = nullptr;
+			}
+			else if( state == ImageLoadRequest::State::FAILED ) {
+				tile.mFailed = true;
+				tile.mRequest = nullptr;
+			}
+			else if( tile.mLastUsedFrame != mFrame ) {
+				tile.mRequest->cancel();
+				it = mTiles.erase( it );
+				continue;
+			}
+			else {
+				mNumTilesLoading++;
+			}
+		}
+
+		if( tile.mImage )
+			mNumTilesResident++;
+
+		++it;
+	}
+
+	evictTiles();
+}
+
+void TiledImageView::evictTiles()
+{
+	if( mNumTilesResident <= mTileCacheSize )
+		return;
+
+	mEvictionCandidates.clear();
+	for( const auto &kv : mTiles ) {
+		if( kv.second.mImage && kv.second.mLastUsedFrame != mFrame )
+			mEvictionCandidates.push_back( { kv.second.mLastUsedFrame, kv.first } );
+	}
+
+	// least recently used first
+	sort( mEvictionCandidates.begin(), mEvictionCandidates.end() );
+
+	for( const auto &candidate : mEvictionCandidates ) {
+		if( mNumTilesResident <= mTileCacheSize )
+			break;
+
+		mTiles.erase( candidate.second );
+		mNumTilesResident--;
+	}
+}
+
+bool TiledImageView::findCoarserTile( int level, const ivec2 &tile, uint64_t *key, int *coarserLevel, ivec2 *coarserTile ) const
+{
+	// Levels halve in size, so the covering tile index also halves each level
+	for( int l = level + 1; l < mSource->getNumLevels(); l++ ) {
+		ivec2 t = tile >> ( l - level );
+		uint64_t k = makeKey( l, t );
+		auto it = mTiles.find( k );
+		if( it != mTiles.end() && it->second.mImage ) {
+			*key = k;
+			*coarserLevel = l;
+			*coarserTile = t;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TiledImageView::draw( Renderer *ren )
+{
+	mNumTilesDrawn = 0;
+	if( ! mSource || getWidth() <= 0 || getHeight() <= 0 )
+		return;
+
+	const Rectf visibleBounds = calcVisibleBoundsLocal();
+	if( visibleBounds.getWidth() <= 0 || visibleBounds.getHeight() <= 0 )
+		return;
+
+	ren->setColor( ColorA( 1, 1, 1, getAlphaCombined() ) );
+
+	const Area range = calcTileRange( mCurrentLevel, visibleBounds );
+
+	// First draw coarser tiles in place of any that are still loading, each one only once
+	mFallbackKeys.clear();
+	for( int y = range.y1; y < range.y2; y++ ) {
+		for( int x = range.x1; x < range.x2; x++ ) {
+			const ivec2 tile( x, y );
+			auto it = mTiles.find( makeKey( mCurrentLevel, tile ) );
+			if( it != mTiles.end() && it->second.mImage )
+				continue;
+
+			uint64_t key;
+			int coarserLevel;
+			ivec2 coarserTile;
+			if( ! findCoarserTile( mCurrentLevel, tile, &key, &coarserLevel, &coarserTile ) )
+				continue;
+
+			if( find( mFallbackKeys.begin(), mFallbackKeys.end(), key ) != mFallbackKeys.end() )
+				continue;
+
+			mFallbackKeys.push_back( key );
+			ren->draw( mTiles.at( key ).mImage, calcTileBoundsLocal( coarserLevel, coarserTile ) );
+			mNumTilesDrawn++;
+		}
+	}
+
+	// Then the tiles at the current level on top
+	for( int y = range.y1; y < range.y2; y++ ) {
+		for( int x = range.x1; x < range.x2; x++ ) {
+			const ivec2 tile( x, y );
+			auto it = mTiles.find( makeKey( mCurrentLevel, tile ) );
+			if( it == mTiles.end() || ! it->second.mImage )
+				continue;
+
+			ren->draw( it->second.mImage, calcTileBoundsLocal( mCurrentLevel, tile ) );
+			mNumTilesDrawn++;
+		}
+	}
+}
+
+} // namespace vu
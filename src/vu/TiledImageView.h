@@ -0,0 +1,144 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/View.h"
+#include "vu/ImageLoader.h"
+
+#include "cinder/Filesystem.h"
+#include "cinder/Surface.h"
+
+#include <unordered_map>
+
+namespace vu {
+
+typedef std::shared_ptr<class TiledImageSource>				TiledImageSourceRef;
+typedef std::shared_ptr<class TiledImageSourceDirectory>	TiledImageSourceDirectoryRef;
+typedef std::shared_ptr<class TiledImageView>				TiledImageViewRef;
+
+//! Provides tiles of a very large image at multiple resolution levels. Level 0 is full resolution, and each following level is half the size of the previous one (rounded up).
+//! Subclass and implement loadTile() for custom formats.
+class CI_UI_API TiledImageSource {
+  public:
+	TiledImageSource( const ci::ivec2 &size, const ci::ivec2 &tileSize );
+	virtual ~TiledImageSource()	{}
+
+	//! Returns the size of the full resolution image.
+	const ci::ivec2&	getSize() const			{ return mSize; }
+	//! Returns the size of each tile. Tiles at the right and bottom edges of a level may be smaller.
+	const ci::ivec2&	getTileSize() const		{ return mTileSize; }
+	//! Returns the number of levels, down to the first level that fits in a single tile.
+	int					getNumLevels() const	{ return mNumLevels; }
+	//! Returns the image size at \a level.
+	ci::ivec2			getLevelSize( int level ) const;
+	//! Returns the number of tiles in each dimension at \a level.
+	ci::ivec2			getNumTiles( int level ) const;
+
+	//! Loads the tile at \a tile index of \a level. Called from worker threads, so implementations must be thread-safe.
+	virtual ci::Surface8u	loadTile( int level, const ci::ivec2 &tile ) = 0;
+
+  private:
+	ci::ivec2	mSize;
+	ci::ivec2	mTileSize;
+	int			mNumLevels;
+};
+
+//! Loads tiles from a directory pyramid laid out as `{directory}/{level}/{x}_{y}.{extension}`.
+class CI_UI_API TiledImageSourceDirectory : public TiledImageSource {
+  public:
+	TiledImageSourceDirectory( const ci::fs::path &directory, const ci::ivec2 &size, const ci::ivec2 &tileSize, const std::string &extension = "png" );
+
+	ci::Surface8u	loadTile( int level, const ci::ivec2 &tile ) override;
+
+  private:
+	ci::fs::path	mDirectory;
+	std::string		mExtension;
+};
+
+//! Draws a TiledImageSource scaled to this View's bounds, streaming in tiles at the level of detail that matches the size it is drawn at.
+//! Only tiles within the visible bounds (ex. inside a ScrollView) plus a prefetch ring around them are loaded. While a tile loads, the nearest coarser tile that is loaded is drawn in its place.
+class CI_UI_API TiledImageView : public View {
+  public:
+	TiledImageView( const ci::Rectf &bounds = ci::Rectf::zero() );
+	~TiledImageView();
+
+	void						setSource( const TiledImageSourceRef &source );
+	const TiledImageSourceRef&	getSource() const	{ return mSource; }
+
+	//! Sets the maximum number of tile textures kept resident. Tiles needed for the current frame are never evicted. Default is 256.
+	void	setTileCacheSize( size_t numTiles )		{ mTileCacheSize = numTiles; }
+	size_t	getTileCacheSize() const				{ return mTileCacheSize; }
+	//! Sets the number of tiles around the visible region that are loaded ahead of time. Default is 1.
+	void	setPrefetchRing( int numTiles )			{ mPrefetchRing = numTiles; }
+	int		getPrefetchRing() const					{ return mPrefetchRing; }
+
+	//! Returns the level currently being drawn.
+	int		getCurrentLevel() const			{ return mCurrentLevel; }
+	//! Returns the number of tiles currently loading.
+	size_t	getNumTilesLoading() const		{ return mNumTilesLoading; }
+	//! Returns the number of tiles with loaded textures.
+	size_t	getNumTilesResident() const		{ return mNumTilesResident; }
+	//! Returns the number of tiles drawn last frame, including coarser tiles drawn in place of ones still loading.
+	size_t	getNumTilesDrawn() const		{ return mNumTilesDrawn; }
+
+  protected:
+	void update() override;
+	void draw( Renderer *ren ) override;
+	//! Returns true for TiledImageView itself, subclasses that override draw() are flushed as usual unless they also override this.
+	bool canBatchDraw() const override;
+	void didLeaveHierarchy() override;
+
+  private:
+	struct Tile {
+		ImageRef			mImage;
+		ImageLoadRequestRef	mRequest;
+		uint64_t			mLastUsedFrame = 0;
+		bool				mFailed = false; // failed tiles are kept so that they aren't requested again
+	};
+
+	static uint64_t	makeKey( int level, const ci::ivec2 &tile );
+	int				calcLevel() const;
+	//! Returns the range of tile indices at \a level that overlap \a boundsLocal, as [begin, end).
+	ci::Area		calcTileRange( int level, const ci::Rectf &boundsLocal ) const;
+	ci::Rectf		calcTileBoundsLocal( int level, const ci::ivec2 &tile ) const;
+	void			requestTile( int level, const ci::ivec2 &tile );
+	//! Returns the key of the nearest loaded tile at a coarser level than \a level that covers \a tile, or false if there is none.
+	bool			findCoarserTile( int level, const ci::ivec2 &tile, uint64_t *key, int *coarserLevel, ci::ivec2 *coarserTile ) const;
+	void			cancelLoads();
+	void			evictTiles();
+
+	TiledImageSourceRef				mSource;
+	std::unordered_map<uint64_t, Tile>	mTiles;
+	size_t							mTileCacheSize = 256;
+	int								mPrefetchRing = 1;
+	int								mCurrentLevel = 0;
+	uint64_t						mFrame = 0;
+	size_t							mNumTilesLoading = 0;
+	size_t							mNumTilesResident = 0;
+	size_t							mNumTilesDrawn = 0;
+	std::vector<std::pair<uint64_t, uint64_t>>	mEvictionCandidates; // last used frame, key
+	std::vector<uint64_t>			mFallbackKeys;
+};
+
+} // namespace vu
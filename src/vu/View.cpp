@@ -22,7 +22,9 @@
 */
 
 #include "vu/View.h"
+#include "vu/GestureRecognizer.h"
 #include "vu/Graph.h"
+#include "vu/InteractionRegion.h"
 
 #include "glm/gtc/epsilon.hpp"
 
@@ -38,6 +40,33 @@ namespace vu {
 
 const float BOUNDS_EPSILON = 0.00001f;
 
+namespace {
+
+mat3 makeTranslation( const vec2 &translation )
+{
+	mat3 result( 1.0f );
+	result[2] = vec3( translation, 1 );
+	return result;
+}
+
+vec2 transformPoint( const mat3 &m, const vec2 &p )
+{
+	return vec2( m * vec3( p, 1 ) );
+}
+
+// Returns the bounding box of rect's corners after being transformed by m.
+Rectf transformRect( const mat3 &m, const Rectf &rect )
+{
+	const vec2 p = transformPoint( m, rect.getUpperLeft() );
+	Rectf result( p, p );
+	result.include( transformPoint( m, rect.getUpperRight() ) );
+	result.include( transformPoint( m, rect.getLowerRight() ) );
+	result.include( transformPoint( m, rect.getLowerLeft() ) );
+	return result;
+}
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------------------------------
 // Responder
 // ----------------------------------------------------------------------------------------------------
@@ -53,13 +82,13 @@ bool View::resignFirstResponder()
 	if( ! isFirstResponder() )
 		return false;
 
-	getGraph()->resignFirstResponder();
+	getGraph()->findInteractionRegion( this )->resignFirstResponder();
 	return true; // TODO: same as above return
 }
 
 bool View::isFirstResponder() const
 { 
-	return this == getGraph()->getFirstResponder().get();
+	return this == getGraph()->findInteractionRegion( this )->getFirstResponder().get();
 }
 
 ViewRef	View::getNextResponder() const
@@ -83,13 +112,31 @@ View::View( const ci::Rectf &bounds )
 
 View::~View()
 {
-	for( auto &subview : mSubviews )
+	for( auto &subview : mSubviews ) {
 		subview->mParent = nullptr;
+		subview->setWorldPosDirty();
+	}
+
+	if( mLayoutQueued && mGraph )
+		mGraph->dequeueLayout( this );
+
+	if( mLayout )
+		mLayout->mViews.erase( find( mLayout->mViews.begin(), mLayout->mViews.end(), this ) );
+
+	if( mInteractionRegion && mInteractionRegion->mRootView == this )
+		mInteractionRegion->mRootView = nullptr;
 
 	if( mLayer ) {
 		if( isLayerRoot() )
 			getGraph()->removeLayer( mLayer );
 	}
+
+	if( mRasterFrameBuffer )
+		mRasterFrameBuffer->setInUse( false );
+
+	// the Graph may still hold active recognizers, it cancels those that no longer have a View
+	for( auto &recognizer : mGestureRecognizers )
+		recognizer->mView = nullptr;
 }
 
 void View::setPos( const vec2 &position )
@@ -110,10 +157,73 @@ void View::setSize( const vec2 &size )
 		return;
 
 	mSize = glm::max( vec2( 0 ), size );
+	mSizeLastUpdate = mSize; // updateImpl() only needs to handle animated sizes
 	if( mBackground )
 		mBackground->setSize( mSize );
 
 	setNeedsLayout();
+
+	// ex. a wrapping FlexLayout breaks its lines at our size, so its content size is no longer valid
+	if( mLayout && mLayout->isContentSizeDependentOnSize() )
+		mIntrinsicSizeValid = false;
+
+	// Sizes set by the parent's own layout don't affect it, this also keeps them from feeding back into its cached intrinsic size.
+	if( mParent && ! mParent->mIsLayingOut )
+		invalidateParentLayout();
+}
+
+void View::setScale( const vec2 &scale )
+{
+	if( glm::all( glm::epsilonEqual( mScale, scale, BOUNDS_EPSILON ) ) )
+		return;
+
+	mScale = scale;
+	setTransformDirty();
+}
+
+void View::setRotation( float radians )
+{
+	if( mRotation == radians )
+		return;
+
+	mRotation = radians;
+	setTransformDirty();
+}
+
+void View::setTransformOrigin( const vec2 &origin )
+{
+	if( glm::all( glm::epsilonEqual( mTransformOrigin, origin, BOUNDS_EPSILON ) ) )
+		return;
+
+	mTransformOrigin = origin;
+	setTransformDirty();
+}
+
+void View::setTransformDirty()
+{
+	mHasTransform = mRotation != 0 || mScale != vec2( 1 );
+
+	setWorldPosDirty();
+	setNeedsDisplay();
+
+	// transforming within a rasterized ancestor changes its contents
+	if( mParent )
+		mParent->setNeedsDisplay();
+}
+
+mat3 View::calcLocalTransform() const
+{
+	if( ! mHasTransform )
+		return makeTranslation( getPos() );
+
+	// translate( pos + origin ) * rotate * scale * translate( -origin ), matching the order that Layer applies them when drawing
+	const float c = cos( mRotation );
+	const float s = sin( mRotation );
+	const vec2 col0 = vec2( c, s ) * mScale.x;
+	const vec2 col1 = vec2( -s, c ) * mScale.y;
+	const vec2 translation = getPos() + mTransformOrigin - col0 * mTransformOrigin.x - col1 * mTransformOrigin.y;
+
+	return mat3( vec3( col0, 0 ), vec3( col1, 0 ), vec3( translation, 1 ) );
 }
 
 void View::setBounds( const ci::Rectf &bounds )
@@ -163,6 +273,7 @@ bool View::isLayerRoot() const
 void View::setClipEnabled( bool enable )
 {
 	mClipEnabled = enable;
+	setNeedsDisplay();
 }
 
 bool View::isClipEnabled() const
@@ -179,8 +290,9 @@ void View::addSubview( const ViewRef &view )
 	view->setParent( this );
 	mSubviews.push_back( view );
 
-	setNeedsLayout();
+	invalidateIntrinsicSize();
 	view->setNeedsLayout();
+	setNeedsDisplay();
 }
 
 void View::addSubviews( const vector<ViewRef> &views )
@@ -202,6 +314,10 @@ void View::insertSubview( const ViewRef &view, size_t index )
 	auto it = mSubviews.begin();
 	std::advance( it, index );
 	mSubviews.insert( it, view );
+
+	invalidateIntrinsicSize();
+	view->setNeedsLayout();
+	setNeedsDisplay();
 }
 
 void View::insertSubviewAbove( const ViewRef &view, const ViewRef &viewBelow )
@@ -219,6 +335,10 @@ void View::insertSubviewAbove( const ViewRef &view, const ViewRef &viewBelow )
 
 	view->setParent( this );
 	mSubviews.insert( it, view );
+
+	invalidateIntrinsicSize();
+	view->setNeedsLayout();
+	setNeedsDisplay();
 }
 
 void View::insertSubviewBelow( const ViewRef &view, const ViewRef &viewAbove )
@@ -233,21 +353,30 @@ void View::insertSubviewBelow( const ViewRef &view, const ViewRef &viewAbove )
 
 	view->setParent( this );
 	mSubviews.insert( it, view );
+
+	invalidateIntrinsicSize();
+	view->setNeedsLayout();
+	setNeedsDisplay();
 }
 
 void View::removeSubview( const ViewRef &view )
 {
 	for( auto it = mSubviews.begin(); it != mSubviews.end(); ++it ) {
 		if( view == *it ) {
-			view->mParent = nullptr;
-			if( view->mAcceptsFirstResponder )
-				view->resignFirstResponder();
+			ViewRef removed = view; // view may refer to the element being erased
+			removed->mParent = nullptr;
+			removed->setWorldPosDirty();
+			if( removed->mAcceptsFirstResponder )
+				removed->resignFirstResponder();
 
 			if( mIsIteratingSubviews )
-				view->mMarkedForRemoval = true;
+				removed->mMarkedForRemoval = true;
 			else
 				mSubviews.erase( it );
 
+			invalidateIntrinsicSize();
+			setNeedsDisplay();
+			removed->propagateDidLeaveHierarchy();
 			return;
 		}
 	}
@@ -258,19 +387,36 @@ void View::removeAllSubviews()
 	if( mIsIteratingSubviews ) {
 		for( auto &view : mSubviews ) {
 			view->mParent = nullptr;
+			view->setWorldPosDirty();
 			if( view->mAcceptsFirstResponder )
 				view->resignFirstResponder();
 
 			view->mMarkedForRemoval = true;
+			view->propagateDidLeaveHierarchy();
 		}
 	}
 	else {
-		for( auto &view : mSubviews ) {
+		auto subviews = move( mSubviews );
+		mSubviews.clear();
+		for( auto &view : subviews ) {
 			view->mParent = nullptr;
+			view->setWorldPosDirty();
 			if( view->mAcceptsFirstResponder )
 				view->resignFirstResponder();
+
+			view->propagateDidLeaveHierarchy();
 		}
-		mSubviews.clear();
+	}
+
+	invalidateIntrinsicSize();
+	setNeedsDisplay();
+}
+
+void View::propagateDidLeaveHierarchy()
+{
+	didLeaveHierarchy();
+	for( auto &view : mSubviews ) {
+		view->propagateDidLeaveHierarchy();
 	}
 }
 
@@ -311,6 +457,15 @@ void View::setParent( View *parent )
 	removeFromParent();
 	mParent = parent;
 	mGraph = parent->getGraph();
+	setWorldPosDirty();
+
+	// the added subtree might contain Labels that were marked dirty before they had a Graph
+	if( mGraph ) {
+		if( mGraph->isParallelTextLayoutEnabled() )
+			mGraph->collectDirtyLabels( this );
+		if( mNeedsLayout && ! mLayoutQueued )
+			mGraph->enqueueLayout( this );
+	}
 }
 
 void View::setFillParentEnabled( bool enable )
@@ -325,6 +480,11 @@ void View::setFillParentEnabled( bool enable )
 void View::setNeedsLayout()
 {
 	mNeedsLayout = true;
+	setNeedsDisplay();
+
+	// Size changes made from within our own layoutImpl() are handled there, so only queue when called from outside of it.
+	if( mGraph && ! mLayoutQueued && ! mIsLayingOut )
+		mGraph->enqueueLayout( this );
 
 	for( const auto &subview : mSubviews ) {
 		if( subview->mFillParent )
@@ -332,6 +492,22 @@ void View::setNeedsLayout()
 	}
 }
 
+void View::invalidateParentLayout()
+{
+	// A parent's Layout arranges subviews based on their sizes, so it depends on this View's size and content as well.
+	if( ! mParent || ! mParent->mLayout )
+		return;
+
+	// the parent is outside of the subtree being processed on this thread, so wait until the parallel phase is complete
+	if( isParallelBoundary() ) {
+		auto parent = mParent->shared_from_this();
+		mGraph->defer( [parent] { parent->invalidateIntrinsicSize(); } );
+	}
+	else {
+		mParent->invalidateIntrinsicSize();
+	}
+}
+
 void View::layoutIfNeeded()
 {
 	if( mNeedsLayout )
@@ -343,11 +519,37 @@ void View::layoutIfNeeded()
 
 void View::setWorldPosDirty()
 {
-	mWorldPosDirty = true;
+	// subviews of a dirty View are always dirty too, so there is nothing left to mark beneath it
+	if( mWorldTransformDirty )
+		return;
+
+	// During parallel touch dispatch, a region root's transform is where its region's thread meets the thread of the region around it,
+	// so it is frozen until dispatch is complete. Views within a region are invalidated and recalculated on that region's own thread.
+	if( mInteractionRegion && mGraph && mGraph->mDispatchingInParallel ) {
+		auto view = shared_from_this();
+		mGraph->defer( [view] { view->setWorldPosDirty(); } );
+		return;
+	}
+
+	mWorldTransformDirty = true;
+	if( mBackground )
+		mBackground->setWorldPosDirty();
+
 	for( const auto &subview : mSubviews )
 		subview->setWorldPosDirty();
 }
 
+bool View::isParallelBoundary() const
+{
+	if( ! mGraph )
+		return false;
+
+	if( mInteractionRegion && mInteractionRegion == InteractionRegion::getCurrentParallelRegion() )
+		return true;
+
+	return mIndependentUpdate && mGraph->isCurrentParallelUpdateRoot( this );
+}
+
 void View::addFilter( const FilterRef &filter )
 {
 	mFilters.push_back( filter );
@@ -366,9 +568,27 @@ void View::removeAllFilters()
 	mFilters.clear();
 }
 
+void View::addGestureRecognizer( const GestureRecognizerRef &recognizer )
+{
+	CI_ASSERT_MSG( ! recognizer->mView, "GestureRecognizer is already attached to a View" );
+
+	recognizer->mView = this;
+	mGestureRecognizers.push_back( recognizer );
+}
+
+void View::removeGestureRecognizer( const GestureRecognizerRef &recognizer )
+{
+	auto it = find( mGestureRecognizers.begin(), mGestureRecognizers.end(), recognizer );
+	if( it == mGestureRecognizers.end() )
+		return;
+
+	recognizer->mView = nullptr;
+	mGestureRecognizers.erase( it );
+}
+
 void View::layoutImpl()
 {
-	mWorldPosDirty = true;
+	mIsLayingOut = true;
 
 	if( mBackground )
 		mBackground->layoutImpl();
@@ -386,6 +606,21 @@ void View::layoutImpl()
 
 	layout();
 	mNeedsLayout = false;
+	mIsLayingOut = false;
+
+	if( mGraph ) {
+		mLayoutPass = mGraph->mLayoutPass;
+
+		// stats are shared by the whole Graph, so layouts done on worker threads are counted once they're complete
+		if( Graph::currentParallelUpdateTask() || InteractionRegion::getCurrentParallelRegion() ) {
+			Graph *graph = mGraph;
+			mGraph->defer( [graph] { graph->mLayoutStats.mNumLayouts++; } );
+		}
+		else {
+			mGraph->mLayoutStats.mNumLayouts++;
+		}
+	}
+
 	mSignalViewDidLayout.emit();
 }
 
@@ -403,14 +638,34 @@ void View::updateImpl()
 
 		setWorldPosDirty();
 		mPosLastUpdate = getPos();
+
+		// moving within a rasterized ancestor changes its contents
+		if( mParent ) {
+			if( isParallelBoundary() ) {
+				auto parent = mParent->shared_from_this();
+				mGraph->defer( [parent] { parent->setNeedsDisplay(); } );
+			}
+			else {
+				mParent->setNeedsDisplay();
+			}
+		}
 	}
 
-	// if size changed since last update, mae background match and issue layout
+	if( mAlpha() != mAlphaLastUpdate ) {
+		setWorldPosDirty();
+		setNeedsDisplay();
+		mAlphaLastUpdate = mAlpha;
+	}
+
+	// if size was animated since last update, make background match and issue layout
 	if( glm::any( glm::epsilonNotEqual( getSize(), mSizeLastUpdate, BOUNDS_EPSILON ) ) ) {
 		if( hasBackground )
 			mBackground->setSize( getSize() );
 
 		setNeedsLayout();
+		if( mParent && ! mParent->mIsLayingOut )
+			invalidateParentLayout();
+
 		mSizeLastUpdate = getSize();
 	}
 
@@ -435,8 +690,16 @@ void View::updateImpl()
 			getGraph()->removeLayer( mLayer );
 	}
 
-	if( needsLayout() )
-		layoutImpl();
+	// Views are normally laid out in the Graph's layout pass. This handles those that weren't in a Graph at the time,
+	// or had their size animated, while still only laying out once per pass. Re-dirtied views wait for the next pass.
+	if( needsLayout() && mGraph && mLayoutPass != mGraph->mLayoutPass ) {
+		// layout() may use APIs that are only safe on the main thread (ex. measuring text), so on a worker it waits until the subtree is updated
+		auto task = Graph::currentParallelUpdateTask();
+		if( task )
+			task->mDeferredUpdateLayouts.push_back( shared_from_this() );
+		else
+			layoutImpl();
+	}
 
 	if( hasBackground ) {
 		mBackground->mGraph = mGraph;
@@ -503,47 +766,180 @@ bool View::isPointInside( const vec2 &localPos ) const
 
 vec2 View::toWorld( const vec2 &localPos ) const
 {
-	return localPos + getWorldPos();
+	validateWorldTransform();
+	if( mWorldTransformed )
+		return transformPoint( mWorldTransform, localPos );
+
+	return localPos + mWorldPos;
 }
 
 Rectf View::toWorld( const Rectf &localRect ) const
 {
-	return localRect + getWorldPos();
+	validateWorldTransform();
+	if( mWorldTransformed )
+		return transformRect( mWorldTransform, localRect );
+
+	return localRect + mWorldPos;
 }
 
 vec2 View::toLocal( const vec2 &worldPos ) const
 {
-	return worldPos - getWorldPos();
+	validateWorldTransform();
+	if( mWorldTransformed )
+		return transformPoint( mWorldTransformInv, worldPos );
+
+	return worldPos - mWorldPos;
 }
 
 Rectf View::toLocal( const Rectf &worldRect ) const
 {
-	return worldRect - getWorldPos();
+	validateWorldTransform();
+	if( mWorldTransformed )
+		return transformRect( mWorldTransformInv, worldRect );
+
+	return worldRect - mWorldPos;
 }
 
-const vec2& View::getWorldPos() const
+Rectf View::toParent( const Rectf &localRect ) const
 {
-	if( mWorldPosDirty ) {
-		calcWorldPos();
-		mWorldPosDirty = false;
-	}
+	if( ! mHasTransform )
+		return localRect + getPos();
+
+	return transformRect( calcLocalTransform(), localRect );
+}
 
+const vec2& View::getWorldPos() const
+{
+	validateWorldTransform();
 	return mWorldPos;
 }
 
 Rectf View::getWorldBounds() const
 {
-	auto pos = getWorldPos();
-	return Rectf( pos.x, pos.y, pos.x + getWidth(), pos.y + getHeight() );
+	return toWorld( getBoundsLocal() );
+}
+
+mat3 View::getWorldTransform() const
+{
+	validateWorldTransform();
+	if( mWorldTransformed )
+		return mWorldTransform;
+
+	return makeTranslation( mWorldPos );
+}
+
+bool View::isWorldTransformed() const
+{
+	validateWorldTransform();
+	return mWorldTransformed;
+}
+
+Rectf View::calcVisibleBoundsLocal() const
+{
+	// Start with the Graph's bounds and intersect with all ancestors that clip, in world space
+	Rectf result = getWorldBounds();
+	if( mGraph ) {
+		auto clippingSize = mGraph->getClippingSize();
+		result = result.getClipBy( Rectf( 0, 0, (float)clippingSize.x, (float)clippingSize.y ) );
+	}
+
+	for( const View *parent = getParent(); parent; parent = parent->getParent() ) {
+		if( parent->isClipEnabled() ) {
+			result = result.getClipBy( parent->getClipWorldBounds() );
+		}
+	}
+
+	return toLocal( result );
+}
+
+void View::calcWorldTransform() const
+{
+	// the parent's transform stays valid after the first call, so a top-down pass only does one step per View
+	if( mParent ) {
+		mParent->validateWorldTransform();
+		mWorldPos = mParent->mWorldPos + getPos();
+		mWorldTransformed = mHasTransform || mParent->mWorldTransformed;
+		mAlphaCombined = mParent->mAlphaCombined * mAlpha;
+	}
+	else {
+		mWorldPos = getPos();
+		mWorldTransformed = mHasTransform;
+		mAlphaCombined = mAlpha;
+	}
+
+	// only subtrees beneath a scaled or rotated View need the full matrix, everything else is a translation by mWorldPos
+	if( mWorldTransformed ) {
+		const mat3 parentTransform = mParent ? mParent->getWorldTransform() : mat3( 1.0f );
+		mWorldTransform = parentTransform * calcLocalTransform();
+		mWorldTransformInv = inverse( mWorldTransform );
+		mWorldPos = vec2( mWorldTransform[2] );
+	}
+
+	mWorldTransformDirty = false;
+}
+
+void View::validateWorldTransform() const
+{
+	if( mWorldTransformDirty )
+		calcWorldTransform();
 }
 
-void View::calcWorldPos() const
+void View::setHidden( bool hidden )
 {
-	mWorldPos = getPos();
+	if( mHidden == hidden )
+		return;
+
+	mHidden = hidden;
+	setNeedsDisplay();
+}
+
+void View::setShouldRasterize( bool enable )
+{
+	if( mShouldRasterize == enable )
+		return;
+
+	mShouldRasterize = enable;
+	mRasterDirty = true;
+	if( ! enable && mRasterFrameBuffer ) {
+		// release the FrameBuffer back to the Renderer
+		mRasterFrameBuffer->setInUse( false );
+		mRasterFrameBuffer.reset();
+	}
+	if( ! enable )
+		mRasterLayer.reset();
 
-	auto parent = getParent();
-	if( parent )
-		mWorldPos += parent->getWorldPos();
+	// rasterized ancestors need to redraw too, setNeedsDisplay() stops at ones that are already dirty
+	setNeedsDisplay();
+}
+
+void View::setRasterizationScale( float scale )
+{
+	CI_ASSERT( scale > 0 );
+
+	mRasterizationScale = scale;
+	mRasterDirty = true;
+	setNeedsDisplay();
+}
+
+void View::setNeedsDisplay()
+{
+	for( View *view = this; view; view = view->mParent ) {
+		if( view->mShouldRasterize ) {
+			// an already dirty ancestor had its own rasterized ancestors marked when it became dirty. This View is always
+			// walked from though, as it may have stayed dirty while hidden or culled, without its ancestors redrawing.
+			if( view->mRasterDirty && view != this )
+				break;
+
+			view->mRasterDirty = true;
+		}
+
+		// same as setNeedsLayout(), ancestors outside of a subtree being processed in parallel are marked afterwards
+		if( view->mParent && view->isParallelBoundary() ) {
+			auto parent = view->mParent->shared_from_this();
+			view->mGraph->defer( [parent] { parent->setNeedsDisplay(); } );
+			break;
+		}
+	}
 }
 
 void View::setBackgroundEnabled( bool enable )
@@ -570,17 +966,58 @@ const RectViewRef& View::getBackground()
 float View::getAlphaCombined() const
 {
 	// TODO: Get this value from Renderer, which knows current alpha based on layer
-	float alpha = mAlpha;
-	if( mParent )
-		alpha *= mParent->getAlphaCombined();
+	validateWorldTransform();
 
-	return alpha;
+	return mAlphaCombined;
 }
 
 void View::setLayout( const LayoutRef &layout )
 {
+	if( mLayout == layout )
+		return;
+
+	if( mLayout )
+		mLayout->mViews.erase( find( mLayout->mViews.begin(), mLayout->mViews.end(), this ) );
+
 	mLayout = layout;
+	if( mLayout )
+		mLayout->mViews.push_back( this );
+
+	invalidateIntrinsicSize();
+}
+
+void View::setFlexItem( const FlexItem &item )
+{
+	mFlexItem = item;
+	if( mParent ) {
+		mParent->invalidateIntrinsicSize();
+	}
+}
+
+vec2 View::getIntrinsicSize()
+{
+	if( ! mIntrinsicSizeValid ) {
+		mIntrinsicSize = calcIntrinsicSize();
+		mIntrinsicSizeValid = true;
+	}
+
+	return mIntrinsicSize;
+}
+
+void View::invalidateIntrinsicSize()
+{
+	mIntrinsicSizeValid = false;
 	setNeedsLayout();
+	invalidateParentLayout();
+}
+
+vec2 View::calcIntrinsicSize()
+{
+	if( mLayout ) {
+		return mLayout->calcContentSize( this );
+	}
+
+	return vec2( -1 );
 }
 
 ViewRef View::getViewWithLabel( const std::string &label ) const
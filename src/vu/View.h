@@ -34,6 +34,7 @@
 #include "cinder/Tween.h"
 #include "cinder/Rect.h"
 #include "cinder/Color.h"
+#include "cinder/Matrix.h"
 #include "cinder/Signals.h"
 
 #include <list>
@@ -45,7 +46,9 @@ typedef std::shared_ptr<class Responder>		ResponderRef;
 typedef std::shared_ptr<class View>				ViewRef;
 typedef std::shared_ptr<class RectView>			RectViewRef;
 typedef std::shared_ptr<class StrokedRectView>	StrokedRectViewRef;
+typedef std::shared_ptr<class GestureRecognizer>	GestureRecognizerRef;
 class Graph;
+class InteractionRegion;
 
 class CI_UI_API View : public std::enable_shared_from_this<View> {
   public:
@@ -68,7 +71,7 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	void			setBounds( const ci::Rectf &bounds );
 	virtual void	setPos( const ci::vec2 &position );
 	virtual void	setSize( const ci::vec2 &size );
-	virtual void	setAlpha( float alpha )							{ mAlpha = alpha; }
+	virtual void	setAlpha( float alpha )							{ mAlpha = alpha; setWorldPosDirty(); setNeedsDisplay(); }
 
 	float					getAlpha()	const		{ return mAlpha; }
 	float					getAlphaCombined() const;
@@ -85,6 +88,22 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	float					getWidth() const		{ return mSize().x; }
 	float					getHeight() const		{ return mSize().y; }
 
+	//! Sets the scale of this View and its subviews, applied around the transform origin. Default is [1, 1].
+	//! \note Transforms don't affect layout, getBounds() and getSize() are still in untransformed units.
+	void					setScale( const ci::vec2 &scale );
+	void					setScale( float scale )			{ setScale( ci::vec2( scale ) ); }
+	const ci::vec2&			getScale() const				{ return mScale; }
+	//! Sets the rotation of this View and its subviews in radians, applied around the transform origin. Positive values rotate clockwise on screen. Default is 0.
+	void					setRotation( float radians );
+	float					getRotation() const				{ return mRotation; }
+	//! Sets the point that scale and rotation are applied around, in local coordinates. Default is [0, 0] (the upper left corner).
+	void					setTransformOrigin( const ci::vec2 &origin );
+	const ci::vec2&			getTransformOrigin() const		{ return mTransformOrigin; }
+	//! Returns true if this View is scaled or rotated.
+	bool					hasTransform() const			{ return mHasTransform; }
+	//! Returns the transform from this View's local coordinates to its parent's coordinates, including position.
+	ci::mat3				calcLocalTransform() const;
+
 	ci::Anim<float>*		animAlpha()			{ return &mAlpha; }
 	ci::Anim<ci::vec2>*		animPos()			{ return &mPos; }
 	ci::Anim<ci::vec2>*		animSize()			{ return &mSize; }
@@ -108,6 +127,15 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	void				setLayout( const LayoutRef &layout );
 	LayoutRef			getLayout() const	{ return mLayout; }
 
+	//! Sets the properties used when this View is laid out by a FlexLayout.
+	void				setFlexItem( const FlexItem &item );
+	const FlexItem&		getFlexItem() const	{ return mFlexItem; }
+
+	//! Returns the size this View needs to fit its content, or a negative size if it has none. The result is cached until invalidateIntrinsicSize() is called.
+	ci::vec2			getIntrinsicSize();
+	//! Marks the intrinsic size as needing to be recalculated, ex. when content changes. Also invalidates the parent if it arranges subviews with a Layout.
+	void				invalidateIntrinsicSize();
+
 	// Responder --------
 	//!
 	bool	isFirstResponder() const;
@@ -137,18 +165,33 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	bool isBackgroundEnabled() const;
 	const RectViewRef& getBackground();
 
+	//! Returns the world position of this View's local origin.
 	const ci::vec2&		getWorldPos() const;
+	//! Returns this View's bounds in world coordinates. If this View or an ancestor is scaled or rotated, this is the bounding box of the transformed bounds.
 	ci::Rectf			getWorldBounds() const;
+	//! Returns the transform from local to world coordinates. It is cached until this View or one of its ancestors is moved, transformed or reparented.
+	ci::mat3			getWorldTransform() const;
+	//! Returns true if this View or any of its ancestors is scaled or rotated.
+	bool				isWorldTransformed() const;
 	ci::vec2			toWorld( const ci::vec2 &localPos ) const;
 	ci::vec2			toLocal( const ci::vec2 &worldPos ) const;
+	//! Converts \a localRect to world coordinates. Under rotation the result is the bounding box of the transformed corners.
 	ci::Rectf			toWorld( const ci::Rectf &localRect ) const;
+	//! Converts \a worldRect to local coordinates. Under rotation the result is the bounding box of the transformed corners.
 	ci::Rectf			toLocal( const ci::Rectf &worldRect ) const;
+	//! Converts \a localRect to the parent's coordinates, taking position, scale and rotation into account.
+	ci::Rectf			toParent( const ci::Rectf &localRect ) const;
+	//! Returns the part of this View's bounds that isn't clipped by the Graph or any clipping ancestors (ex. a ScrollView), in local coordinates.
+	ci::Rectf			calcVisibleBoundsLocal() const;
 
 	virtual const View*	hitTest( const ci::app::TouchEvent &event ) const;
 	virtual bool		isPointInside( const ci::vec2 &localPos ) const;
 
-	void	setHidden( bool hidden = true )			{ mHidden = hidden; }
+	void	setHidden( bool hidden = true );
 	bool	isHidden() const						{ return mHidden; }
+	//! Declares that this View draws opaque pixels over all of its bounds, which allows siblings beneath it that it fully covers to be skipped when drawing. Default is false.
+	void	setOpaque( bool opaque = true )			{ mOpaque = opaque; }
+	bool	isOpaque() const						{ return mOpaque; }
 	void	setInteractive( bool enable = true )	{ mInteractive = enable; }
 	bool	isInteractive() const					{ return mInteractive; }
 	bool	isUserInteracting() const				{ return ! mActiveTouches.empty(); }
@@ -164,7 +207,26 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	void	setClipEnabled( bool enable = true );
 	bool	isClipEnabled() const;
 
-	void	    setBlendMode( BlendMode mode )			{ mBlendMode = mode; }
+	//! Renders this View and its subviews into a FrameBuffer once, then draws that until something in the subtree changes. Useful for complex subtrees that rarely change (ex. legends, static overlays). Default is false.
+	void	setShouldRasterize( bool enable = true );
+	bool	getShouldRasterize() const				{ return mShouldRasterize; }
+	//! Sets the resolution of the rasterized FrameBuffer relative to this View's size, values less than 1 save memory at the cost of sharpness. Default is 1.
+	void	setRasterizationScale( float scale );
+	float	getRasterizationScale() const			{ return mRasterizationScale; }
+	//! Marks the rasterized contents of this View and its ancestors as needing to be redrawn. Called automatically for layout, bounds, alpha, visibility and subview changes. Call it when a View draws differently for other reasons (ex. an animated color).
+	void	setNeedsDisplay();
+
+	//! Marks this View's subtree as independent of the rest of the hierarchy during update(), so that it can be updated on a worker thread alongside its independent siblings when Graph::setParallelUpdateEnabled() is on. Default is false.
+	//! \note update() and layout() of Views within the subtree must only modify Views within it, anything else should go through Graph::defer().
+	//! Views in the subtree that still need layout during update (ex. ones that were just added) are laid out on the main thread once all subtrees are updated.
+	//! \note The built-in Views can be used within independent subtrees. Those that use state shared with other Views defer that part of their update to the main thread:
+	//! ImageView acquires its ImageCache entry and TextArea wraps its text there, and Labels are measured by the deferred layout pass.
+	//! Custom Views are not safe within an independent subtree if their update() or layout() uses gl, measures text or uses the Graph's ImageCache directly, unless they do the same.
+	void	setIndependentUpdateEnabled( bool enable = true )	{ mIndependentUpdate = enable; }
+	//! Returns whether this View's subtree can be updated in parallel with its independent siblings.
+	bool	isIndependentUpdateEnabled() const					{ return mIndependentUpdate; }
+
+	void	    setBlendMode( BlendMode mode )			{ mBlendMode = mode; setNeedsDisplay(); }
 	BlendMode	getBlendMode() const					{ return mBlendMode; }
 
 	void    addFilter( const FilterRef &filter );
@@ -176,7 +238,7 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	void	setFillParentEnabled( bool enable = true );
 	bool	isFillParentEnabled() const					{ return mFillParent; }
 
-	//! Informs layout propagation that this View and its subviews need layout() to be called.
+	//! Informs layout propagation that this View and its fill-parent subviews need layout() to be called. The parent is not marked, use invalidateIntrinsicSize() when a change also affects a parent that arranges its subviews with a Layout (resizing does this automatically).
 	void	setNeedsLayout();
 	//! Returns whether this View needs to have its layout() method called before the next update(). TODO: rename to getNeedsLayout()
 	bool	needsLayout() const	{ return mNeedsLayout; }
@@ -193,13 +255,27 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	//! Returns the touches currently being intercepted
 	const std::vector<ci::app::TouchEvent::Touch>&	getInterceptingTouches() const	{ return mInterceptedTouchEvent.getTouches(); }
 
-	//! This is done when the world position should be recalculated but calling layout isn't necessary (ex. when ScrollView offset moves)
+	//! Attaches \a recognizer to this View. It is run by the Graph with touches that begin within this View or its subviews, before they are dispatched to touchesBegan().
+	void	addGestureRecognizer( const GestureRecognizerRef &recognizer );
+	void	removeGestureRecognizer( const GestureRecognizerRef &recognizer );
+	const std::vector<GestureRecognizerRef>&	getGestureRecognizers() const	{ return mGestureRecognizers; }
+
+	//! Invalidates the cached world transforms and combined alphas of this View and its subviews, which are recalculated on demand. Called automatically when a View's position, transform, alpha or parent changes.
 	void	setWorldPosDirty();
 
   protected:
+	//! Override to calculate the size this View needs to fit its content. \default returns the Layout's content size if there is one, which is negative for Layouts that don't size based on content, otherwise a negative size (no intrinsic size).
+	virtual ci::vec2	calcIntrinsicSize();
+	//! Called bottom-up during the Graph's layout pass, before any layout() calls. Override to update the size that a parent's Layout depends on (ex. text size).
+	virtual void measure()		        {}
 	virtual void layout()		        {}
 	virtual void update()		        {}
 	virtual void draw( Renderer *ren )  {}
+	//! Override and return true if draw() only uses Renderer methods, which allows Renderer to batch Images across Views. \default false, batched draws are flushed before draw() is called.
+	//! The result applies to subclasses as well, so Views that return true should only do so for their own type if subclasses are expected to override draw().
+	virtual bool canBatchDraw() const	{ return false; }
+	//! Called on a View and all of its subviews when it is removed from its parent. Override to release resources that are only needed while attached (ex. pending loads).
+	virtual void didLeaveHierarchy()	{}
 
 	//! Returns the bounds required for rendering this View to a FrameBuffer. \default is this View's local bounds. Override if this View needs a larger sized or FrameBuffer.
 	virtual ci::Rectf   getBoundsForFrameBuffer() const;
@@ -231,7 +307,14 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	View& operator=( const View& )	= delete;
 
 	void setParent( View *parent );
-	void calcWorldPos() const;
+	void propagateDidLeaveHierarchy();
+	//! Called when this View's size or intrinsic size changes, invalidates the parent's intrinsic size and layout if it arranges subviews with a Layout.
+	void invalidateParentLayout();
+	void calcWorldTransform() const;
+	void validateWorldTransform() const;
+	void setTransformDirty();
+	//! Returns true if this View is the root of a subtree that the calling thread is processing in parallel (an InteractionRegion or independently updated subtree), meaning its ancestors may be in use by other threads.
+	bool isParallelBoundary() const;
 	void layoutImpl();
 	void updateImpl();
 	void drawImpl( Renderer *ren );
@@ -244,15 +327,29 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 
 	bool					mInteractive = true;
 	bool					mHidden = false;
+	bool					mOpaque = false;
 	bool					mNeedsLayout = false;
+	bool					mIsLayingOut = false;
+	bool					mLayoutQueued = false;	// true while this View is in its Graph's layout queue
+	uint64_t				mLayoutPass = 0;		// the Graph layout pass that this View was last laid out in
 	
-	mutable bool			mWorldPosDirty = true;
+	mutable bool			mWorldTransformDirty = true;	// set along with all subviews when the world transform or mAlphaCombined needs recalculating
 	mutable ci::vec2		mWorldPos;
+	mutable ci::mat3		mWorldTransform;		// only valid when mWorldTransformed is true, otherwise the transform is a translation by mWorldPos
+	mutable ci::mat3		mWorldTransformInv;
+	mutable bool			mWorldTransformed = false;
+	mutable float			mAlphaCombined = 1;
+
+	ci::vec2				mScale = ci::vec2( 1 );
+	float					mRotation = 0;
+	ci::vec2				mTransformOrigin;
+	bool					mHasTransform = false;
 
 	ci::Anim<float>			mAlpha = 1.0f;
 	ci::Anim<ci::vec2>		mPos;
 	ci::Anim<ci::vec2>		mSize;
 	ci::vec2				mPosLastUpdate, mSizeLastUpdate;
+	float					mAlphaLastUpdate = 1;
 	std::string				mLabel;
 	bool					mFillParent = false; // TODO: replace this with proper layout system
 	BlendMode				mBlendMode = BlendMode::ALPHA;
@@ -261,6 +358,13 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	bool			        mRenderTransparencyToFrameBuffer = true;
 	bool                    mIsIteratingSubviews = false;
 	bool                    mMarkedForRemoval = false;
+	bool					mShouldRasterize = false;
+	bool					mIndependentUpdate = false;
+	bool					mRasterDirty = true;
+	float					mRasterizationScale = 1;
+	float					mRasterAlpha = 1;		// combined alpha the raster was drawn with
+	FrameBufferRef			mRasterFrameBuffer;
+	LayerRef				mRasterLayer;			// draws the subtree into mRasterFrameBuffer
 
 	View*					mParent = nullptr;
 	Graph*                  mGraph = nullptr;
@@ -269,6 +373,12 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	LayerRef				mLayer;
 	std::vector<FilterRef>  mFilters;
 	LayoutRef				mLayout;
+	FlexItem				mFlexItem;
+	ci::vec2				mFlexBaseSize;		// size before this View was flexed, used when the basis is auto
+	ci::vec2				mFlexLayoutSize;	// size this View was last given by a FlexLayout
+	bool					mFlexLaidOut = false;
+	ci::vec2				mIntrinsicSize;
+	bool					mIntrinsicSizeValid = false;
 
 	bool					mAcceptsFirstResponder = false;
 	ViewRef					mNextResponder;
@@ -276,10 +386,14 @@ class CI_UI_API View : public std::enable_shared_from_this<View> {
 	bool					mInterceptsTouches = false;
 	ci::app::TouchEvent		mInterceptedTouchEvent;
 
+	std::vector<GestureRecognizerRef>	mGestureRecognizers;
+	InteractionRegion*					mInteractionRegion = nullptr;	// set if this View is the root of an InteractionRegion
+
 	ci::signals::Signal<void ()>	mSignalViewDidLayout;
 
 	friend class Layer;
 	friend class Graph;
+	friend class FlexLayout;
 };
 
 CI_UI_API std::ostream& operator<<( std::ostream &os, const View &rhs );
@@ -306,7 +420,7 @@ class CI_UI_API RectView : public View {
   public:
 	RectView( const ci::Rectf &bounds = ci::Rectf::zero() );
 
-	void					setColor( const ci::ColorA &color )	{ mColor = color; }
+	void					setColor( const ci::ColorA &color )	{ mColor = color; setNeedsDisplay(); }
 	const ci::ColorA&		getColor() const					{ return mColor; }
 	ci::Anim<ci::ColorA>*	animColor()							{ return &mColor; }
 	//! note: deprecated, use animColor() instead
@@ -326,11 +440,11 @@ class CI_UI_API StrokedRectView : public RectView {
 
 	StrokedRectView( const ci::Rectf &bounds = ci::Rectf::zero() );
 
-	void				setLineWidth( float lineWidth )		{ mLineWidth = lineWidth; }
+	void				setLineWidth( float lineWidth )		{ mLineWidth = lineWidth; setNeedsDisplay(); }
 	float				getLineWidth() const				{ return mLineWidth; }
 	ci::Anim<float>*	getLineWidthAnim()					{ return &mLineWidth; }
 
-	void                setPlacement( Placement placement )	{ mPlacement = placement; };
+	void                setPlacement( Placement placement )	{ mPlacement = placement; setNeedsDisplay(); }
 	Placement           getPlacement() const                { return mPlacement; }
 
   protected:
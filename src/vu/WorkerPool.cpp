@@ -0,0 +1,177 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "vu/WorkerPool.h"
+
+#include "cinder/CinderAssert.h"
+#include "cinder/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+using namespace std;
+
+namespace vu {
+
+namespace {
+
+thread_local bool sIsWorkerThread = false;
+
+} // anonymous namespace
+
+WorkerPool::WorkerPool( size_t numThreads )
+{
+	if( numThreads == 0 ) {
+		size_t hardwareThreads = thread::hardware_concurrency();
+		numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	for( size_t i = 0; i < numThreads; i++ ) {
+		mThreads.emplace_back( &WorkerPool::workerLoop, this );
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mStopping = true;
+	}
+	mCondition.notify_all();
+
+	for( auto &t : mThreads ) {
+		if( t.joinable() )
+			t.join();
+	}
+}
+
+// static
+bool WorkerPool::isWorkerThread()
+{
+	return sIsWorkerThread;
+}
+
+void WorkerPool::enqueue( const function<void ()> &task )
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mTasks.push_back( task );
+	}
+	mCondition.notify_one();
+}
+
+void WorkerPool::workerLoop()
+{
+	sIsWorkerThread = true;
+
+	while( true ) {
+		function<void ()> task;
+		{
+			unique_lock<mutex> lock( mMutex );
+			mCondition.wait( lock, [this] { return mStopping || ! mTasks.empty(); } );
+			if( mStopping && mTasks.empty() )
+				return;
+
+			task = move( mTasks.front() );
+			mTasks.pop_front();
+		}
+
+		try {
+			task();
+		}
+		catch( std::exception &exc ) {
+			CI_LOG_E( "exception caught running task, what: " << exc.what() );
+		}
+	}
+}
+
+void WorkerPool::parallelFor( size_t count, const function<void ( size_t )> &fn, size_t grainSize )
+{
+	if( count == 0 )
+		return;
+
+	grainSize = std::max<size_t>( grainSize, 1 );
+	const size_t numChunks = ( count + grainSize - 1 ) / grainSize;
+
+	// Nested parallelFor() calls would block a worker waiting on tasks queued behind it, so just run serially.
+	if( numChunks == 1 || mThreads.empty() || isWorkerThread() ) {
+		for( size_t i = 0; i < count; i++ )
+			fn( i );
+
+		return;
+	}
+
+	// State shared by the calling thread and helpers. Lives on this stack frame, so we wait for all helpers to finish before returning.
+	struct Shared {
+		atomic<size_t>		nextChunk = { 0 };
+		size_t				numHelpersDone = 0;
+		mutex				doneMutex;
+		condition_variable	doneCondition;
+		exception_ptr		exc;
+	} shared;
+
+	auto runChunks = [&] {
+		while( true ) {
+			size_t chunk = shared.nextChunk.fetch_add( 1 );
+			if( chunk >= numChunks )
+				break;
+
+			size_t begin = chunk * grainSize;
+			size_t end = std::min( begin + grainSize, count );
+			try {
+				for( size_t i = begin; i < end; i++ )
+					fn( i );
+			}
+			catch( ... ) {
+				lock_guard<mutex> lock( shared.doneMutex );
+				if( ! shared.exc )
+					shared.exc = current_exception();
+			}
+		}
+	};
+
+	const size_t numHelpers = std::min( mThreads.size(), numChunks - 1 );
+	for( size_t i = 0; i < numHelpers; i++ ) {
+		enqueue( [&] {
+			runChunks();
+
+			lock_guard<mutex> lock( shared.doneMutex );
+			shared.numHelpersDone++;
+			shared.doneCondition.notify_one();
+		} );
+	}
+
+	// the calling thread works on chunks too, then waits for stragglers
+	runChunks();
+
+	{
+		unique_lock<mutex> lock( shared.doneMutex );
+		shared.doneCondition.wait( lock, [&] { return shared.numHelpersDone == numHelpers; } );
+	}
+
+	if( shared.exc )
+		rethrow_exception( shared.exc );
+}
+
+} // namespace vu
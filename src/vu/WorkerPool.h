@@ -0,0 +1,72 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided
+ that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "vu/Export.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vu {
+
+typedef std::shared_ptr<class WorkerPool>	WorkerPoolRef;
+
+//! Fixed size pool of worker threads, used for processing Graph work (ex. text measurement) off of the main thread.
+class CI_UI_API WorkerPool {
+  public:
+	//! Creates a WorkerPool with \a numThreads threads. If \a numThreads is 0, one less than the number of hardware threads is used (minimum of one).
+	explicit WorkerPool( size_t numThreads = 0 );
+	~WorkerPool();
+
+	//! Returns the number of worker threads (not including the calling thread, which also participates in parallelFor()).
+	size_t	getNumThreads() const	{ return mThreads.size(); }
+
+	//! Queues \a task to be run on one of the worker threads.
+	void	enqueue( const std::function<void ()> &task );
+	//! Calls \a fn for each index in [0, count), split into chunks of \a grainSize across the workers and the calling thread. Blocks until all are complete.
+	//! \note If called from within a worker thread, all work is done serially on that thread.
+	void	parallelFor( size_t count, const std::function<void ( size_t )> &fn, size_t grainSize = 1 );
+
+	//! Returns true if the calling thread is one of this process' WorkerPool threads.
+	static bool isWorkerThread();
+
+  private:
+	WorkerPool( const WorkerPool& )				= delete;
+	WorkerPool& operator=( const WorkerPool& )	= delete;
+
+	void workerLoop();
+
+	std::vector<std::thread>			mThreads;
+	std::deque<std::function<void ()>>	mTasks;
+	std::mutex							mMutex;
+	std::condition_variable				mCondition;
+	bool								mStopping = false;
+};
+
+} // namespace vu
@@ -23,14 +23,25 @@
 
 #include "vu/Control.h"
 #include "vu/Filter.h"
+#include "vu/FrameBufferReader.h"
+#include "vu/GestureRecognizer.h"
 #include "vu/Graph.h"
 #include "vu/Image.h"
+#include "vu/ImageAtlas.h"
+#include "vu/ImageCache.h"
+#include "vu/ImageLoader.h"
 #include "vu/ImageView.h"
+#include "vu/InputRecorder.h"
+#include "vu/InteractionRegion.h"
 #include "vu/Interface3d.h"
 #include "vu/Label.h"
 #include "vu/Layer.h"
 #include "vu/Renderer.h"
 #include "vu/ScrollView.h"
 #include "vu/Suite.h"
+#include "vu/TextArea.h"
+#include "vu/TextBuffer.h"
 #include "vu/TextManager.h"
+#include "vu/TiledImageView.h"
 #include "vu/View.h"
+#include "vu/WorkerPool.h"